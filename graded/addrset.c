@@ -0,0 +1,95 @@
+/******************************************************************************
+ * FILE: addrset.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of dual-stack lookups into fixed-capacity address sets.
+ *
+ ******************************************************************************/
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "addrset.h"
+
+
+void addrset_add(addrset* set, int family, const void* bytes)
+{
+    size_t len = family == AF_INET ? 4 : 16;
+    int i;
+
+    for (i = 0; i < set->count; ++i) {
+        if (set->addrs[i].family == family && !memcmp(set->addrs[i].bytes, bytes, len)) {
+            return;
+        }
+    }
+    if (set->count == ADDRSET_MAX) {
+        return;
+    }
+    set->addrs[set->count].family = family;
+    memcpy(set->addrs[set->count].bytes, bytes, len);
+    memset(set->addrs[set->count].bytes + len, 0, sizeof(set->addrs[0].bytes) - len);
+    set->count++;
+}
+
+
+int addrset_lookup(const char* hostname, addrset* set)
+{
+    struct addrinfo hints;
+    struct addrinfo* head = NULL;
+    struct addrinfo* ai;
+    int rc;
+
+    /* Both families in one call; one socket type so each address comes
+     * back once */
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    set->count = 0;
+    if ((rc = getaddrinfo(hostname, NULL, &hints, &head))) {
+        fprintf(stderr, "Error looking up Address: %s\n", gai_strerror(rc));
+        return ADDRSET_FAILURE;
+    }
+    for (ai = head; ai != NULL; ai = ai->ai_next) {
+        if (ai->ai_family == AF_INET) {
+            addrset_add(set, AF_INET,
+                        &((struct sockaddr_in*) ai->ai_addr)->sin_addr);
+        }
+        else if (ai->ai_family == AF_INET6) {
+            addrset_add(set, AF_INET6,
+                        &((struct sockaddr_in6*) ai->ai_addr)->sin6_addr);
+        }
+    }
+    freeaddrinfo(head);
+
+    return set->count ? ADDRSET_SUCCESS : ADDRSET_FAILURE;
+}
+
+
+int addrset_format(const addrset* set, int all, char* out, size_t size)
+{
+    char text[INET6_ADDRSTRLEN];
+    size_t len = 0;
+    size_t n;
+    int i;
+
+    if (size) {
+        out[0] = '\0';
+    }
+    for (i = 0; i < set->count && (all || i == 0); ++i) {
+        inet_ntop(set->addrs[i].family, set->addrs[i].bytes, text, sizeof(text));
+        n = strlen(text) + (i > 0);
+        if (len + n >= size) {
+            break;
+        }
+        snprintf(out + len, size - len, "%s%s", i > 0 ? "," : "", text);
+        len += n;
+    }
+    return (int) len;
+}
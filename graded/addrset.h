@@ -0,0 +1,57 @@
+/******************************************************************************
+ * FILE: addrset.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for dual-stack lookups.
+ *  One getaddrinfo() call for both families has the resolver send the A and
+ *      AAAA queries together (one round trip instead of two), and asking for
+ *      a single socket type stops each address coming back once per type.
+ *  The unique addresses are kept in a fixed-capacity set, in the order the
+ *      resolver ranked them, with no allocation per address.
+ *
+ ******************************************************************************/
+
+#ifndef ADDRSET_H
+#define ADDRSET_H
+
+/* Standard Includes */
+#include <stddef.h>
+
+
+#define ADDRSET_FAILURE         -1
+#define ADDRSET_SUCCESS         0
+
+#define ADDRSET_MAX             16      // Addresses kept per name
+#define ADDRSET_TEXT_LENGTH     (ADDRSET_MAX * 46)  // All, formatted
+
+
+/* One IPv4 or IPv6 address */
+typedef struct addrset_entry_s {
+    unsigned char family;       // AF_INET or AF_INET6
+    unsigned char bytes[16];    // Network order; IPv4 uses the first 4
+} addrset_entry;
+
+typedef struct addrset_s {
+    int count;
+    addrset_entry addrs[ADDRSET_MAX];
+} addrset;
+
+
+/* Function to look up every A and AAAA address of hostname
+ * Returns ADDRSET_SUCCESS, or ADDRSET_FAILURE if the name did not resolve
+ */
+int addrset_lookup(const char* hostname, addrset* set);
+
+/* Function to add an address unless the set has it or is full */
+void addrset_add(addrset* set, int family, const void* bytes);
+
+/* Function to format the first address, or every address separated by
+ * commas when all is set, into out
+ * Returns the length written
+ */
+int addrset_format(const addrset* set, int all, char* out, size_t size);
+
+#endif
@@ -0,0 +1,341 @@
+/******************************************************************************
+ * FILE: agg.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the aggregation stage.
+ *  Counts live in open-addressing hash tables keyed by address; a thread's
+ *      tables are linked onto the global list with one compare-and-swap
+ *      the first time it records, and are only walked by agg_write().
+ *
+ ******************************************************************************/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "agg.h"
+
+
+/* Families reported in the by-family rollup */
+#define AGG_IPV4                0
+#define AGG_IPV6                1
+#define AGG_FAILED_NAMES        2
+#define AGG_SKIPPED_NAMES       3       // Never looked up
+#define AGG_NUM_FAMILIES        4
+
+
+/* A count per address or prefix; a zero count marks an empty slot */
+typedef struct agg_entry_s {
+    addrset_entry key;
+    unsigned long count;
+} agg_entry;
+
+typedef struct agg_table_s {
+    agg_entry* slots;
+    unsigned long capacity;     // A power of two
+    unsigned long used;
+} agg_table;
+
+/* The counts recorded by one thread */
+typedef struct agg_local_s {
+    struct agg_local_s* next;
+    agg_table ips;
+    agg_table prefixes;
+    unsigned long families[AGG_NUM_FAMILIES];
+    FILE* failed;               // "hostname,status" lines
+    int lost;                   // Counts dropped for lack of memory
+} agg_local;
+
+
+static agg_local* locals = NULL;        // Every thread's counts
+static __thread agg_local* local = NULL;
+
+static const char* familyNames[AGG_NUM_FAMILIES] = {
+    "ipv4", "ipv6", "failed", "skipped"
+};
+
+
+static unsigned long agg_hash(const addrset_entry* key)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    int i;
+
+    hash = (hash ^ key->family) * 1099511628211ULL;
+    for (i = 0; i < 16; ++i) {
+        hash = (hash ^ key->bytes[i]) * 1099511628211ULL;
+    }
+    return (unsigned long) hash;
+}
+
+
+/* Add count to key's entry, growing the table past half full
+ * Returns AGG_SUCCESS, or AGG_FAILURE if out of memory
+ */
+static int agg_add(agg_table* t, const addrset_entry* key, unsigned long count)
+{
+    agg_table grown;
+    agg_entry* e;
+    unsigned long i;
+
+    if (2 * (t->used + 1) > t->capacity) {
+        grown.capacity = t->capacity ? 2 * t->capacity : AGG_INITIAL_SLOTS;
+        grown.used = 0;
+        if ((grown.slots = calloc(grown.capacity, sizeof(*grown.slots))) == NULL) {
+            return AGG_FAILURE;
+        }
+        for (i = 0; i < t->capacity; ++i) {
+            if (t->slots[i].count) {
+                agg_add(&grown, &t->slots[i].key, t->slots[i].count);
+            }
+        }
+        free(t->slots);
+        *t = grown;
+    }
+
+    for (i = agg_hash(key) & (t->capacity - 1); ; i = (i + 1) & (t->capacity - 1)) {
+        e = &t->slots[i];
+        if (e->count == 0) {
+            e->key = *key;
+            t->used++;
+            break;
+        }
+        if (!memcmp(&e->key, key, sizeof(*key))) {
+            break;
+        }
+    }
+    e->count += count;
+    return AGG_SUCCESS;
+}
+
+
+/* Zero everything past the prefix length of the address's family */
+static void agg_prefix(addrset_entry* key)
+{
+    int bits = key->family == AF_INET ? AGG_PREFIX4 : AGG_PREFIX6;
+
+    memset(key->bytes + bits / 8, 0, sizeof(key->bytes) - bits / 8);
+}
+
+
+/* The calling thread's counts, linked onto the global list on first use */
+static agg_local* agg_local_get(void)
+{
+    agg_local* l = local;
+
+    if (l == NULL) {
+        if ((l = calloc(1, sizeof(*l))) == NULL) {
+            return NULL;
+        }
+        if ((l->failed = tmpfile()) == NULL) {
+            l->lost = 1;
+        }
+        l->next = __atomic_load_n(&locals, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&locals, &l->next, l, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        local = l;
+    }
+    return l;
+}
+
+
+/* Count a name without an address and list it with its status */
+static void agg_spool(agg_local* l, int family, const char* hostname, const char* status)
+{
+    l->families[family]++;
+    if (l->failed) {
+        fprintf(l->failed, "%s,%s\n", hostname, status[0] ? status : AGG_FAILED_STATUS);
+    }
+}
+
+
+void agg_record(const char* hostname, const addrset* set, const char* status)
+{
+    agg_local* l = agg_local_get();
+    addrset_entry prefixes[ADDRSET_MAX];
+    int seen[AGG_NUM_FAMILIES] = {0};
+    int i;
+    int j;
+
+    if (l == NULL) {
+        return;
+    }
+
+    if (set->count == 0) {
+        agg_spool(l, AGG_FAILED_NAMES, hostname, status);
+        return;
+    }
+
+    /* A name counts once per address, prefix and family it has */
+    for (i = 0; i < set->count; ++i) {
+        if (agg_add(&l->ips, &set->addrs[i], 1) == AGG_FAILURE) {
+            l->lost = 1;
+        }
+        prefixes[i] = set->addrs[i];
+        agg_prefix(&prefixes[i]);
+        for (j = 0; j < i && memcmp(&prefixes[j], &prefixes[i], sizeof(prefixes[i])); ++j) {
+        }
+        if (j == i && agg_add(&l->prefixes, &prefixes[i], 1) == AGG_FAILURE) {
+            l->lost = 1;
+        }
+        seen[set->addrs[i].family == AF_INET ? AGG_IPV4 : AGG_IPV6] = 1;
+    }
+    for (i = 0; i < AGG_NUM_FAMILIES; ++i) {
+        l->families[i] += seen[i];
+    }
+}
+
+
+void agg_skip(const char* hostname, const char* status)
+{
+    agg_local* l = agg_local_get();
+
+    if (l != NULL) {
+        agg_spool(l, AGG_SKIPPED_NAMES, hostname, status);
+    }
+}
+
+
+/* Most hostnames first, then by address */
+static int agg_compare(const void* a, const void* b)
+{
+    const agg_entry* x = (const agg_entry*) a;
+    const agg_entry* y = (const agg_entry*) b;
+
+    if (x->count != y->count) {
+        return x->count < y->count ? 1 : -1;
+    }
+    return memcmp(&x->key, &y->key, sizeof(x->key));
+}
+
+
+/* Write a merged table as "address,count" lines, or "address/bits,count"
+ * lines when prefixed
+ * Returns AGG_SUCCESS or AGG_FAILURE
+ */
+static int agg_write_table(const char* path, const char* suffix, agg_table* t,
+                           int prefixed)
+{
+    char name[PATH_MAX];
+    char text[INET6_ADDRSTRLEN];
+    FILE* fp;
+    unsigned long i;
+    unsigned long n = 0;
+
+    /* Pack the entries to the front and sort them */
+    for (i = 0; i < t->capacity; ++i) {
+        if (t->slots[i].count) {
+            t->slots[n++] = t->slots[i];
+        }
+    }
+    if (n) {
+        qsort(t->slots, n, sizeof(*t->slots), agg_compare);
+    }
+
+    snprintf(name, sizeof(name), "%s%s", path, suffix);
+    if ((fp = fopen(name, "w")) == NULL) {
+        return AGG_FAILURE;
+    }
+    for (i = 0; i < n; ++i) {
+        inet_ntop(t->slots[i].key.family, t->slots[i].key.bytes, text, sizeof(text));
+        if (prefixed) {
+            fprintf(fp, "%s/%d,%lu\n", text,
+                    t->slots[i].key.family == AF_INET ? AGG_PREFIX4 : AGG_PREFIX6,
+                    t->slots[i].count);
+        }
+        else {
+            fprintf(fp, "%s,%lu\n", text, t->slots[i].count);
+        }
+    }
+    return fclose(fp) ? AGG_FAILURE : AGG_SUCCESS;
+}
+
+
+int agg_write(const char* path)
+{
+    agg_table ips = {0};
+    agg_table prefixes = {0};
+    unsigned long families[AGG_NUM_FAMILIES] = {0};
+    char name[PATH_MAX];
+    char buf[64 * 1024];
+    FILE* failed;
+    FILE* fp;
+    agg_local* l;
+    agg_local* next;
+    unsigned long i;
+    size_t n;
+    int lost = 0;
+    int rc = AGG_SUCCESS;
+
+    snprintf(name, sizeof(name), "%s%s", path, AGG_FAILED);
+    failed = fopen(name, "w");
+
+    /* Merge and Free Every Thread's Counts */
+    for (l = __atomic_load_n(&locals, __ATOMIC_ACQUIRE); l != NULL; l = next) {
+        next = l->next;
+        for (i = 0; i < l->ips.capacity; ++i) {
+            if (l->ips.slots[i].count
+                    && agg_add(&ips, &l->ips.slots[i].key, l->ips.slots[i].count)) {
+                lost = 1;
+            }
+        }
+        for (i = 0; i < l->prefixes.capacity; ++i) {
+            if (l->prefixes.slots[i].count
+                    && agg_add(&prefixes, &l->prefixes.slots[i].key,
+                               l->prefixes.slots[i].count)) {
+                lost = 1;
+            }
+        }
+        for (i = 0; i < AGG_NUM_FAMILIES; ++i) {
+            families[i] += l->families[i];
+        }
+        if (l->failed) {
+            rewind(l->failed);
+            while (failed && (n = fread(buf, 1, sizeof(buf), l->failed)) > 0) {
+                fwrite(buf, 1, n, failed);
+            }
+            fclose(l->failed);
+        }
+        lost |= l->lost;
+        free(l->ips.slots);
+        free(l->prefixes.slots);
+        free(l);
+    }
+    locals = NULL;
+
+    /* Write the Reports */
+    if (failed == NULL || fclose(failed)) {
+        rc = AGG_FAILURE;
+    }
+    if (agg_write_table(path, AGG_BY_IP, &ips, 0) == AGG_FAILURE
+            || agg_write_table(path, AGG_BY_PREFIX, &prefixes, 1) == AGG_FAILURE) {
+        rc = AGG_FAILURE;
+    }
+    snprintf(name, sizeof(name), "%s%s", path, AGG_BY_FAMILY);
+    if ((fp = fopen(name, "w")) == NULL) {
+        rc = AGG_FAILURE;
+    }
+    else {
+        for (i = 0; i < AGG_NUM_FAMILIES; ++i) {
+            fprintf(fp, "%s,%lu\n", familyNames[i], families[i]);
+        }
+        if (fclose(fp)) {
+            rc = AGG_FAILURE;
+        }
+    }
+    free(ips.slots);
+    free(prefixes.slots);
+
+    if (lost && rc == AGG_SUCCESS) {
+        errno = ENOMEM;
+        rc = AGG_FAILURE;
+    }
+    return rc;
+}
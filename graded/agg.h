@@ -0,0 +1,61 @@
+/******************************************************************************
+ * FILE: agg.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for the aggregation stage, which rolls
+ *      results up as they are written instead of in a second pass over the
+ *      output file.
+ *  Each writing thread counts hostnames per address, per prefix (/24 for
+ *      IPv4, /48 for IPv6) and per address family in its own hash tables,
+ *      and appends failed and skipped names to its own temporary file, so recording
+ *      takes no lock. agg_write() merges the threads' tables and writes the
+ *      reports next to the output.
+ *
+ ******************************************************************************/
+
+#ifndef AGG_H
+#define AGG_H
+
+/* Local Includes */
+#include "addrset.h"
+
+
+#define AGG_FAILURE             -1
+#define AGG_SUCCESS             0
+
+#define AGG_INITIAL_SLOTS       1024    // Hash table slots, doubled as needed
+#define AGG_PREFIX4             24      // Prefix lengths rolled up
+#define AGG_PREFIX6             48
+#define AGG_FAILED_STATUS       "LOOKUP_FAILED"     // For an empty result
+
+/* Reports, appended to the output path */
+#define AGG_BY_IP               ".by-ip"
+#define AGG_BY_PREFIX           ".by-prefix"
+#define AGG_BY_FAMILY           ".by-family"
+#define AGG_FAILED              ".failed"
+
+
+/* Function to record one written hostname with its addresses; an empty
+ * set records a failure with the given status (AGG_FAILED_STATUS if "")
+ * Safe to call from many threads at once
+ */
+void agg_record(const char* hostname, const addrset* set, const char* status);
+
+/* Function to record one written hostname that was never looked up, such
+ * as a malformed, excluded or expired name; it is listed with its status
+ * among the failures but counted as skipped, not failed
+ * Safe to call from many threads at once
+ */
+void agg_skip(const char* hostname, const char* status);
+
+/* Function to merge every thread's counts and write the reports to path
+ * plus each report suffix, once recording has stopped; frees the tables
+ * Returns AGG_SUCCESS, or AGG_FAILURE (errno set) if a report could not be
+ * written or counts were lost for lack of memory
+ */
+int agg_write(const char* path);
+
+#endif
@@ -0,0 +1,419 @@
+/******************************************************************************
+ * FILE: cfile.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of streaming gzip/zstd file access through a pipe and
+ *      a codec helper thread.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "cfile.h"
+
+
+/* Write all of buf to a pipe or file descriptor */
+static int write_all(int fd, const unsigned char* buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return CFILE_FAILURE;
+        }
+        buf += n;
+        len -= n;
+    }
+    return CFILE_SUCCESS;
+}
+
+
+/* Read up to len bytes from a pipe, returning 0 only at end of stream */
+static ssize_t read_some(int fd, unsigned char* buf, size_t len)
+{
+    ssize_t n;
+
+    do {
+        n = read(fd, buf, len);
+    } while (n < 0 && errno == EINTR);
+
+    return n;
+}
+
+
+/* Inflate gzip members from raw into the pipe */
+static int gzip_decompress(cfile* cf, unsigned char* in, unsigned char* out)
+{
+    z_stream zs;
+    size_t n;
+    int zrc = Z_OK;
+    int rc = CFILE_SUCCESS;
+
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 32) != Z_OK) {
+        return CFILE_FAILURE;
+    }
+
+    while (rc == CFILE_SUCCESS && (n = fread(in, 1, CFILE_CHUNK, cf->raw)) > 0) {
+        zs.next_in = in;
+        zs.avail_in = n;
+        while (zs.avail_in > 0) {
+            /* Concatenated gzip members are one stream */
+            if (zrc == Z_STREAM_END && inflateReset(&zs) != Z_OK) {
+                rc = CFILE_FAILURE;
+                break;
+            }
+            zs.next_out = out;
+            zs.avail_out = CFILE_CHUNK;
+            zrc = inflate(&zs, Z_NO_FLUSH);
+            if (zrc != Z_OK && zrc != Z_STREAM_END && zrc != Z_BUF_ERROR) {
+                fprintf(stderr, "GZIP ERROR: %s\n", zs.msg ? zs.msg : "inflate failed");
+                rc = CFILE_FAILURE;
+                break;
+            }
+            if (write_all(cf->pipefd, out, CFILE_CHUNK - zs.avail_out)) {
+                rc = CFILE_FAILURE;
+                break;
+            }
+        }
+    }
+    if (rc == CFILE_SUCCESS && (ferror(cf->raw) || zrc != Z_STREAM_END)) {
+        fprintf(stderr, "GZIP ERROR: Truncated or unreadable input\n");
+        rc = CFILE_FAILURE;
+    }
+
+    inflateEnd(&zs);
+    return rc;
+}
+
+
+/* Deflate text from the pipe into a gzip raw file */
+static int gzip_compress(cfile* cf, unsigned char* in, unsigned char* out)
+{
+    z_stream zs;
+    ssize_t n;
+    int flush = Z_NO_FLUSH;
+    int rc = CFILE_SUCCESS;
+
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return CFILE_FAILURE;
+    }
+
+    while (flush != Z_FINISH) {
+        if ((n = read_some(cf->pipefd, in, CFILE_CHUNK)) < 0) {
+            rc = CFILE_FAILURE;
+            n = 0;
+        }
+        flush = n ? Z_NO_FLUSH : Z_FINISH;
+        zs.next_in = in;
+        zs.avail_in = n;
+        do {
+            zs.next_out = out;
+            zs.avail_out = CFILE_CHUNK;
+            deflate(&zs, flush);
+            if (fwrite(out, 1, CFILE_CHUNK - zs.avail_out, cf->raw)
+                    != CFILE_CHUNK - zs.avail_out) {
+                rc = CFILE_FAILURE;
+            }
+        } while (zs.avail_out == 0);
+    }
+
+    deflateEnd(&zs);
+    return rc;
+}
+
+
+#ifdef HAVE_ZSTD
+/* Decompress zstd frames from raw into the pipe */
+static int zstd_decompress(cfile* cf, unsigned char* in, unsigned char* out)
+{
+    ZSTD_DCtx* dctx;
+    ZSTD_inBuffer zin;
+    ZSTD_outBuffer zout;
+    size_t n;
+    size_t zrc = 0;
+    int rc = CFILE_SUCCESS;
+
+    if ((dctx = ZSTD_createDCtx()) == NULL) {
+        return CFILE_FAILURE;
+    }
+
+    while (rc == CFILE_SUCCESS && (n = fread(in, 1, CFILE_CHUNK, cf->raw)) > 0) {
+        zin.src = in;
+        zin.size = n;
+        zin.pos = 0;
+        while (zin.pos < zin.size) {
+            zout.dst = out;
+            zout.size = CFILE_CHUNK;
+            zout.pos = 0;
+            zrc = ZSTD_decompressStream(dctx, &zout, &zin);
+            if (ZSTD_isError(zrc)) {
+                fprintf(stderr, "ZSTD ERROR: %s\n", ZSTD_getErrorName(zrc));
+                rc = CFILE_FAILURE;
+                break;
+            }
+            if (write_all(cf->pipefd, out, zout.pos)) {
+                rc = CFILE_FAILURE;
+                break;
+            }
+        }
+    }
+    if (rc == CFILE_SUCCESS && (ferror(cf->raw) || zrc != 0)) {
+        fprintf(stderr, "ZSTD ERROR: Truncated or unreadable input\n");
+        rc = CFILE_FAILURE;
+    }
+
+    ZSTD_freeDCtx(dctx);
+    return rc;
+}
+
+
+/* Compress text from the pipe into a zstd raw file */
+static int zstd_compress(cfile* cf, unsigned char* in, unsigned char* out)
+{
+    ZSTD_CCtx* cctx;
+    ZSTD_inBuffer zin;
+    ZSTD_outBuffer zout;
+    ZSTD_EndDirective mode = ZSTD_e_continue;
+    ssize_t n;
+    size_t remaining;
+    int rc = CFILE_SUCCESS;
+
+    if ((cctx = ZSTD_createCCtx()) == NULL) {
+        return CFILE_FAILURE;
+    }
+
+    while (mode != ZSTD_e_end) {
+        if ((n = read_some(cf->pipefd, in, CFILE_CHUNK)) < 0) {
+            rc = CFILE_FAILURE;
+            n = 0;
+        }
+        mode = n ? ZSTD_e_continue : ZSTD_e_end;
+        zin.src = in;
+        zin.size = n;
+        zin.pos = 0;
+        do {
+            zout.dst = out;
+            zout.size = CFILE_CHUNK;
+            zout.pos = 0;
+            remaining = ZSTD_compressStream2(cctx, &zout, &zin, mode);
+            if (ZSTD_isError(remaining)) {
+                fprintf(stderr, "ZSTD ERROR: %s\n", ZSTD_getErrorName(remaining));
+                rc = CFILE_FAILURE;
+                break;
+            }
+            if (fwrite(out, 1, zout.pos, cf->raw) != zout.pos) {
+                rc = CFILE_FAILURE;
+            }
+        } while (mode == ZSTD_e_end ? remaining != 0 : zin.pos < zin.size);
+    }
+
+    ZSTD_freeCCtx(cctx);
+    return rc;
+}
+#endif
+
+
+/* Helper thread body: run the codec between raw and the pipe */
+static void* cfile_codec(void* arg)
+{
+    cfile* cf = (cfile*) arg;
+    unsigned char* in;
+    unsigned char* out;
+    sigset_t mask;
+
+    /* A reader that closes early makes our pipe writes fail with EPIPE */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    in = malloc(CFILE_CHUNK);
+    out = malloc(CFILE_CHUNK);
+    if (!in || !out) {
+        cf->rc = CFILE_FAILURE;
+    }
+    else if (cf->format == CFILE_GZIP) {
+        cf->rc = cf->writing ? gzip_compress(cf, in, out)
+                             : gzip_decompress(cf, in, out);
+    }
+#ifdef HAVE_ZSTD
+    else if (cf->format == CFILE_ZSTD) {
+        cf->rc = cf->writing ? zstd_compress(cf, in, out)
+                             : zstd_decompress(cf, in, out);
+    }
+#endif
+    free(in);
+    free(out);
+
+    close(cf->pipefd);
+    if (fclose(cf->raw)) {
+        cf->rc = CFILE_FAILURE;
+    }
+
+    return NULL;
+}
+
+
+/* Connect cf->fp to a codec thread through a pipe */
+static int cfile_start(cfile* cf)
+{
+    int fds[2];
+    int rc;
+
+    if (pipe(fds)) {
+        return CFILE_FAILURE;
+    }
+
+    /* The caller gets one end of the pipe, the helper thread the other */
+    cf->fp = fdopen(fds[cf->writing ? 1 : 0], cf->writing ? "w" : "r");
+    cf->pipefd = fds[cf->writing ? 0 : 1];
+    if (!cf->fp) {
+        close(fds[0]);
+        close(fds[1]);
+        return CFILE_FAILURE;
+    }
+
+    cf->rc = CFILE_SUCCESS;
+    if ((rc = pthread_create(&cf->thread, NULL, cfile_codec, cf))) {
+        fclose(cf->fp);
+        close(cf->pipefd);
+        errno = rc;
+        return CFILE_FAILURE;
+    }
+    return CFILE_SUCCESS;
+}
+
+
+int cfile_open_read(cfile* cf, const char* path)
+{
+    unsigned char magic[4];
+    size_t n;
+
+    cf->writing = 0;
+    cf->format = CFILE_PLAIN;
+    if ((cf->raw = fopen(path, "r")) == NULL) {
+        return CFILE_FAILURE;
+    }
+
+    /* Sniff the format, then start over at the beginning */
+    n = fread(magic, 1, sizeof(magic), cf->raw);
+    rewind(cf->raw);
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        cf->format = CFILE_GZIP;
+    }
+    else if (n == 4 && magic[0] == 0x28 && magic[1] == 0xb5
+            && magic[2] == 0x2f && magic[3] == 0xfd) {
+#ifdef HAVE_ZSTD
+        cf->format = CFILE_ZSTD;
+#else
+        fprintf(stderr, "ZSTD ERROR: [%s] is zstd compressed; rebuild with ZSTD=1\n",
+                path);
+        fclose(cf->raw);
+        errno = ENOTSUP;
+        return CFILE_FAILURE;
+#endif
+    }
+
+    /* Only a hint: the kernel starts reading the file into the page cache.
+     * It must come before cfile_start(), as the helper thread closes raw
+     * as soon as it reaches the end of a small file */
+    posix_fadvise(fileno(cf->raw), 0, 0, POSIX_FADV_WILLNEED);
+
+    if (cf->format == CFILE_PLAIN) {
+        cf->fp = cf->raw;
+        return CFILE_SUCCESS;
+    }
+    if (cfile_start(cf)) {
+        fclose(cf->raw);
+        return CFILE_FAILURE;
+    }
+    return CFILE_SUCCESS;
+}
+
+
+int cfile_open_write(cfile* cf, const char* path, int format)
+{
+    cf->writing = 1;
+    cf->format = format;
+    if ((cf->raw = fopen(path, "w")) == NULL) {
+        return CFILE_FAILURE;
+    }
+
+    if (cf->format == CFILE_PLAIN) {
+        cf->fp = cf->raw;
+        return CFILE_SUCCESS;
+    }
+    if (cfile_start(cf)) {
+        fclose(cf->raw);
+        return CFILE_FAILURE;
+    }
+    return CFILE_SUCCESS;
+}
+
+
+int cfile_open_append(cfile* cf, const char* path)
+{
+    cf->writing = 1;
+    cf->format = CFILE_PLAIN;
+    if ((cf->raw = fopen(path, "a")) == NULL) {
+        return CFILE_FAILURE;
+    }
+    cf->fp = cf->raw;
+    return CFILE_SUCCESS;
+}
+
+
+int cfile_close(cfile* cf)
+{
+    int rc = CFILE_SUCCESS;
+
+    if (fclose(cf->fp)) {
+        rc = CFILE_FAILURE;
+    }
+    if (cf->format == CFILE_PLAIN) {
+        return rc;
+    }
+
+    /* Closing our end of the pipe lets the helper thread finish */
+    pthread_join(cf->thread, NULL);
+    if (cf->rc != CFILE_SUCCESS) {
+        rc = CFILE_FAILURE;
+    }
+    return rc;
+}
+
+
+int cfile_parse_format(const char* name)
+{
+    if (!strcmp(name, "none")) {
+        return CFILE_PLAIN;
+    }
+    if (!strcmp(name, "gzip")) {
+        return CFILE_GZIP;
+    }
+#ifdef HAVE_ZSTD
+    if (!strcmp(name, "zstd")) {
+        return CFILE_ZSTD;
+    }
+#endif
+    return CFILE_FAILURE;
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * FILE: cfile.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for streaming compressed file access.
+ *  A cfile wraps a plain, gzip or zstd file behind an ordinary FILE* stream.
+ *  Compressed data is inflated or deflated by a helper thread on the other
+ *      end of a pipe, so the caller keeps parsing or writing while the codec
+ *      runs, and memory stays bounded by the codec buffers and the pipe.
+ *  zstd support is only available when built with HAVE_ZSTD (make ZSTD=1).
+ *
+ ******************************************************************************/
+
+#ifndef CFILE_H
+#define CFILE_H
+
+/* Standard Includes */
+#include <pthread.h>
+#include <stdio.h>
+
+
+#define CFILE_FAILURE           -1
+#define CFILE_SUCCESS           0
+
+/* Stream formats */
+#define CFILE_PLAIN             0
+#define CFILE_GZIP              1
+#define CFILE_ZSTD              2
+
+#define CFILE_CHUNK             (64 * 1024)     // Codec buffer size
+
+
+typedef struct cfile_s {
+    FILE* fp;                   // Stream the caller reads or writes
+    FILE* raw;                  // Underlying file, owned by the helper thread
+    int pipefd;                 // Helper thread's end of the pipe
+    int format;                 // CFILE_* format of the underlying file
+    int writing;
+    int rc;                     // Helper thread result, CFILE_SUCCESS or CFILE_FAILURE
+    pthread_t thread;
+} cfile;
+
+
+/* Function to open a file for reading, detecting gzip and zstd input by
+ * magic number; cf->fp then yields the decompressed text
+ * The kernel is asked to start reading the file ahead of the caller, so
+ * it is cached by the time parsing gets to it
+ * Returns CFILE_SUCCESS or CFILE_FAILURE (errno set)
+ */
+int cfile_open_read(cfile* cf, const char* path);
+
+/* Function to open a file for writing in the given CFILE_* format;
+ * text written to cf->fp is compressed on the way to path
+ * Returns CFILE_SUCCESS or CFILE_FAILURE (errno set)
+ */
+int cfile_open_write(cfile* cf, const char* path, int format);
+
+/* Function to open an uncompressed file for appending, as when resuming
+ * Returns CFILE_SUCCESS or CFILE_FAILURE (errno set)
+ */
+int cfile_open_append(cfile* cf, const char* path);
+
+/* Function to close the stream and wait for the helper thread
+ * Returns CFILE_SUCCESS, or CFILE_FAILURE if the file or codec failed
+ */
+int cfile_close(cfile* cf);
+
+/* Function to parse a format name ("none", "gzip" or "zstd")
+ * Returns the CFILE_* format, or CFILE_FAILURE if unknown or not built in
+ */
+int cfile_parse_format(const char* name);
+
+#endif
@@ -0,0 +1,310 @@
+/******************************************************************************
+ * FILE: cfileTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the compressed file streams in cfile.h.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cfile.h"
+
+#define TEST_LINES      100000  // Far more text than a pipe or codec buffer holds
+#define TEST_PATH       "/tmp/cfileTest.out"
+#define TEST_NAME       "host%06d.example.com\n"
+#define TEST_SMALL      64      // Small gzip inputs shared by the readers
+#define TEST_SMALL_PATH "/tmp/cfileTest.%d.gz"
+#define TEST_THREADS    4
+
+static unsigned int nextSmall;  // Next small input to claim
+static int smallRead[TEST_SMALL];       // Times each small input was read intact
+
+
+/* Write TEST_LINES names to path in format
+ * Returns 1 on a failure
+ */
+static int write_names(const char* path, int format)
+{
+    cfile cf;
+    int i;
+
+    if (cfile_open_write(&cf, path, format) == CFILE_FAILURE) {
+        perror("error: cfile_open_write failed");
+        return 1;
+    }
+    for (i = 0; i < TEST_LINES; ++i) {
+        fprintf(cf.fp, TEST_NAME, i);
+    }
+    if (cfile_close(&cf) == CFILE_FAILURE) {
+        fprintf(stderr, "error: closing a written stream in format %d failed\n", format);
+        return 1;
+    }
+    return 0;
+}
+
+
+/* Read path back, checking it holds the names write_names() wrote
+ * Returns 1 on a failure
+ */
+static int read_names(const char* path, int format)
+{
+    char line[64];
+    char expect[64];
+    cfile cf;
+    int i = 0;
+    int bad = 0;
+
+    if (cfile_open_read(&cf, path) == CFILE_FAILURE) {
+        perror("error: cfile_open_read failed");
+        return 1;
+    }
+    if (cf.format != format) {
+        fprintf(stderr, "error: format %d was detected as %d\n", format, cf.format);
+        bad = 1;
+    }
+    while (fgets(line, sizeof(line), cf.fp)) {
+        snprintf(expect, sizeof(expect), TEST_NAME, i++);
+        bad |= strcmp(line, expect) != 0;
+    }
+    if (cfile_close(&cf) == CFILE_FAILURE) {
+        fprintf(stderr, "error: closing a read stream in format %d failed\n", format);
+        bad = 1;
+    }
+    if (bad || i != TEST_LINES) {
+        fprintf(stderr, "error: format %d read back %d of %d names%s\n",
+                format, i, TEST_LINES, bad ? ", some wrong" : "");
+        return 1;
+    }
+    return 0;
+}
+
+
+/* Claim and open the next small input, as the requester pool does
+ * Returns its number, or -1 once every input is claimed
+ */
+static int claim_small(cfile* cf)
+{
+    char path[64];
+    int i;
+
+    while ((i = __atomic_fetch_add(&nextSmall, 1, __ATOMIC_RELAXED)) < TEST_SMALL) {
+        snprintf(path, sizeof(path), TEST_SMALL_PATH, i);
+        if (cfile_open_read(cf, path) == CFILE_SUCCESS) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/* Read small inputs, opening each while the one before it is read, so the
+ * codec thread of a small file often finishes before the reader gets to it */
+static void* small_reader(void* arg)
+{
+    cfile files[2];
+    cfile* input = &files[0];
+    cfile* opened = &files[1];
+    cfile* swap;
+    char line[64];
+    char expect[64];
+    int next;
+    int i;
+
+    (void) arg;
+
+    next = claim_small(opened);
+    while ((i = next) >= 0) {
+        swap = input;
+        input = opened;
+        opened = swap;
+        next = claim_small(opened);
+
+        snprintf(expect, sizeof(expect), TEST_NAME, i);
+        if (fgets(line, sizeof(line), input->fp) && !strcmp(line, expect)
+                && !fgets(line, sizeof(line), input->fp)
+                && cfile_close(input) == CFILE_SUCCESS) {
+            __atomic_fetch_add(&smallRead[i], 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+
+/* Cut the file at path to length bytes, or flip the byte at length
+ * Returns 1 on a failure
+ */
+static int damage(const char* path, long length, int flip)
+{
+    FILE* fp;
+    int c;
+
+    if (!flip) {
+        return truncate(path, length) != 0;
+    }
+    if ((fp = fopen(path, "r+")) == NULL || fseek(fp, length, SEEK_SET)
+            || (c = fgetc(fp)) == EOF || fseek(fp, length, SEEK_SET)
+            || fputc(c ^ 0xff, fp) == EOF) {
+        if (fp) {
+            fclose(fp);
+        }
+        return 1;
+    }
+    return fclose(fp) != 0;
+}
+
+
+/* Read a damaged file through, checking the close reports it
+ * Returns 1 on a failure
+ */
+static int read_damaged(const char* path, const char* what)
+{
+    char line[64];
+    cfile cf;
+
+    if (cfile_open_read(&cf, path) == CFILE_FAILURE) {
+        perror("error: cfile_open_read failed");
+        return 1;
+    }
+    while (fgets(line, sizeof(line), cf.fp)) {
+    }
+    if (cfile_close(&cf) != CFILE_FAILURE) {
+        fprintf(stderr, "error: a %s stream closed cleanly\n", what);
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    static const int formats[] = {
+        CFILE_PLAIN, CFILE_GZIP,
+#ifdef HAVE_ZSTD
+        CFILE_ZSTD,
+#endif
+    };
+    pthread_t threads[TEST_THREADS];
+    char path[64];
+    char line[64];
+    struct stat st;
+    cfile cf;
+    int failures = 0;
+    int wrong;
+    int i;
+
+    /* Format names, with zstd only when it is built in */
+    if (cfile_parse_format("none") != CFILE_PLAIN
+            || cfile_parse_format("gzip") != CFILE_GZIP
+            || cfile_parse_format("bzip2") != CFILE_FAILURE
+#ifdef HAVE_ZSTD
+            || cfile_parse_format("zstd") != CFILE_ZSTD) {
+#else
+            || cfile_parse_format("zstd") != CFILE_FAILURE) {
+#endif
+        fprintf(stderr, "error: format names parsed wrongly\n");
+        failures++;
+    }
+
+    /* Every format round trips through the codec thread and the pipe */
+    for (i = 0; i < (int) (sizeof(formats) / sizeof(formats[0])); ++i) {
+        if (write_names(TEST_PATH, formats[i]) || read_names(TEST_PATH, formats[i])) {
+            failures++;
+        }
+    }
+
+    /* A reader that stops early is neither killed by SIGPIPE nor left
+     * waiting for the codec thread */
+    if (write_names(TEST_PATH, CFILE_GZIP) == 0) {
+        if (cfile_open_read(&cf, TEST_PATH) == CFILE_FAILURE
+                || !fgets(line, sizeof(line), cf.fp)) {
+            fprintf(stderr, "error: reopening the gzip stream failed\n");
+            failures++;
+        }
+        else {
+            cfile_close(&cf);
+        }
+    }
+    else {
+        failures++;
+    }
+
+    /* Truncated and corrupted gzip input are reported at close */
+    if (stat(TEST_PATH, &st) || damage(TEST_PATH, st.st_size / 2, 1)) {
+        perror("error: corrupting the gzip file failed");
+        failures++;
+    }
+    else {
+        failures += read_damaged(TEST_PATH, "corrupted gzip");
+    }
+    if (damage(TEST_PATH, st.st_size / 3, 0)) {
+        perror("error: truncating the gzip file failed");
+        failures++;
+    }
+    else {
+        failures += read_damaged(TEST_PATH, "truncated gzip");
+    }
+
+    /* Small gzip inputs are opened ahead of their readers, from several
+     * threads at once, and each is read exactly once */
+    for (i = 0; i < TEST_SMALL; ++i) {
+        snprintf(path, sizeof(path), TEST_SMALL_PATH, i);
+        if (cfile_open_write(&cf, path, CFILE_GZIP) == CFILE_FAILURE) {
+            perror("error: cfile_open_write failed");
+            return EXIT_FAILURE;
+        }
+        fprintf(cf.fp, TEST_NAME, i);
+        if (cfile_close(&cf) == CFILE_FAILURE) {
+            perror("error: cfile_close failed");
+            return EXIT_FAILURE;
+        }
+    }
+    for (i = 0; i < TEST_THREADS; ++i) {
+        if (pthread_create(&threads[i], NULL, small_reader, NULL)) {
+            perror("error: pthread_create failed");
+            return EXIT_FAILURE;
+        }
+    }
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0, wrong = 0; i < TEST_SMALL; ++i) {
+        wrong += smallRead[i] != 1;
+        snprintf(path, sizeof(path), TEST_SMALL_PATH, i);
+        unlink(path);
+    }
+    if (wrong) {
+        fprintf(stderr, "error: %d small gzip inputs not read exactly once\n", wrong);
+        failures++;
+    }
+
+    /* Missing files fail to open with errno set */
+    errno = 0;
+    if (cfile_open_read(&cf, "/nonexistent/cfileTest") != CFILE_FAILURE || errno != ENOENT) {
+        fprintf(stderr, "error: a missing file was opened\n");
+        failures++;
+    }
+    unlink(TEST_PATH);
+
+    if (failures) {
+        fprintf(stderr, "%d cfile test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All cfile tests passed\n");
+
+    return EXIT_SUCCESS;
+}
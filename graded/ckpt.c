@@ -0,0 +1,230 @@
+/******************************************************************************
+ * FILE: ckpt.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of checkpoints: contiguous progress tracking, and the
+ *      checkpoint file, written to a temporary file, fsync'd and renamed
+ *      into place so a crash leaves either the old or the new checkpoint.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ckpt.h"
+
+#define CKPT_BIT(s, i)          ((s)->done[((i) % CKPT_WINDOW) / 8] & (1 << ((i) % 8)))
+
+
+void ckpt_source_init(ckpt_source* s)
+{
+    memset(s->done, 0, sizeof(s->done));
+    s->next = 0;
+    s->safe.names = 0;
+    s->safe.offset = 0;
+    s->haveAhead = 0;
+    s->resume = s->safe;
+    s->skip = NULL;
+    s->numSkip = 0;
+    ckpt_marks_init(&s->marks);
+}
+
+
+void ckpt_mark_input(ckpt_source* s, unsigned long names, long offset)
+{
+    ckpt_mark mark = {names, offset};
+
+    /* A full ring only coarsens the checkpoint; never wait for the writer */
+    ckpt_marks_push(&s->marks, &mark);
+}
+
+
+/* Take the latest batch boundary the contiguous mark has passed */
+static void ckpt_advance(ckpt_source* s)
+{
+    for (;;) {
+        if (!s->haveAhead) {
+            if (ckpt_marks_pop(&s->marks, &s->ahead) == RING_FAILURE) {
+                return;
+            }
+            s->haveAhead = 1;
+        }
+        if (s->ahead.names > s->next) {
+            return;
+        }
+        s->safe = s->ahead;
+        s->haveAhead = 0;
+    }
+}
+
+
+void ckpt_written(ckpt_source* s, unsigned long index)
+{
+    if (index < s->next || index - s->next >= CKPT_WINDOW) {
+        return;
+    }
+    s->done[(index % CKPT_WINDOW) / 8] |= 1 << (index % 8);
+
+    /* Slide the contiguous mark over everything now written */
+    while (CKPT_BIT(s, s->next)) {
+        s->done[(s->next % CKPT_WINDOW) / 8] &= ~(1 << (s->next % 8));
+        s->next++;
+    }
+
+    /* Drain the marks as names are written, so the ring never fills up and
+     * the boundary stays within a batch or so of the contiguous mark */
+    ckpt_advance(s);
+}
+
+
+/* fsync the directory holding path so a rename into it is durable */
+static void ckpt_sync_dir(const char* path)
+{
+    char copy[PATH_MAX];
+    int fd;
+
+    strncpy(copy, path, sizeof(copy));
+    copy[sizeof(copy) - 1] = '\0';
+    if ((fd = open(dirname(copy), O_RDONLY | O_DIRECTORY)) >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+
+int ckpt_save(const char* path, FILE* output, ckpt_source* sources,
+              char* const* paths, int numSources)
+{
+    char tmp[PATH_MAX];
+    FILE* fp;
+    ckpt_source* s;
+    unsigned long i;
+    unsigned long count;
+    long bytes;
+    int n;
+
+    /* The output must be on disk before a checkpoint says it is */
+    if (fflush(output) || fsync(fileno(output)) || (bytes = ftell(output)) < 0) {
+        return CKPT_FAILURE;
+    }
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    if ((fp = fopen(tmp, "w")) == NULL) {
+        return CKPT_FAILURE;
+    }
+    fprintf(fp, "%s\noutput %ld\n", CKPT_MAGIC, bytes);
+    for (n = 0; n < numSources; ++n) {
+        s = &sources[n];
+        ckpt_advance(s);
+        fprintf(fp, "input %lu %ld %s\n", s->safe.names, s->safe.offset, paths[n]);
+
+        /* Names past the boundary that are written already */
+        count = s->next - s->safe.names;
+        for (i = 0; i < CKPT_WINDOW; ++i) {
+            count += CKPT_BIT(s, s->next + i) != 0;
+        }
+        fprintf(fp, "done %lu", count);
+        for (i = s->safe.names; i < s->next; ++i) {
+            fprintf(fp, " %lu", i);
+        }
+        for (i = 0; i < CKPT_WINDOW; ++i) {
+            if (CKPT_BIT(s, s->next + i)) {
+                fprintf(fp, " %lu", s->next + i);
+            }
+        }
+        fprintf(fp, "\n");
+    }
+
+    if (fflush(fp) || fsync(fileno(fp))) {
+        fclose(fp);
+        unlink(tmp);
+        return CKPT_FAILURE;
+    }
+    if (fclose(fp) || rename(tmp, path)) {
+        unlink(tmp);
+        return CKPT_FAILURE;
+    }
+    ckpt_sync_dir(path);
+    return CKPT_SUCCESS;
+}
+
+
+int ckpt_load(const char* path, long* outputBytes, ckpt_source* sources,
+              char* const* paths, int numSources)
+{
+    FILE* fp;
+    ckpt_source* s;
+    char* line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+    unsigned long count;
+    unsigned long i;
+    int n;
+
+    if ((fp = fopen(path, "r")) == NULL) {
+        return CKPT_FAILURE;
+    }
+    if ((len = getline(&line, &cap, fp)) < 0 || strncmp(line, CKPT_MAGIC, strlen(CKPT_MAGIC))
+            || fscanf(fp, "output %ld\n", outputBytes) != 1) {
+        goto invalid;
+    }
+
+    for (n = 0; n < numSources; ++n) {
+        s = &sources[n];
+        ckpt_source_init(s);
+        if (fscanf(fp, " input %lu %ld ", &s->resume.names, &s->resume.offset) != 2
+                || (len = getline(&line, &cap, fp)) < 1) {
+            goto invalid;
+        }
+        line[len - 1] = '\0';
+        if (strcmp(line, paths[n])) {
+            goto invalid;
+        }
+        if (fscanf(fp, "done %lu", &count) != 1 || count > CKPT_WINDOW
+                || (count && (s->skip = malloc(count * sizeof(*s->skip))) == NULL)) {
+            goto invalid;
+        }
+        for (i = 0; i < count; ++i) {
+            if (fscanf(fp, " %lu", &s->skip[i]) != 1) {
+                goto invalid;
+            }
+        }
+        s->numSkip = count;
+
+        /* Pick up where the checkpoint left off */
+        s->next = s->resume.names;
+        s->safe = s->resume;
+        for (i = 0; i < count; ++i) {
+            ckpt_written(s, s->skip[i]);
+        }
+    }
+    if (fscanf(fp, " input") != EOF) {
+        goto invalid;
+    }
+
+    free(line);
+    fclose(fp);
+    return CKPT_SUCCESS;
+
+invalid:
+    free(line);
+    fclose(fp);
+    errno = EINVAL;
+    return CKPT_FAILURE;
+}
+
+
+void ckpt_source_free(ckpt_source* s)
+{
+    free(s->skip);
+    s->skip = NULL;
+    s->numSkip = 0;
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * FILE: ckpt.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for checkpoints of long runs.
+ *  Names finish out of order, so for each input file the writer tracks the
+ *      highest contiguous name index it has written, plus a bitmap of the
+ *      names written beyond it. Requesters record where each batch ended in
+ *      the input on a ring the writer drains as it writes.
+ *  A checkpoint holds the output length after an fsync and, per input, the
+ *      last batch boundary at or below the contiguous mark, with every name
+ *      past that boundary already written. Resuming seeks (or, for
+ *      compressed input, reads) to the boundary and skips those names, so no
+ *      name is written twice or lost.
+ *
+ ******************************************************************************/
+
+#ifndef CKPT_H
+#define CKPT_H
+
+/* Standard Includes */
+#include <stdio.h>
+
+/* Local Includes */
+#include "ring.h"
+
+
+#define CKPT_FAILURE            -1
+#define CKPT_SUCCESS            0
+
+#define CKPT_WINDOW             65536   // Names in flight per input, at most
+#define CKPT_MARKS_LOG2         12      // Batch boundaries awaiting the writer
+#define CKPT_SUFFIX             ".ckpt"
+#define CKPT_MAGIC              "multi-lookup checkpoint 1"
+
+
+/* Where a batch of input ended */
+typedef struct ckpt_mark_s {
+    unsigned long names;        // Names read before this point
+    long offset;                // Byte offset in the input, -1 if not seekable
+} ckpt_mark;
+
+RING_DEFINE(ckpt_marks, ckpt_mark, CKPT_MARKS_LOG2)
+
+/* Progress through one input file */
+typedef struct ckpt_source_s {
+    /* Writer side, under the output lock */
+    unsigned long next;         // Every name before this one is written
+    unsigned char done[CKPT_WINDOW / 8];    // Names written at or past next
+    ckpt_mark safe;             // Latest mark at or below next
+    ckpt_mark ahead;            // Mark popped but not yet reached
+    int haveAhead;
+    /* Requester side; only the requester pushes */
+    ckpt_marks marks;
+    /* Where to resume, from ckpt_load() */
+    ckpt_mark resume;
+    unsigned long* skip;        // Names past resume already written, ascending
+    int numSkip;
+} ckpt_source;
+
+
+/* Function to start tracking an input from its beginning */
+void ckpt_source_init(ckpt_source* s);
+
+/* Function to record, on the requester side, that names names of the input
+ * have been read, ending at offset */
+void ckpt_mark_input(ckpt_source* s, unsigned long names, long offset);
+
+/* Function to record, on the writer side, that the name with the given
+ * index has been written */
+void ckpt_written(ckpt_source* s, unsigned long index);
+
+/* Function to flush and fsync output, then atomically replace the
+ * checkpoint at path with the progress of every input
+ * Returns CKPT_SUCCESS or CKPT_FAILURE (errno set)
+ */
+int ckpt_save(const char* path, FILE* output, ckpt_source* sources,
+              char* const* paths, int numSources);
+
+/* Function to read the checkpoint at path for the same inputs, setting
+ * each source's resume point and *outputBytes
+ * Returns CKPT_SUCCESS or CKPT_FAILURE (errno set, or EINVAL if the
+ * checkpoint is for other inputs)
+ */
+int ckpt_load(const char* path, long* outputBytes, ckpt_source* sources,
+              char* const* paths, int numSources);
+
+/* Function to free what ckpt_load() allocated */
+void ckpt_source_free(ckpt_source* s);
+
+#endif
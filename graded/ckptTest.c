@@ -0,0 +1,114 @@
+/******************************************************************************
+ * FILE: ckptTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the checkpoints in ckpt.h.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ckpt.h"
+
+#define TEST_BATCH      16      // Names per mark, as the requesters read them
+#define TEST_BATCHES    10000   // Far more marks than the ring holds
+#define TEST_LAG        3       // Batches read ahead of the writer
+#define TEST_PATH       "/tmp/ckptTest.ckpt"
+
+static ckpt_source source;
+static ckpt_source loaded;
+
+
+/* Write a batch's names last to first, as resolvers finish them out of order */
+static void write_batch(ckpt_source* s, unsigned long batch)
+{
+    int i;
+
+    for (i = TEST_BATCH - 1; i >= 0; --i) {
+        ckpt_written(s, batch * TEST_BATCH + i);
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    char* const paths[] = {"names.txt"};
+    FILE* output;
+    long outputBytes;
+    unsigned long batch;
+    int failures = 0;
+
+    if ((output = tmpfile()) == NULL) {
+        perror("error: tmpfile failed");
+        return EXIT_FAILURE;
+    }
+    fputs("output so far\n", output);
+
+    /* The requester stays a few batches ahead while the writer keeps up */
+    ckpt_source_init(&source);
+    for (batch = 0; batch < TEST_BATCHES; ++batch) {
+        ckpt_mark_input(&source, (batch + 1) * TEST_BATCH, (long) (batch + 1) * 100);
+        if (batch >= TEST_LAG) {
+            write_batch(&source, batch - TEST_LAG);
+        }
+    }
+
+    /* Half of the next batch is written past the contiguous mark */
+    ckpt_written(&source, (TEST_BATCHES - TEST_LAG) * TEST_BATCH + 1);
+
+    /* The boundary kept up with the writer, so the checkpoint loads */
+    if (source.safe.names != (TEST_BATCHES - TEST_LAG) * TEST_BATCH) {
+        fprintf(stderr, "error: boundary at %lu names, %lu written\n",
+                source.safe.names, source.next);
+        failures++;
+    }
+    if (ckpt_save(TEST_PATH, output, &source, paths, 1) == CKPT_FAILURE) {
+        perror("error: ckpt_save failed");
+        failures++;
+    }
+    else if (ckpt_load(TEST_PATH, &outputBytes, &loaded, paths, 1) == CKPT_FAILURE) {
+        perror("error: ckpt_load failed");
+        failures++;
+    }
+    else {
+        if (outputBytes != (long) strlen("output so far\n")
+                || loaded.resume.names != source.safe.names
+                || loaded.resume.offset != source.safe.offset
+                || loaded.numSkip != 1 || loaded.skip[0] != source.safe.names + 1) {
+            fprintf(stderr, "error: loaded %lu names at %ld with %d skipped\n",
+                    loaded.resume.names, loaded.resume.offset, loaded.numSkip);
+            failures++;
+        }
+        ckpt_source_free(&loaded);
+    }
+
+    /* A checkpoint for other inputs is refused */
+    if (ckpt_load(TEST_PATH, &outputBytes, &loaded, (char* const[]) {"other.txt"}, 1)
+            != CKPT_FAILURE || errno != EINVAL) {
+        fprintf(stderr, "error: a checkpoint for another input was loaded\n");
+        failures++;
+    }
+    ckpt_source_free(&loaded);
+    unlink(TEST_PATH);
+    fclose(output);
+
+    if (failures) {
+        fprintf(stderr, "%d checkpoint test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All checkpoint tests passed\n");
+
+    return EXIT_SUCCESS;
+}
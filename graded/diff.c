@@ -0,0 +1,317 @@
+/******************************************************************************
+ * FILE: diff.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the previous results index.
+ *  Lines are indexed in place: an entry holds a pointer into the mapping
+ *      and the lengths of the hostname and value, so a results file of any
+ *      size costs 24 bytes and a flag per hostname beyond its mapping.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "diff.h"
+
+
+static unsigned long long diff_hash(const char* text, size_t len)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        hash = (hash ^ (unsigned char) text[i]) * 1099511628211ULL;
+    }
+    return hash | 1;    // 0 marks an empty added slot
+}
+
+
+/* Order entries by hash, then hostname, then position in the file */
+static int diff_compare(const void* a, const void* b)
+{
+    const diff_entry* x = (const diff_entry*) a;
+    const diff_entry* y = (const diff_entry*) b;
+    unsigned int len = x->hostLength < y->hostLength ? x->hostLength : y->hostLength;
+    int rc;
+
+    if (x->hash != y->hash) {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    if ((rc = memcmp(x->line, y->line, len)) != 0) {
+        return rc;
+    }
+    if (x->hostLength != y->hostLength) {
+        return x->hostLength < y->hostLength ? -1 : 1;
+    }
+    return x->line < y->line ? -1 : x->line > y->line;
+}
+
+
+/* Count the lines of the mapping, an upper bound on its entries */
+static size_t diff_count_lines(const char* map, size_t size)
+{
+    const char* end = map + size;
+    const char* p;
+    size_t lines = 0;
+
+    for (p = map; p < end && (p = memchr(p, '\n', end - p)) != NULL; ++p) {
+        lines++;
+    }
+    return lines + 1;
+}
+
+
+/* Build the sorted entries, one per hostname
+ * Returns DIFF_SUCCESS or DIFF_FAILURE (errno set)
+ */
+static int diff_build(diff_index* d)
+{
+    const char* end = d->map + d->size;
+    const char* line;
+    const char* next;
+    const char* comma;
+    diff_entry* e;
+    size_t count = 0;
+    size_t i;
+
+    if ((d->entries = malloc(diff_count_lines(d->map, d->size) * sizeof(*d->entries))) == NULL) {
+        return DIFF_FAILURE;
+    }
+
+    /* Lines without a comma are not results */
+    for (line = d->map; line < end; line = next) {
+        if ((next = memchr(line, '\n', end - line)) == NULL) {
+            next = end;
+        }
+        comma = memchr(line, ',', next - line);
+        if (comma && comma > line) {
+            e = &d->entries[count++];
+            e->line = line;
+            e->hostLength = comma - line;
+            e->valueLength = next - comma - 1;
+            e->hash = diff_hash(line, e->hostLength);
+        }
+        next += next < end;
+    }
+    qsort(d->entries, count, sizeof(*d->entries), diff_compare);
+
+    /* Keep the first line of each hostname, which sorts first */
+    for (i = 0, d->count = 0; i < count; ++i) {
+        if (d->count && d->entries[d->count - 1].hash == d->entries[i].hash
+                && d->entries[d->count - 1].hostLength == d->entries[i].hostLength
+                && !memcmp(d->entries[d->count - 1].line, d->entries[i].line,
+                           d->entries[i].hostLength)) {
+            continue;
+        }
+        d->entries[d->count++] = d->entries[i];
+    }
+    if ((d->seen = calloc(d->count ? d->count : 1, 1)) == NULL) {
+        return DIFF_FAILURE;
+    }
+    return DIFF_SUCCESS;
+}
+
+
+int diff_open(diff_index* d, const char* path)
+{
+    struct stat st;
+    void* map;
+    int err;
+    int fd;
+
+    memset(d, 0, sizeof(*d));
+    pthread_mutex_init(&d->lock, NULL);
+    if ((d->added = calloc(DIFF_ADDED_SLOTS, sizeof(*d->added))) == NULL) {
+        pthread_mutex_destroy(&d->lock);
+        return DIFF_FAILURE;
+    }
+    d->addedSlots = DIFF_ADDED_SLOTS;
+
+    if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &st)) {
+        goto fail;
+    }
+    if (st.st_size > 0) {
+        if ((map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+            goto fail;
+        }
+        d->map = (const char*) map;
+        d->size = st.st_size;
+        madvise(map, d->size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    fd = -1;
+
+    /* gzip and zstd magic: the lines cannot be indexed in place */
+    if ((d->size >= 2 && !memcmp(d->map, "\x1f\x8b", 2))
+            || (d->size >= 4 && !memcmp(d->map, "\x28\xb5\x2f\xfd", 4))) {
+        errno = EINVAL;
+        goto fail;
+    }
+    if (d->size && diff_build(d) == DIFF_FAILURE) {
+        goto fail;
+    }
+    if (d->size) {
+        madvise((void*) d->map, d->size, MADV_RANDOM);
+    }
+    return DIFF_SUCCESS;
+
+fail:
+    err = errno;
+    if (fd >= 0) {
+        close(fd);
+    }
+    diff_close(d);
+    errno = err;
+    return DIFF_FAILURE;
+}
+
+
+/* Find the entry for a hostname
+ * Returns the entry, or NULL if the previous results do not have it
+ */
+static diff_entry* diff_find(diff_index* d, const char* hostname, size_t len,
+                             unsigned long long hash)
+{
+    size_t lo = 0;
+    size_t hi = d->count;
+    size_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (d->entries[mid].hash < hash) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    for (; lo < d->count && d->entries[lo].hash == hash; ++lo) {
+        if (d->entries[lo].hostLength == len && !memcmp(d->entries[lo].line, hostname, len)) {
+            return &d->entries[lo];
+        }
+    }
+    return NULL;
+}
+
+
+/* Add a hostname to the added set with the lock held, growing it as needed
+ * Returns 1 if added, 0 if already there
+ */
+static int diff_add(diff_index* d, const char* hostname, unsigned long long hash)
+{
+    diff_added* slots;
+    size_t mask;
+    size_t i;
+    size_t j;
+
+    /* Keep the set at most half full; without room to grow, keep filling */
+    if (2 * (d->addedCount + 1) > d->addedSlots
+            && (slots = calloc(2 * d->addedSlots, sizeof(*slots))) != NULL) {
+        mask = 2 * d->addedSlots - 1;
+        for (i = 0; i < d->addedSlots; ++i) {
+            if (d->added[i].hash) {
+                for (j = d->added[i].hash & mask; slots[j].hash; j = (j + 1) & mask) {
+                }
+                slots[j] = d->added[i];
+            }
+        }
+        free(d->added);
+        d->added = slots;
+        d->addedSlots *= 2;
+    }
+
+    mask = d->addedSlots - 1;
+    for (i = hash & mask; d->added[i].hash; i = (i + 1) & mask) {
+        if (d->added[i].hash == hash && !strcmp(d->added[i].hostname, hostname)) {
+            return 0;
+        }
+    }
+    /* Out of memory: the name may be reported again, but not lost */
+    if (d->addedCount + 1 < d->addedSlots
+            && (d->added[i].hostname = strdup(hostname)) != NULL) {
+        d->added[i].hash = hash;
+        d->addedCount++;
+    }
+    return 1;
+}
+
+
+int diff_check(diff_index* d, const char* hostname, const char* value)
+{
+    size_t len = strlen(hostname);
+    unsigned long long hash = diff_hash(hostname, len);
+    diff_entry* e;
+    int added;
+
+    if ((e = diff_find(d, hostname, len, hash)) != NULL) {
+        if (__atomic_exchange_n(&d->seen[e - d->entries], 1, __ATOMIC_RELAXED)) {
+            return DIFF_REPEAT;
+        }
+        if (strlen(value) == e->valueLength
+                && !memcmp(e->line + e->hostLength + 1, value, e->valueLength)) {
+            __atomic_fetch_add(&d->numUnchanged, 1, __ATOMIC_RELAXED);
+            return DIFF_UNCHANGED;
+        }
+        __atomic_fetch_add(&d->numChanged, 1, __ATOMIC_RELAXED);
+        return DIFF_CHANGED;
+    }
+
+    pthread_mutex_lock(&d->lock);
+    added = diff_add(d, hostname, hash);
+    pthread_mutex_unlock(&d->lock);
+    if (!added) {
+        return DIFF_REPEAT;
+    }
+    __atomic_fetch_add(&d->numAdded, 1, __ATOMIC_RELAXED);
+    return DIFF_ADDED;
+}
+
+
+int diff_write_removed(diff_index* d, FILE* fp)
+{
+    const diff_entry* e;
+    size_t i;
+
+    for (i = 0; i < d->count; ++i) {
+        if (d->seen[i]) {
+            continue;
+        }
+        e = &d->entries[i];
+        if (fprintf(fp, "-%.*s\n", (int) (e->hostLength + 1 + e->valueLength), e->line) < 0) {
+            return DIFF_FAILURE;
+        }
+        d->numRemoved++;
+    }
+    return DIFF_SUCCESS;
+}
+
+
+void diff_close(diff_index* d)
+{
+    size_t i;
+
+    if (d->map) {
+        munmap((void*) d->map, d->size);
+    }
+    for (i = 0; d->added && i < d->addedSlots; ++i) {
+        free(d->added[i].hostname);
+    }
+    free(d->added);
+    free(d->entries);
+    free(d->seen);
+    pthread_mutex_destroy(&d->lock);
+    d->map = NULL;
+    d->added = NULL;
+    d->entries = NULL;
+    d->seen = NULL;
+    d->count = 0;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ * FILE: diff.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for comparing results, as they are
+ *      written, against a previous run's results file.
+ *  The previous file is mapped read-only and indexed by an array with one
+ *      entry per hostname, pointing into the mapping and sorted by a hash of
+ *      the hostname, so each result is found with a binary search and no
+ *      line is copied. Each entry has a seen flag set by the first result
+ *      for its hostname; entries never seen were removed. Hostnames not in
+ *      the index go in a set of added names, so a name repeated in the input
+ *      is reported once.
+ *  Previous results are "hostname,value" lines, as multi-lookup writes them;
+ *      the first line for a hostname is the one compared against.
+ *
+ ******************************************************************************/
+
+#ifndef DIFF_H
+#define DIFF_H
+
+/* Standard Includes */
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+#define DIFF_FAILURE            -1
+#define DIFF_SUCCESS            0
+
+/* What diff_check() found */
+#define DIFF_UNCHANGED          0
+#define DIFF_ADDED              1       // Not in the previous results
+#define DIFF_CHANGED            2       // In them with another value
+#define DIFF_REPEAT             3       // Already checked this run
+
+#define DIFF_ADDED_SLOTS        1024    // Added set slots, doubled as needed
+
+
+/* One hostname of the previous results */
+typedef struct diff_entry_s {
+    unsigned long long hash;
+    const char* line;           // Start of its line in the mapping
+    unsigned int hostLength;    // Bytes before the comma
+    unsigned int valueLength;   // Bytes after it, before the newline
+} diff_entry;
+
+/* A hostname found only in this run */
+typedef struct diff_added_s {
+    unsigned long long hash;    // 0 for an empty slot
+    char* hostname;
+} diff_added;
+
+typedef struct diff_index_s {
+    const char* map;            // Previous results, NULL if empty
+    size_t size;
+    diff_entry* entries;        // Sorted by hash, then hostname
+    size_t count;
+    unsigned char* seen;        // Per entry, set atomically
+    pthread_mutex_t lock;       // Held for the added set
+    diff_added* added;
+    size_t addedSlots;          // A power of two, kept at most half full
+    size_t addedCount;
+    /* Counts for the summary */
+    unsigned long numAdded;
+    unsigned long numChanged;
+    unsigned long numUnchanged;
+    unsigned long numRemoved;
+} diff_index;
+
+
+/* Function to map and index the previous results at path, which must not
+ * be compressed
+ * Returns DIFF_SUCCESS or DIFF_FAILURE (errno set)
+ */
+int diff_open(diff_index* d, const char* path);
+
+/* Function to compare one result against the previous results; safe to
+ * call from many threads at once
+ * Returns DIFF_UNCHANGED, DIFF_ADDED, DIFF_CHANGED or DIFF_REPEAT
+ */
+int diff_check(diff_index* d, const char* hostname, const char* value);
+
+/* Function to write a "-hostname,value" line to fp for every previous
+ * hostname no result was checked for, once checking has stopped
+ * Returns DIFF_SUCCESS or DIFF_FAILURE (errno set)
+ */
+int diff_write_removed(diff_index* d, FILE* fp);
+
+/* Function to unmap the previous results and free the index */
+void diff_close(diff_index* d);
+
+#endif
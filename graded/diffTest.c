@@ -0,0 +1,191 @@
+/******************************************************************************
+ * FILE: diffTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the previous results index in diff.h.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "diff.h"
+
+#define TEST_THREADS    4
+#define TEST_HOSTS      20000   // In the previous results
+#define TEST_LENGTH     64
+
+/* The first b.com line is the one compared against; the last line has no
+ * newline, and a line without a comma is skipped */
+static const char* previous =
+    "a.com,1.1.1.1\n"
+    "b.com,2.2.2.2\n"
+    "not a result\n"
+    "b.com,9.9.9.9\n"
+    "c.com,\n"
+    "d.com,4.4.4.4";
+
+static diff_index idx;
+
+
+/* Write contents to a new temporary file, whose path goes in path */
+static int write_file(char* path, const char* contents, size_t len)
+{
+    int fd;
+
+    strcpy(path, "/tmp/diffTest.XXXXXX");
+    if ((fd = mkstemp(path)) < 0) {
+        return -1;
+    }
+    if (write(fd, contents, len) != (ssize_t) len) {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    close(fd);
+    return 0;
+}
+
+
+/* Check hosts 0 to 2 * TEST_HOSTS, every thread asking about every host;
+ * odd hosts of the previous results have a new address */
+static void* checker(void* arg)
+{
+    char host[TEST_LENGTH];
+    char value[TEST_LENGTH];
+    long* counts = (long*) arg;     // By diff_check() outcome
+    int i;
+
+    for (i = 0; i < 2 * TEST_HOSTS; ++i) {
+        snprintf(host, sizeof(host), "h%d.example.com", i);
+        snprintf(value, sizeof(value), "10.0.%d.%d", i / 256 % 256, (i % 256) ^ (i & 1));
+        counts[diff_check(&idx, host, value)]++;
+    }
+    return NULL;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    pthread_t threads[TEST_THREADS];
+    long counts[TEST_THREADS][4] = {{0}};
+    long totals[4] = {0};
+    char path[32];
+    char line[TEST_LENGTH];
+    char* text;
+    size_t len = 0;
+    FILE* out;
+    int failures = 0;
+    int i;
+    int j;
+
+    if (write_file(path, previous, strlen(previous)) || diff_open(&idx, path)) {
+        perror("error: diff_open failed");
+        return EXIT_FAILURE;
+    }
+    unlink(path);
+    if (idx.count != 4) {
+        fprintf(stderr, "error: %zu hostnames indexed, expected 4\n", idx.count);
+        failures++;
+    }
+
+    /* Each hostname is reported once, by the first result for it */
+    if (diff_check(&idx, "a.com", "1.1.1.1") != DIFF_UNCHANGED
+            || diff_check(&idx, "b.com", "2.2.2.3") != DIFF_CHANGED
+            || diff_check(&idx, "b.com", "2.2.2.2") != DIFF_REPEAT
+            || diff_check(&idx, "c.com", "") != DIFF_UNCHANGED
+            || diff_check(&idx, "e.com", "5.5.5.5") != DIFF_ADDED
+            || diff_check(&idx, "e.com", "5.5.5.5") != DIFF_REPEAT
+            || diff_check(&idx, "a.co", "1.1.1.1") != DIFF_ADDED) {
+        fprintf(stderr, "error: a result was misreported\n");
+        failures++;
+    }
+
+    /* Only d.com was never checked */
+    if ((out = tmpfile()) == NULL || diff_write_removed(&idx, out) == DIFF_FAILURE) {
+        perror("error: diff_write_removed failed");
+        return EXIT_FAILURE;
+    }
+    rewind(out);
+    if (fgets(line, sizeof(line), out) == NULL || strcmp(line, "-d.com,4.4.4.4\n")
+            || fgets(line, sizeof(line), out) != NULL) {
+        fprintf(stderr, "error: removed lines are wrong\n");
+        failures++;
+    }
+    fclose(out);
+    if (idx.numAdded != 2 || idx.numChanged != 1 || idx.numUnchanged != 2
+            || idx.numRemoved != 1) {
+        fprintf(stderr, "error: counts are %lu added, %lu changed, %lu unchanged, "
+                "%lu removed\n", idx.numAdded, idx.numChanged, idx.numUnchanged,
+                idx.numRemoved);
+        failures++;
+    }
+    diff_close(&idx);
+
+    /* Many threads check the same hosts: each host is reported once, and
+     * the added set grows well past its first size */
+    text = malloc(TEST_HOSTS * TEST_LENGTH);
+    for (i = 0; i < TEST_HOSTS; ++i) {
+        len += sprintf(text + len, "h%d.example.com,10.0.%d.%d\n", i, i / 256 % 256, i % 256);
+    }
+    if (write_file(path, text, len) || diff_open(&idx, path)) {
+        perror("error: diff_open failed");
+        return EXIT_FAILURE;
+    }
+    unlink(path);
+    free(text);
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_create(&threads[i], NULL, checker, counts[i]);
+    }
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+        for (j = 0; j < 4; ++j) {
+            totals[j] += counts[i][j];
+        }
+    }
+    if (totals[DIFF_UNCHANGED] != TEST_HOSTS / 2 || totals[DIFF_CHANGED] != TEST_HOSTS / 2
+            || totals[DIFF_ADDED] != TEST_HOSTS
+            || totals[DIFF_REPEAT] != (TEST_THREADS - 1) * 2 * TEST_HOSTS) {
+        fprintf(stderr, "error: %ld unchanged, %ld changed, %ld added, %ld repeats\n",
+                totals[DIFF_UNCHANGED], totals[DIFF_CHANGED], totals[DIFF_ADDED],
+                totals[DIFF_REPEAT]);
+        failures++;
+    }
+    diff_close(&idx);
+
+    /* Compressed and empty previous results */
+    if (write_file(path, "\x1f\x8b\x08\x00", 4) == 0) {
+        if (diff_open(&idx, path) != DIFF_FAILURE) {
+            fprintf(stderr, "error: compressed previous results were indexed\n");
+            failures++;
+            diff_close(&idx);
+        }
+        unlink(path);
+    }
+    if (write_file(path, "", 0) || diff_open(&idx, path)
+            || diff_check(&idx, "a.com", "1.1.1.1") != DIFF_ADDED) {
+        fprintf(stderr, "error: empty previous results failed\n");
+        failures++;
+    }
+    unlink(path);
+    diff_close(&idx);
+
+    if (failures) {
+        fprintf(stderr, "%d diff test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All diff tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * FILE: dispatch.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of a multi-level (priority class) dispatch queue with
+ *      aging, built from one typed ring per class.
+ *
+ ******************************************************************************/
+
+#include "dispatch.h"
+#include "probes.h"
+
+
+void dispatch_init(dispatch* d, int agingThreshold)
+{
+    int i;
+
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        dispatch_level_init(&d->levels[i]);
+        d->passed[i] = 0;
+    }
+    d->agingThreshold = agingThreshold;
+}
+
+
+int dispatch_is_empty(dispatch* d)
+{
+    int i;
+
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        if (!dispatch_level_is_empty(&d->levels[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+int dispatch_is_full(dispatch* d, int priority)
+{
+    return dispatch_level_is_full(&d->levels[priority]);
+}
+
+
+int dispatch_push(dispatch* d, const lookup_item* item)
+{
+    if (item->priority < 0 || item->priority >= NUM_PRIORITY_CLASSES) {
+        return DISPATCH_FAILURE;
+    }
+    if (dispatch_level_push(&d->levels[item->priority], item) == RING_FAILURE) {
+        return DISPATCH_FAILURE;
+    }
+    PROBE2(queue_push, item->name, item->priority);
+    return DISPATCH_SUCCESS;
+}
+
+
+int dispatch_pop(dispatch* d, lookup_item* item)
+{
+    int i;
+    int level = -1;
+
+    /* A starved lower level takes precedence over the normal class order;
+     * scan from the bottom so the least urgent starving level goes first */
+    for (i = NUM_PRIORITY_CLASSES - 1; i > 0; --i) {
+        if (d->passed[i] >= d->agingThreshold
+                && !dispatch_level_is_empty(&d->levels[i])) {
+            level = i;
+            break;
+        }
+    }
+
+    /* Otherwise serve the most urgent non-empty level */
+    for (i = 0; level < 0 && i < NUM_PRIORITY_CLASSES; ++i) {
+        if (!dispatch_level_is_empty(&d->levels[i])) {
+            level = i;
+        }
+    }
+    if (level < 0) {
+        return DISPATCH_FAILURE;
+    }
+
+    /* Every other backlogged level sat this pop out */
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        if (i == level) {
+            d->passed[i] = 0;
+        }
+        else if (!dispatch_level_is_empty(&d->levels[i])) {
+            d->passed[i]++;
+        }
+    }
+
+    dispatch_level_pop(&d->levels[level], item);
+    PROBE2(queue_pop, item->name, level);
+
+    return DISPATCH_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * FILE: dispatch.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for the multi-level dispatch queue that
+ *      sits between the requester and resolver thread pools.
+ *  Each priority class has its own bounded ring level (see ring.h) holding
+ *      lookup items inline; higher classes are served first, and a backlogged
+ *      lower class that has been passed over too many times is aged up so it
+ *      cannot starve.
+ *  The dispatch queue is not thread safe; callers hold their own lock.
+ *
+ ******************************************************************************/
+
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+/* Local Includes */
+#include "labels.h"
+#include "ring.h"
+
+
+/* Priority classes, most urgent first */
+#define PRIORITY_URGENT         0
+#define PRIORITY_NORMAL         1
+#define PRIORITY_BULK           2
+#define NUM_PRIORITY_CLASSES    3
+
+#define MAX_NAME_LENGTH         256     // Maximum hostname length
+#define DISPATCH_LEVEL_LOG2     10      // Each level holds 1024 items
+
+#define DISPATCH_FAILURE        -1
+#define DISPATCH_SUCCESS        0
+
+
+/* A single hostname travelling from a requester to a resolver */
+typedef struct lookup_item_s {
+    label_handle name;          // The normalized name, in the queue owner's
+                                // label store (see labels.h)
+    int priority;               // PRIORITY_* class the name was read under
+    int source;                 // Index of the input file it came from
+    unsigned long tag;          // Caller's value for the name, see ml_submit()
+    long long deadline;         // CLOCK_MONOTONIC ns, 0 if none
+    long long enqueued;         // CLOCK_MONOTONIC ns when queued
+    int traced;                 // Sampled for a trace span (see trace.h)
+    int requesterTid;           // Set only when traced
+    long long readAt;           // Set only when traced
+} lookup_item;
+
+RING_DEFINE(dispatch_level, lookup_item, DISPATCH_LEVEL_LOG2)
+
+typedef struct dispatch_s {
+    dispatch_level levels[NUM_PRIORITY_CLASSES];
+    int passed[NUM_PRIORITY_CLASSES];   // Pops a backlogged level sat out
+    int agingThreshold;
+} dispatch;
+
+
+/* Function to initialize a new dispatch queue
+ * Every level holds up to dispatch_level_capacity items
+ */
+void dispatch_init(dispatch* d, int agingThreshold);
+
+/* Function to test if every level is empty
+ * Returns 1 if empty, 0 otherwise
+ */
+int dispatch_is_empty(dispatch* d);
+
+/* Function to test if the level for a priority class is full
+ * Returns 1 if full, 0 otherwise
+ */
+int dispatch_is_full(dispatch* d, int priority);
+
+/* Function to copy an item to the end of its priority level
+ * Returns DISPATCH_SUCCESS if the push succeeds
+ * Returns DISPATCH_FAILURE if the level is full or the class is invalid
+ */
+int dispatch_push(dispatch* d, const lookup_item* item);
+
+/* Function to copy out the next item to resolve
+ * Serves the most urgent non-empty level unless a lower level has aged
+ * Returns DISPATCH_FAILURE if every level is empty
+ */
+int dispatch_pop(dispatch* d, lookup_item* item);
+
+#endif
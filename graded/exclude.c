@@ -0,0 +1,311 @@
+/******************************************************************************
+ * FILE: exclude.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of exclusion filters.
+ *  One 64-bit hash of a name does all the work: its low bits pick the
+ *      table slot, a mix of it picks the Bloom filter block, and seven
+ *      9-bit slices of it pick the bits within the block.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exclude.h"
+#include "util.h"
+
+#define EXCLUDE_BLOCK_WORDS     (EXCLUDE_BLOCK_BITS / 64)
+#define EXCLUDE_FIRST_NAMES     (64 * 1024)     // Builder name space, doubled as needed
+#define EXCLUDE_FIRST_OFFSETS   4096            // Builder offsets, doubled as needed
+
+
+static unsigned long long exclude_hash(const char* name)
+{
+    return fnv1a_hash(name) | 1;    // 0 marks an empty slot
+}
+
+
+/* Pick a name's Bloom filter block, independently of its table slot */
+static const unsigned long long* exclude_block(const unsigned long long* bloom,
+                                               unsigned long long blocks,
+                                               unsigned long long hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return bloom + (hash % blocks) * EXCLUDE_BLOCK_WORDS;
+}
+
+
+void exclude_builder_init(exclude_builder* b)
+{
+    memset(b, 0, sizeof(*b));
+}
+
+
+int exclude_builder_add(exclude_builder* b, const char* name)
+{
+    size_t len = strlen(name) + 1;
+    size_t capacity;
+    void* grown;
+
+    if (b->namesBytes + len > b->namesCapacity) {
+        capacity = b->namesCapacity ? b->namesCapacity : EXCLUDE_FIRST_NAMES;
+        while (b->namesBytes + len > capacity) {
+            capacity *= 2;
+        }
+        if ((grown = realloc(b->names, capacity)) == NULL) {
+            return EXCLUDE_FAILURE;
+        }
+        b->names = grown;
+        b->namesCapacity = capacity;
+    }
+    if (b->count == b->capacity) {
+        capacity = b->capacity ? 2 * b->capacity : EXCLUDE_FIRST_OFFSETS;
+        if ((grown = realloc(b->offsets, capacity * sizeof(*b->offsets))) == NULL) {
+            return EXCLUDE_FAILURE;
+        }
+        b->offsets = grown;
+        b->capacity = capacity;
+    }
+    memcpy(b->names + b->namesBytes, name, len);
+    b->offsets[b->count++] = b->namesBytes;
+    b->namesBytes += len;
+    return EXCLUDE_SUCCESS;
+}
+
+
+void exclude_builder_free(exclude_builder* b)
+{
+    free(b->names);
+    free(b->offsets);
+    exclude_builder_init(b);
+}
+
+
+/* Point the filter's sections into its image */
+static void exclude_layout(exclude_filter* f)
+{
+    f->header = (const exclude_header*) f->image;
+    f->bloom = (const unsigned long long*) (f->image + sizeof(exclude_header));
+    f->table = (const exclude_slot*) (f->bloom + f->header->blocks * EXCLUDE_BLOCK_WORDS);
+    f->names = (const char*) (f->table + f->header->slots);
+}
+
+
+int exclude_build(exclude_builder* b, exclude_filter* f)
+{
+    exclude_header* header;
+    unsigned long long* bloom;
+    unsigned long long* block;
+    exclude_slot* table;
+    char* names;
+    unsigned long long hash;
+    unsigned long long slots = 1;
+    unsigned long long blocks;
+    size_t namesBytes = 0;
+    size_t mask;
+    size_t i;
+    size_t j;
+    const char* name;
+    int k;
+
+    memset(f, 0, sizeof(*f));
+
+    /* Keep the table at most half full */
+    while (slots < 2 * b->count) {
+        slots *= 2;
+    }
+    blocks = (b->count * EXCLUDE_BITS_PER_NAME + EXCLUDE_BLOCK_BITS - 1) / EXCLUDE_BLOCK_BITS;
+    if (blocks == 0) {
+        blocks = 1;
+    }
+    f->size = sizeof(exclude_header) + blocks * EXCLUDE_BLOCK_BITS / 8
+        + slots * sizeof(exclude_slot) + b->namesBytes;
+    if ((f->image = calloc(1, f->size)) == NULL) {
+        return EXCLUDE_FAILURE;
+    }
+    header = (exclude_header*) f->image;
+    memcpy(header->magic, EXCLUDE_MAGIC, sizeof(header->magic));
+    header->blocks = blocks;
+    header->slots = slots;
+    bloom = (unsigned long long*) (f->image + sizeof(exclude_header));
+    table = (exclude_slot*) (bloom + blocks * EXCLUDE_BLOCK_WORDS);
+    names = (char*) (table + slots);
+
+    /* Copy each distinct name once, setting its bits and its slot */
+    mask = slots - 1;
+    for (i = 0; i < b->count; ++i) {
+        name = b->names + b->offsets[i];
+        hash = exclude_hash(name);
+        for (j = hash & mask; table[j].hash; j = (j + 1) & mask) {
+            if (table[j].hash == hash && !strcmp(names + table[j].offset, name)) {
+                break;
+            }
+        }
+        if (table[j].hash) {
+            continue;
+        }
+        table[j].hash = hash;
+        table[j].offset = namesBytes;
+        strcpy(names + namesBytes, name);
+        namesBytes += strlen(name) + 1;
+        header->names++;
+
+        block = (unsigned long long*) exclude_block(bloom, blocks, hash);
+        for (k = 0; k < EXCLUDE_PROBES; ++k) {
+            j = (hash >> (9 * k)) & (EXCLUDE_BLOCK_BITS - 1);
+            block[j / 64] |= 1ULL << (j % 64);
+        }
+    }
+    header->namesBytes = namesBytes;
+    f->size -= b->namesBytes - namesBytes;
+    exclude_builder_free(b);
+    exclude_layout(f);
+    return EXCLUDE_SUCCESS;
+}
+
+
+int exclude_save(const exclude_filter* f, const char* path)
+{
+    FILE* fp;
+    int err;
+
+    if ((fp = fopen(path, "wb")) == NULL) {
+        return EXCLUDE_FAILURE;
+    }
+    if (fwrite(f->image, 1, f->size, fp) != f->size) {
+        err = errno;
+        fclose(fp);
+        errno = err;
+        return EXCLUDE_FAILURE;
+    }
+    return fclose(fp) ? EXCLUDE_FAILURE : EXCLUDE_SUCCESS;
+}
+
+
+int exclude_is_image(const char* path)
+{
+    char magic[8];
+    FILE* fp;
+    int rc;
+
+    if ((fp = fopen(path, "rb")) == NULL) {
+        return 0;
+    }
+    rc = fread(magic, 1, sizeof(magic), fp) == sizeof(magic)
+        && !memcmp(magic, EXCLUDE_MAGIC, sizeof(magic));
+    fclose(fp);
+    return rc;
+}
+
+
+int exclude_load(exclude_filter* f, const char* path)
+{
+    const exclude_header* h;
+    struct stat st;
+    void* map;
+    int err;
+    int fd;
+
+    memset(f, 0, sizeof(*f));
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        return EXCLUDE_FAILURE;
+    }
+    if (fstat(fd, &st)) {
+        goto fail;
+    }
+    if ((size_t) st.st_size < sizeof(exclude_header)) {
+        errno = EINVAL;
+        goto fail;
+    }
+    if ((map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        goto fail;
+    }
+    close(fd);
+    fd = -1;
+    f->image = map;
+    f->size = st.st_size;
+    f->mapped = 1;
+
+    /* The sections must add up to the file, with the names terminated;
+     * each is bounded by the file first so the sum cannot wrap */
+    h = (const exclude_header*) map;
+    if (memcmp(h->magic, EXCLUDE_MAGIC, sizeof(h->magic)) || h->blocks == 0
+            || h->slots == 0 || (h->slots & (h->slots - 1)) || h->names >= h->slots
+            || h->blocks > f->size / (EXCLUDE_BLOCK_BITS / 8)
+            || h->slots > f->size / sizeof(exclude_slot)
+            || h->namesBytes > f->size
+            || f->size != sizeof(exclude_header) + h->blocks * (EXCLUDE_BLOCK_BITS / 8)
+                          + h->slots * sizeof(exclude_slot) + h->namesBytes
+            || (h->namesBytes && f->image[f->size - 1] != '\0')) {
+        errno = EINVAL;
+        goto fail;
+    }
+    exclude_layout(f);
+
+    /* Every name checked touches the Bloom filter; few reach the table */
+    madvise(f->image, sizeof(exclude_header) + h->blocks * (EXCLUDE_BLOCK_BITS / 8),
+            MADV_WILLNEED);
+    return EXCLUDE_SUCCESS;
+
+fail:
+    err = errno;
+    if (fd >= 0) {
+        close(fd);
+    }
+    exclude_free(f);
+    errno = err;
+    return EXCLUDE_FAILURE;
+}
+
+
+int exclude_match(exclude_filter* f, const char* name)
+{
+    unsigned long long hash = exclude_hash(name);
+    const unsigned long long* block;
+    size_t mask = f->header->slots - 1;
+    size_t j;
+    int k;
+
+    __atomic_fetch_add(&f->checked, 1, __ATOMIC_RELAXED);
+    block = exclude_block(f->bloom, f->header->blocks, hash);
+    for (k = 0; k < EXCLUDE_PROBES; ++k) {
+        j = (hash >> (9 * k)) & (EXCLUDE_BLOCK_BITS - 1);
+        if (!(block[j / 64] & (1ULL << (j % 64)))) {
+            return 0;
+        }
+    }
+    __atomic_fetch_add(&f->bloomHits, 1, __ATOMIC_RELAXED);
+
+    for (j = hash & mask; f->table[j].hash; j = (j + 1) & mask) {
+        if (f->table[j].hash == hash && f->table[j].offset < f->header->namesBytes
+                && !strcmp(f->names + f->table[j].offset, name)) {
+            __atomic_fetch_add(&f->matches, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+void exclude_free(exclude_filter* f)
+{
+    if (f->mapped) {
+        munmap(f->image, f->size);
+    }
+    else {
+        free(f->image);
+    }
+    memset(f, 0, sizeof(*f));
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * FILE: exclude.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for exclusion filters: sets of hostnames
+ *      that are never looked up, such as names known not to exist and
+ *      blocklisted names.
+ *  A filter is one flat image, so it can be written to a file once and
+ *      mapped read-only at startup without parsing, however many names it
+ *      holds. The image is a header, a blocked Bloom filter, an open
+ *      addressed table of name hashes and offsets, and the names
+ *      themselves. A lookup checks the Bloom filter first, touching one
+ *      64-byte block, so most names not in the set cost one cache miss; a
+ *      name that passes is confirmed against the table and the stored name,
+ *      so a Bloom false positive is never excluded.
+ *  Images are in the byte order of the machine that built them.
+ *  Matching is thread safe; building is not.
+ *
+ ******************************************************************************/
+
+#ifndef EXCLUDE_H
+#define EXCLUDE_H
+
+/* Standard Includes */
+#include <stddef.h>
+
+
+#define EXCLUDE_FAILURE         -1
+#define EXCLUDE_SUCCESS         0
+
+#define EXCLUDE_MAGIC           "MLXCLD1"       // Eight bytes with the NUL
+#define EXCLUDE_BLOCK_BITS      512             // Bloom filter block, one cache line
+#define EXCLUDE_BITS_PER_NAME   10              // About 1% false positives
+#define EXCLUDE_PROBES          7               // Bits set per name
+
+
+/* Start of a filter image */
+typedef struct exclude_header_s {
+    char magic[8];              // EXCLUDE_MAGIC
+    unsigned long long names;   // Distinct names
+    unsigned long long blocks;  // Bloom filter blocks
+    unsigned long long slots;   // Table slots, a power of two
+    unsigned long long namesBytes;
+    unsigned long long reserved[3];
+} exclude_header;
+
+/* A table slot: a name's hash and where the name starts */
+typedef struct exclude_slot_s {
+    unsigned long long hash;    // 0 for an empty slot
+    unsigned long long offset;  // Into the names
+} exclude_slot;
+
+typedef struct exclude_filter_s {
+    unsigned char* image;
+    size_t size;
+    int mapped;                 // image is a file mapping, not malloc'd
+    const exclude_header* header;
+    const unsigned long long* bloom;    // EXCLUDE_BLOCK_BITS / 64 words a block
+    const exclude_slot* table;
+    const char* names;          // NUL-terminated, back to back
+    /* Counts for the summary, updated atomically */
+    unsigned long checked;
+    unsigned long bloomHits;    // Passed the Bloom filter
+    unsigned long matches;      // Confirmed in the table
+} exclude_filter;
+
+/* Names collected for a filter */
+typedef struct exclude_builder_s {
+    char* names;
+    size_t namesBytes;
+    size_t namesCapacity;
+    size_t* offsets;            // Of each name added, duplicates included
+    size_t count;
+    size_t capacity;
+} exclude_builder;
+
+
+/* Function to start collecting names for a filter */
+void exclude_builder_init(exclude_builder* b);
+
+/* Function to add a name, already normalized, to the filter being built
+ * Returns EXCLUDE_SUCCESS or EXCLUDE_FAILURE (errno set)
+ */
+int exclude_builder_add(exclude_builder* b, const char* name);
+
+/* Function to build a filter from the names collected, which are freed
+ * Returns EXCLUDE_SUCCESS or EXCLUDE_FAILURE (errno set)
+ */
+int exclude_build(exclude_builder* b, exclude_filter* f);
+
+/* Function to free the names collected without building a filter */
+void exclude_builder_free(exclude_builder* b);
+
+/* Function to write a filter's image to path
+ * Returns EXCLUDE_SUCCESS or EXCLUDE_FAILURE (errno set)
+ */
+int exclude_save(const exclude_filter* f, const char* path);
+
+/* Function to test if the file at path starts with EXCLUDE_MAGIC
+ * Returns 1 if it does, 0 if not or if it cannot be read
+ */
+int exclude_is_image(const char* path);
+
+/* Function to map a filter image written by exclude_save()
+ * Returns EXCLUDE_SUCCESS, or EXCLUDE_FAILURE (errno set, EINVAL if the
+ * file is not a whole filter image)
+ */
+int exclude_load(exclude_filter* f, const char* path);
+
+/* Function to test if a normalized name is in the filter
+ * Returns 1 if it is, 0 otherwise
+ */
+int exclude_match(exclude_filter* f, const char* name);
+
+/* Function to free or unmap a filter */
+void exclude_free(exclude_filter* f);
+
+#endif
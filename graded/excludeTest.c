@@ -0,0 +1,168 @@
+/******************************************************************************
+ * FILE: excludeTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the exclusion filters in exclude.h.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "exclude.h"
+
+#define TEST_NAMES      100000  // In the filter, each added twice
+#define TEST_OTHERS     100000  // Never added
+#define TEST_LENGTH     64
+
+
+/* Check every member matches and no other name does
+ * Returns the number of mistakes
+ */
+static int check(exclude_filter* f, const char* what)
+{
+    char name[TEST_LENGTH];
+    unsigned long falsePositives;
+    int wrong = 0;
+    int i;
+
+    for (i = 0; i < TEST_NAMES; ++i) {
+        snprintf(name, sizeof(name), "dead%d.example.com", i);
+        wrong += !exclude_match(f, name);
+    }
+    for (i = 0; i < TEST_OTHERS; ++i) {
+        snprintf(name, sizeof(name), "live%d.example.com", i);
+        wrong += exclude_match(f, name);
+    }
+    if (wrong) {
+        fprintf(stderr, "error: %s filter got %d names wrong\n", what, wrong);
+    }
+
+    /* Bloom false positives are confirmed away, but should stay rare */
+    falsePositives = f->bloomHits - f->matches;
+    if (f->matches != TEST_NAMES || falsePositives > TEST_OTHERS / 50) {
+        fprintf(stderr, "error: %s filter matched %lu, %lu Bloom false positives\n",
+                what, f->matches, falsePositives);
+        wrong++;
+    }
+    return wrong;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    exclude_builder builder;
+    exclude_header header;
+    exclude_filter filter;
+    exclude_filter loaded;
+    char name[TEST_LENGTH];
+    char path[32];
+    FILE* fp;
+    int failures = 0;
+    int fd;
+    int i;
+
+    /* Duplicates are stored once */
+    exclude_builder_init(&builder);
+    for (i = 0; i < 2 * TEST_NAMES; ++i) {
+        snprintf(name, sizeof(name), "dead%d.example.com", i % TEST_NAMES);
+        if (exclude_builder_add(&builder, name) == EXCLUDE_FAILURE) {
+            perror("error: exclude_builder_add failed");
+            return EXIT_FAILURE;
+        }
+    }
+    if (exclude_build(&builder, &filter) == EXCLUDE_FAILURE) {
+        perror("error: exclude_build failed");
+        return EXIT_FAILURE;
+    }
+    if (filter.header->names != TEST_NAMES) {
+        fprintf(stderr, "error: %llu names stored, expected %d\n",
+                filter.header->names, TEST_NAMES);
+        failures++;
+    }
+    failures += check(&filter, "built") != 0;
+
+    /* A saved image maps back to the same filter */
+    strcpy(path, "/tmp/excludeTest.XXXXXX");
+    if ((fd = mkstemp(path)) < 0) {
+        perror("error: mkstemp failed");
+        return EXIT_FAILURE;
+    }
+    close(fd);
+    if (exclude_save(&filter, path) == EXCLUDE_FAILURE || !exclude_is_image(path)
+            || exclude_load(&loaded, path) == EXCLUDE_FAILURE) {
+        perror("error: saving and loading the filter failed");
+        failures++;
+    }
+    else {
+        failures += check(&loaded, "loaded") != 0;
+        exclude_free(&loaded);
+    }
+
+    /* A cut short image is refused */
+    if (truncate(path, filter.size - 1) || exclude_load(&loaded, path) != EXCLUDE_FAILURE
+            || errno != EINVAL) {
+        fprintf(stderr, "error: a truncated image was loaded\n");
+        failures++;
+    }
+
+    /* Sections that only add up to the file by wrapping around are refused */
+    header = *filter.header;
+    header.blocks = filter.size / (EXCLUDE_BLOCK_BITS / 8);
+    header.namesBytes = filter.size - sizeof(header) - header.blocks * (EXCLUDE_BLOCK_BITS / 8)
+                        - header.slots * sizeof(exclude_slot);
+    if (exclude_save(&filter, path) == EXCLUDE_FAILURE || (fp = fopen(path, "r+")) == NULL) {
+        perror("error: saving the filter failed");
+        failures++;
+    }
+    else {
+        fwrite(&header, sizeof(header), 1, fp);
+        fclose(fp);
+        if (exclude_load(&loaded, path) != EXCLUDE_FAILURE || errno != EINVAL) {
+            fprintf(stderr, "error: an image with %llu name bytes was loaded\n",
+                    header.namesBytes);
+            exclude_free(&loaded);
+            failures++;
+        }
+    }
+    exclude_free(&filter);
+
+    /* A name list is not an image */
+    if ((fp = fopen(path, "w")) != NULL) {
+        fputs("dead0.example.com\n", fp);
+        fclose(fp);
+    }
+    if (exclude_is_image(path) || exclude_load(&loaded, path) != EXCLUDE_FAILURE) {
+        fprintf(stderr, "error: a name list was taken for an image\n");
+        failures++;
+    }
+    unlink(path);
+
+    /* An empty filter matches nothing */
+    exclude_builder_init(&builder);
+    if (exclude_build(&builder, &filter) == EXCLUDE_FAILURE
+            || exclude_match(&filter, "dead0.example.com")) {
+        fprintf(stderr, "error: an empty filter matched\n");
+        failures++;
+    }
+    exclude_free(&filter);
+
+    if (failures) {
+        fprintf(stderr, "%d exclude test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All exclude tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,560 @@
+/******************************************************************************
+ * FILE: extsort.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the external merge sort.
+ *  A thread's buffer is one block: line text grows up from the start and
+ *      pointers to the lines grow down from the end, so the block is full
+ *      when they meet. The first time a thread adds a line its buffer is
+ *      linked onto the sort's list with one compare-and-swap, as in agg.c.
+ *  The loser tree keeps, for each internal node, the input that lost the
+ *      match played there; node 0 holds the overall winner. Replacing the
+ *      winner's line replays only the matches on its path to the root.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "extsort.h"
+
+
+/* One adding thread's lines */
+typedef struct extsort_buffer_s {
+    struct extsort_buffer_s* next;
+    char* block;
+    char* text;                 // End of the line text
+    char** lines;               // First line pointer, growing down
+} extsort_buffer;
+
+/* A run being read during a merge */
+typedef struct extsort_input_s {
+    FILE* fp;
+    char* buf;                  // stdio buffer
+    int done;
+    char line[EXTSORT_MAX_LINE];
+} extsort_input;
+
+/* The groups of runs merged by one pass */
+typedef struct extsort_pass_s {
+    extsort* s;
+    char** runs;                // This pass's runs, the first numGroups * fanIn
+                                // of them in groups of fanIn
+    int numRuns;
+    char** merged;              // One output run per group
+    int numGroups;
+    int next;                   // Next group to merge, taken atomically
+} extsort_pass;
+
+
+static unsigned long nextSortId = 1;
+/* The calling thread's buffer, valid only while localId is the sort's ID, so
+ * a buffer freed with an earlier sort is never looked at */
+static __thread unsigned long localId = 0;
+static __thread extsort_buffer* local = NULL;
+
+
+static int extsort_compare(const void* a, const void* b)
+{
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+
+/* Record the first failure; later ones are usually its consequences */
+static void extsort_fail(extsort* s, int err)
+{
+    pthread_mutex_lock(&s->lock);
+    if (!s->failed) {
+        s->failed = err ? err : EIO;
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+
+static void extsort_temp_add(extsort* s, long long bytes)
+{
+    pthread_mutex_lock(&s->lock);
+    s->tempBytes += bytes;
+    if (s->tempBytes > s->peakTempBytes) {
+        s->peakTempBytes = s->tempBytes;
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+
+/* Name a new run file
+ * Returns its path, or NULL if out of memory
+ */
+static char* extsort_run_path(extsort* s)
+{
+    char path[sizeof(s->dir) + 32];
+    unsigned long id;
+
+    pthread_mutex_lock(&s->lock);
+    id = s->nextRun++;
+    pthread_mutex_unlock(&s->lock);
+    snprintf(path, sizeof(path), "%s/run-%06lu", s->dir, id);
+    return strdup(path);
+}
+
+
+/* Add a written run to the list of runs to merge
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE
+ */
+static int extsort_push_run(extsort* s, char* path)
+{
+    char** grown;
+    int rc = EXTSORT_SUCCESS;
+
+    pthread_mutex_lock(&s->lock);
+    if (s->numRuns == s->runCap) {
+        if ((grown = realloc(s->runs, (s->runCap ? 2 * s->runCap : 64) * sizeof(*grown)))
+                == NULL) {
+            rc = EXTSORT_FAILURE;
+        }
+        else {
+            s->runs = grown;
+            s->runCap = s->runCap ? 2 * s->runCap : 64;
+        }
+    }
+    if (rc == EXTSORT_SUCCESS) {
+        s->runs[s->numRuns++] = path;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return rc;
+}
+
+
+static void extsort_unlink(extsort* s, const char* path)
+{
+    struct stat st;
+
+    if (stat(path, &st) == 0) {
+        extsort_temp_add(s, -(long long) st.st_size);
+    }
+    unlink(path);
+}
+
+
+/* Sort a buffer's lines, write them as a run and empty the buffer
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE (errno set)
+ */
+static int extsort_spill(extsort* s, extsort_buffer* b)
+{
+    char** end = (char**) (b->block + s->runBytes);
+    size_t count = end - b->lines;
+    char* path;
+    char* io;
+    FILE* fp;
+    long bytes;
+    size_t i;
+
+    if (count == 0) {
+        return EXTSORT_SUCCESS;
+    }
+    qsort(b->lines, count, sizeof(*b->lines), extsort_compare);
+
+    if ((path = extsort_run_path(s)) == NULL || (io = malloc(EXTSORT_IO_BUFFER)) == NULL) {
+        free(path);
+        return EXTSORT_FAILURE;
+    }
+    if ((fp = fopen(path, "w")) == NULL) {
+        free(io);
+        free(path);
+        return EXTSORT_FAILURE;
+    }
+    setvbuf(fp, io, _IOFBF, EXTSORT_IO_BUFFER);
+    for (i = 0; i < count; ++i) {
+        fputs(b->lines[i], fp);
+        putc('\n', fp);
+    }
+    bytes = ftell(fp);
+    if (fclose(fp)) {
+        free(io);
+        unlink(path);
+        free(path);
+        return EXTSORT_FAILURE;
+    }
+    free(io);
+
+    extsort_temp_add(s, bytes);
+    if (extsort_push_run(s, path) == EXTSORT_FAILURE) {
+        unlink(path);
+        free(path);
+        return EXTSORT_FAILURE;
+    }
+    __atomic_fetch_add(&s->runsWritten, 1, __ATOMIC_RELAXED);
+
+    b->text = b->block;
+    b->lines = end;
+    return EXTSORT_SUCCESS;
+}
+
+
+int extsort_init(extsort* s, const char* path, size_t runBytes, int fanIn,
+                 int threads)
+{
+    memset(s, 0, sizeof(*s));
+    snprintf(s->dir, sizeof(s->dir), EXTSORT_DIR_NAME, path);
+    if (mkdtemp(s->dir) == NULL) {
+        s->dir[0] = '\0';
+        return EXTSORT_FAILURE;
+    }
+    s->id = __atomic_fetch_add(&nextSortId, 1, __ATOMIC_RELAXED);
+    s->runBytes = runBytes < EXTSORT_MIN_RUN ? EXTSORT_MIN_RUN : runBytes;
+    s->runBytes -= s->runBytes % sizeof(char*);
+    s->fanIn = fanIn < EXTSORT_MIN_FAN_IN ? EXTSORT_MIN_FAN_IN
+        : fanIn > EXTSORT_MAX_FAN_IN ? EXTSORT_MAX_FAN_IN : fanIn;
+    s->threads = threads < 1 ? 1 : threads > EXTSORT_MAX_THREADS ? EXTSORT_MAX_THREADS : threads;
+    pthread_mutex_init(&s->lock, NULL);
+    return EXTSORT_SUCCESS;
+}
+
+
+/* The calling thread's buffer for s, linked onto s's list on first use */
+static extsort_buffer* extsort_buffer_get(extsort* s)
+{
+    extsort_buffer* b;
+
+    if (localId == s->id) {
+        return local;
+    }
+    if ((b = calloc(1, sizeof(*b))) == NULL) {
+        return NULL;
+    }
+    if ((b->block = malloc(s->runBytes)) == NULL) {
+        free(b);
+        return NULL;
+    }
+    b->text = b->block;
+    b->lines = (char**) (b->block + s->runBytes);
+    b->next = __atomic_load_n(&s->buffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&s->buffers, &b->next, b, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+    local = b;
+    localId = s->id;
+    return b;
+}
+
+
+int extsort_add(extsort* s, const char* line, size_t len)
+{
+    extsort_buffer* b = extsort_buffer_get(s);
+
+    if (b == NULL) {
+        extsort_fail(s, ENOMEM);
+        return EXTSORT_FAILURE;
+    }
+    if (len + 2 > EXTSORT_MAX_LINE || memchr(line, '\n', len)) {
+        errno = EINVAL;
+        return EXTSORT_FAILURE;
+    }
+
+    /* Spill When the Text Would Run Into the Pointers */
+    if (b->text + len + 1 > (char*) (b->lines - 1)) {
+        if (extsort_spill(s, b) == EXTSORT_FAILURE) {
+            extsort_fail(s, errno);
+            return EXTSORT_FAILURE;
+        }
+    }
+    memcpy(b->text, line, len);
+    b->text[len] = '\0';
+    *--b->lines = b->text;
+    b->text += len + 1;
+    return EXTSORT_SUCCESS;
+}
+
+
+/* Read an input's next line, marking it done at the end */
+static void extsort_next(extsort_input* in)
+{
+    if (!in->done && fgets(in->line, sizeof(in->line), in->fp) == NULL) {
+        in->done = 1;
+    }
+}
+
+
+/* Whether input a's line comes before input b's; k stands for a line before
+ * every other, and a finished input for one after every other */
+static int extsort_before(const extsort_input* in, int k, int a, int b)
+{
+    int cmp;
+
+    if (a == k || b == k) {
+        return a == k;
+    }
+    if (in[a].done || in[b].done) {
+        return !in[a].done;
+    }
+    cmp = strcmp(in[a].line, in[b].line);
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+
+/* Replay the matches from input w's leaf up to the root */
+static void extsort_replay(const extsort_input* in, int* tree, int k, int w)
+{
+    int t;
+    int swap;
+
+    for (t = (w + k) / 2; t > 0; t /= 2) {
+        if (extsort_before(in, k, tree[t], w)) {
+            swap = tree[t];
+            tree[t] = w;
+            w = swap;
+        }
+    }
+    tree[0] = w;
+}
+
+
+/* Merge k runs into out through a loser tree
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE (errno set)
+ */
+static int extsort_merge(char** runs, int k, FILE* out)
+{
+    extsort_input* in;
+    int* tree;
+    int rc = EXTSORT_SUCCESS;
+    int i;
+    int w;
+
+    if ((in = calloc(k, sizeof(*in))) == NULL
+            || (tree = malloc(k * sizeof(*tree))) == NULL) {
+        free(in);
+        return EXTSORT_FAILURE;
+    }
+    for (i = 0; i < k; ++i) {
+        if ((in[i].fp = fopen(runs[i], "r")) == NULL) {
+            rc = EXTSORT_FAILURE;
+            in[i].done = 1;
+            continue;
+        }
+        if ((in[i].buf = malloc(EXTSORT_IO_BUFFER)) != NULL) {
+            setvbuf(in[i].fp, in[i].buf, _IOFBF, EXTSORT_IO_BUFFER);
+        }
+        extsort_next(&in[i]);
+    }
+
+    /* Build the Tree: Every Node Starts Held by the Phantom Leaf k, Which
+     * Loses Its Place as the Real Leaves Are Played In */
+    for (i = 0; i < k; ++i) {
+        tree[i] = k;
+    }
+    for (i = k - 1; i >= 0; --i) {
+        extsort_replay(in, tree, k, i);
+    }
+
+    /* Write the Winner and Replace It With Its Input's Next Line */
+    while (rc == EXTSORT_SUCCESS && !in[w = tree[0]].done) {
+        if (fputs(in[w].line, out) == EOF) {
+            rc = EXTSORT_FAILURE;
+        }
+        extsort_next(&in[w]);
+        extsort_replay(in, tree, k, w);
+    }
+
+    for (i = 0; i < k; ++i) {
+        if (in[i].fp) {
+            if (ferror(in[i].fp)) {
+                rc = EXTSORT_FAILURE;
+            }
+            fclose(in[i].fp);
+        }
+        free(in[i].buf);
+    }
+    free(tree);
+    free(in);
+    return rc;
+}
+
+
+/* Merging thread: merge groups of the pass until none are left */
+static void* extsort_merger(void* arg)
+{
+    extsort_pass* pass = (extsort_pass*) arg;
+    extsort* s = pass->s;
+    char* io;
+    FILE* fp;
+    long bytes;
+    int first;
+    int k;
+    int g;
+    int i;
+
+    while ((g = __atomic_fetch_add(&pass->next, 1, __ATOMIC_RELAXED)) < pass->numGroups) {
+        first = g * s->fanIn;
+        k = pass->numRuns - first < s->fanIn ? pass->numRuns - first : s->fanIn;
+        io = malloc(EXTSORT_IO_BUFFER);
+        if ((pass->merged[g] = extsort_run_path(s)) == NULL
+                || (fp = fopen(pass->merged[g], "w")) == NULL) {
+            extsort_fail(s, errno);
+            free(io);
+            continue;
+        }
+        if (io) {
+            setvbuf(fp, io, _IOFBF, EXTSORT_IO_BUFFER);
+        }
+        if (extsort_merge(pass->runs + first, k, fp) == EXTSORT_FAILURE) {
+            extsort_fail(s, errno);
+        }
+        bytes = ftell(fp);
+        if (fclose(fp)) {
+            extsort_fail(s, errno);
+        }
+        free(io);
+        extsort_temp_add(s, bytes);
+
+        /* A Group's Runs Go as Soon as They Are Merged */
+        for (i = first; i < first + k; ++i) {
+            extsort_unlink(s, pass->runs[i]);
+            free(pass->runs[i]);
+            pass->runs[i] = NULL;
+        }
+    }
+    return NULL;
+}
+
+
+/* Merge runs fanIn at a time, only as many groups as it takes to leave
+ * fanIn runs for the last pass; the rest are carried over uncopied
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE (errno set)
+ */
+static int extsort_pass_run(extsort* s)
+{
+    extsort_pass pass;
+    pthread_t tids[EXTSORT_MAX_THREADS];
+    int numThreads;
+    int needed;
+    int carried;
+    int i;
+
+    pass.s = s;
+    pass.runs = s->runs;
+    pass.numRuns = s->numRuns;
+    pass.numGroups = (s->numRuns + s->fanIn - 1) / s->fanIn;
+    needed = (s->numRuns - s->fanIn + s->fanIn - 2) / (s->fanIn - 1);
+    if (needed < pass.numGroups) {
+        pass.numGroups = needed;
+    }
+    else if (s->numRuns % s->fanIn == 1) {
+        pass.numGroups--;       // A group of one would only be copied
+    }
+    /* The last group may be partial, so the merged runs end at numRuns */
+    carried = pass.numGroups * s->fanIn;
+    if (carried > pass.numRuns) {
+        carried = pass.numRuns;
+    }
+    pass.next = 0;
+    if ((pass.merged = calloc(pass.numGroups, sizeof(*pass.merged))) == NULL) {
+        extsort_fail(s, ENOMEM);
+        return EXTSORT_FAILURE;
+    }
+
+    numThreads = pass.numGroups < s->threads ? pass.numGroups : s->threads;
+    for (i = 0; i < numThreads; ++i) {
+        if (pthread_create(&tids[i], NULL, extsort_merger, &pass)) {
+            break;
+        }
+    }
+    if (i == 0) {
+        extsort_merger(&pass);
+    }
+    numThreads = i;
+    for (i = 0; i < numThreads; ++i) {
+        pthread_join(tids[i], NULL);
+    }
+
+    /* The Merged and Carried Runs Are the Next Pass's Input; Runs Left Over
+     * From a Failed Group Are Lost Anyway */
+    for (i = 0; i < carried; ++i) {
+        if (pass.runs[i]) {
+            extsort_unlink(s, pass.runs[i]);
+            free(pass.runs[i]);
+        }
+    }
+    s->numRuns = 0;
+    for (i = 0; i < pass.numGroups; ++i) {
+        if (pass.merged[i]) {
+            s->runs[s->numRuns++] = pass.merged[i];
+        }
+    }
+    for (i = carried; i < pass.numRuns; ++i) {
+        s->runs[s->numRuns++] = pass.runs[i];
+    }
+    free(pass.merged);
+    s->passes++;
+
+    if (s->failed) {
+        errno = s->failed;
+        return EXTSORT_FAILURE;
+    }
+    return EXTSORT_SUCCESS;
+}
+
+
+int extsort_finish(extsort* s, FILE* out)
+{
+    extsort_buffer* b;
+    int i;
+
+    /* Write Out What the Buffers Hold */
+    for (b = s->buffers; b != NULL; b = b->next) {
+        if (extsort_spill(s, b) == EXTSORT_FAILURE) {
+            extsort_fail(s, errno);
+        }
+    }
+
+    /* Merge Down to fanIn Runs, Then Into the Output */
+    while (!s->failed && s->numRuns > s->fanIn) {
+        extsort_pass_run(s);
+    }
+    if (!s->failed && s->numRuns > 0) {
+        if (extsort_merge(s->runs, s->numRuns, out) == EXTSORT_FAILURE) {
+            extsort_fail(s, errno);
+        }
+        s->passes++;
+    }
+    for (i = 0; i < s->numRuns; ++i) {
+        extsort_unlink(s, s->runs[i]);
+        free(s->runs[i]);
+    }
+    s->numRuns = 0;
+
+    if (s->failed) {
+        errno = s->failed;
+        return EXTSORT_FAILURE;
+    }
+    return EXTSORT_SUCCESS;
+}
+
+
+void extsort_free(extsort* s)
+{
+    extsort_buffer* b;
+    extsort_buffer* next;
+    int i;
+
+    for (b = s->buffers; b != NULL; b = next) {
+        next = b->next;
+        free(b->block);
+        free(b);
+    }
+    for (i = 0; i < s->numRuns; ++i) {
+        unlink(s->runs[i]);
+        free(s->runs[i]);
+    }
+    free(s->runs);
+    if (s->dir[0]) {
+        rmdir(s->dir);
+        pthread_mutex_destroy(&s->lock);
+    }
+    memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * FILE: extsort.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for an external merge sort of text lines,
+ *      used to write results sorted by hostname without holding them all.
+ *  Each adding thread fills its own buffer of runBytes; a full buffer is
+ *      sorted and written out as a run file in a temporary directory. At the
+ *      end, runs are merged fanIn at a time through a loser tree. While more
+ *      than fanIn runs are left, each pass merges its groups on several
+ *      threads at once and deletes a group's runs as soon as it is merged;
+ *      the last pass merges the remaining runs into the output.
+ *  Memory is runBytes per adding thread while adding, and fanIn read
+ *      buffers per merging thread while merging. Temporary space peaks at
+ *      the size of the sorted output plus the groups being merged at once,
+ *      so never reaches twice the output; a pass merges only as many groups
+ *      as it takes to leave fanIn runs, which keeps that second copy small
+ *      when the run count is just over a power of fanIn.
+ *  Lines are compared byte by byte, so "host,address" lines come out in
+ *      hostname order.
+ *
+ ******************************************************************************/
+
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+/* Standard Includes */
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+
+
+#define EXTSORT_FAILURE         -1
+#define EXTSORT_SUCCESS         0
+
+#define EXTSORT_MAX_LINE        4096    // Including the newline and NUL
+#define EXTSORT_MIN_RUN         (64 * 1024)
+#define EXTSORT_MIN_FAN_IN      2
+#define EXTSORT_MAX_FAN_IN      512
+#define EXTSORT_MAX_THREADS     64      // Merging threads
+#define EXTSORT_IO_BUFFER       (64 * 1024)     // stdio buffer per run file
+#define EXTSORT_DIR_NAME        "%s.sort.XXXXXX"    // Next to the output
+
+
+struct extsort_buffer_s;
+
+typedef struct extsort_s {
+    unsigned long id;           // Tells a thread's buffers for each sort apart
+    char dir[PATH_MAX];         // Temporary directory holding the runs
+    size_t runBytes;            // Buffer size per adding thread
+    int fanIn;                  // Runs merged at once
+    int threads;                // Merging threads per pass
+    struct extsort_buffer_s* buffers;   // Every adding thread's buffer
+    pthread_mutex_t lock;       // Held for the fields below
+    char** runs;                // Run files not yet merged
+    int numRuns;
+    int runCap;
+    unsigned long nextRun;      // Names run files uniquely
+    int failed;                 // errno of the first failure, 0 if none
+    /* Figures for --stats */
+    unsigned long runsWritten;  // Runs written by adding threads
+    int passes;                 // Merge passes, counting the last
+    unsigned long long tempBytes;       // In run files right now
+    unsigned long long peakTempBytes;
+} extsort;
+
+
+/* Function to set up a sort whose runs go in a new directory named after
+ * path; runBytes and fanIn are clamped to their limits
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE (errno set)
+ */
+int extsort_init(extsort* s, const char* path, size_t runBytes, int fanIn,
+                 int threads);
+
+/* Function to add one line (without its newline) to the calling thread's
+ * buffer, writing a run when it is full; safe to call from many threads
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE (errno set)
+ */
+int extsort_add(extsort* s, const char* line, size_t len);
+
+/* Function to write the buffers out, merge every run and write the lines
+ * in order to out, once adding has stopped; the runs are deleted
+ * Returns EXTSORT_SUCCESS or EXTSORT_FAILURE (errno set)
+ */
+int extsort_finish(extsort* s, FILE* out);
+
+/* Function to free the buffers and delete any runs and the directory */
+void extsort_free(extsort* s);
+
+#endif
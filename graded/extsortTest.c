@@ -0,0 +1,206 @@
+/******************************************************************************
+ * FILE: extsortTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the external merge sort in extsort.h.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "extsort.h"
+
+#define TEST_THREADS    4
+#define TEST_LINES      100000          // Per thread
+#define TEST_FAN_IN     4
+#define TEST_LENGTH     64
+#define PARTIAL_FAN_IN  3
+#define PARTIAL_RUNS    11      // Leaves a last group of two in the first pass
+
+static extsort sorter;
+
+
+static unsigned long long line_hash(const char* line)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (; *line && *line != '\n'; ++line) {
+        hash = (hash ^ (unsigned char) *line) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+static int test_line(unsigned int seed, char* out, size_t size)
+{
+    return snprintf(out, size, "h%08x.example.com,10.%u.%u.%u",
+                    seed * 2654435761U, seed % 256, seed / 256 % 256, seed % 7);
+}
+
+
+/* Add TEST_LINES lines with scattered keys */
+static void* adder(void* arg)
+{
+    char line[TEST_LENGTH];
+    unsigned int first = (unsigned int) (long) arg * TEST_LINES;
+    unsigned int i;
+    long failures = 0;
+    int len;
+
+    for (i = first; i < first + TEST_LINES; ++i) {
+        len = test_line(i, line, sizeof(line));
+        failures += extsort_add(&sorter, line, len) == EXTSORT_FAILURE;
+    }
+    return (void*) failures;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    pthread_t threads[TEST_THREADS];
+    char line[EXTSORT_MAX_LINE + 1];
+    char prev[EXTSORT_MAX_LINE];
+    char dir[sizeof(sorter.dir)];
+    unsigned long long expect = 0;
+    unsigned long long got = 0;
+    unsigned long count = 0;
+    struct stat st;
+    void* status;
+    FILE* out;
+    long i;
+    int failures = 0;
+
+    for (i = 0; i < TEST_THREADS * TEST_LINES; ++i) {
+        test_line(i, line, sizeof(line));
+        expect += line_hash(line);
+    }
+
+    if (extsort_init(&sorter, "/tmp/extsortTest", 0, TEST_FAN_IN, 2) == EXTSORT_FAILURE
+            || (out = tmpfile()) == NULL) {
+        fprintf(stderr, "error: extsort_init failed\n");
+        return EXIT_FAILURE;
+    }
+    strcpy(dir, sorter.dir);
+
+    /* Overlong lines and embedded newlines are refused */
+    memset(line, 'a', EXTSORT_MAX_LINE);
+    if (extsort_add(&sorter, line, EXTSORT_MAX_LINE) != EXTSORT_FAILURE
+            || extsort_add(&sorter, "a\nb", 3) != EXTSORT_FAILURE) {
+        fprintf(stderr, "error: a bad line was accepted\n");
+        failures++;
+    }
+
+    /* Many threads fill small buffers, so there are many runs to merge */
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_create(&threads[i], NULL, adder, (void*) i);
+    }
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_join(threads[i], &status);
+        if (status) {
+            fprintf(stderr, "error: %ld lines were not added\n", (long) status);
+            failures++;
+        }
+    }
+    if (extsort_finish(&sorter, out) == EXTSORT_FAILURE) {
+        perror("error: extsort_finish failed");
+        failures++;
+    }
+    printf("%lu runs in %d passes, peak temporary space %llu bytes\n",
+           sorter.runsWritten, sorter.passes, sorter.peakTempBytes);
+    if (sorter.runsWritten <= TEST_FAN_IN * TEST_FAN_IN || sorter.passes < 3) {
+        fprintf(stderr, "error: expected several merge passes\n");
+        failures++;
+    }
+    if (sorter.tempBytes != 0) {
+        fprintf(stderr, "error: %llu temporary bytes left\n", sorter.tempBytes);
+        failures++;
+    }
+    extsort_free(&sorter);
+    if (stat(dir, &st) == 0) {
+        fprintf(stderr, "error: temporary directory %s left behind\n", dir);
+        failures++;
+    }
+
+    /* Every line comes out once, in order */
+    rewind(out);
+    prev[0] = '\0';
+    while (fgets(line, sizeof(line), out)) {
+        if (strcmp(prev, line) > 0) {
+            fprintf(stderr, "error: [%s] after [%s]\n", line, prev);
+            failures++;
+            break;
+        }
+        strcpy(prev, line);
+        got += line_hash(line);
+        count++;
+    }
+    fclose(out);
+    if (count != TEST_THREADS * TEST_LINES || got != expect) {
+        fprintf(stderr, "error: %lu lines out of %d, or not the lines put in\n",
+                count, TEST_THREADS * TEST_LINES);
+        failures++;
+    }
+
+    /* A first pass whose last group is partial merges only the runs there
+     * are: add until the last run is started, then the finish spills it */
+    if (extsort_init(&sorter, "/tmp/extsortTest", 0, PARTIAL_FAN_IN, 2) == EXTSORT_FAILURE
+            || (out = tmpfile()) == NULL) {
+        fprintf(stderr, "error: extsort_init failed\n");
+        return EXIT_FAILURE;
+    }
+    expect = 0;
+    for (i = 0; sorter.runsWritten < PARTIAL_RUNS - 1 || i % 1000; ++i) {
+        test_line(i, line, sizeof(line));
+        expect += line_hash(line);
+        extsort_add(&sorter, line, strlen(line));
+    }
+    if (extsort_finish(&sorter, out) == EXTSORT_FAILURE || sorter.runsWritten != PARTIAL_RUNS
+            || sorter.tempBytes != 0) {
+        fprintf(stderr, "error: sorting %lu runs with a fan-in of %d failed\n",
+                sorter.runsWritten, PARTIAL_FAN_IN);
+        failures++;
+    }
+    rewind(out);
+    got = 0;
+    count = 0;
+    while (fgets(line, sizeof(line), out)) {
+        got += line_hash(line);
+        count++;
+    }
+    fclose(out);
+    if (count != (unsigned long) i || got != expect) {
+        fprintf(stderr, "error: %lu lines out of %ld after a partial group\n", count, i);
+        failures++;
+    }
+    extsort_free(&sorter);
+
+    /* Nothing added, nothing written */
+    if (extsort_init(&sorter, "/tmp/extsortTest", 0, TEST_FAN_IN, 2) == EXTSORT_FAILURE
+            || (out = tmpfile()) == NULL
+            || extsort_finish(&sorter, out) == EXTSORT_FAILURE || ftell(out) != 0) {
+        fprintf(stderr, "error: an empty sort wrote output\n");
+        failures++;
+    }
+    fclose(out);
+    extsort_free(&sorter);
+
+    if (failures) {
+        fprintf(stderr, "%d external sort test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All external sort tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * FILE: fair.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of deficit round-robin admission by input source.
+ *  A name costs one slot, so a source's quantum is simply its weight.
+ *  The source with the turn keeps it while it is waiting and has deficit
+ *      left; otherwise the turn passes to the head of the waiting list.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "fair.h"
+
+
+int fair_init(fair_sched* f, int numSources, const int* priorities,
+              const int* weights, int slots)
+{
+    int i;
+
+    if ((f->sources = calloc(numSources, sizeof(*f->sources))) == NULL) {
+        return FAIR_FAILURE;
+    }
+    if (pthread_mutex_init(&f->lock, NULL)) {
+        free(f->sources);
+        return FAIR_FAILURE;
+    }
+    f->numSources = numSources;
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        f->free[i] = slots;
+        f->turn[i] = -1;
+        f->head[i] = -1;
+        f->tail[i] = -1;
+    }
+    for (i = 0; i < numSources; ++i) {
+        f->sources[i].priority = priorities[i];
+        f->sources[i].weight = weights[i];
+        f->sources[i].next = -1;
+        pthread_cond_init(&f->sources[i].cond, NULL);
+    }
+    return FAIR_SUCCESS;
+}
+
+
+/* Add a source to the end of its class's waiting list */
+static void fair_enqueue(fair_sched* f, int source)
+{
+    int priority = f->sources[source].priority;
+
+    f->sources[source].next = -1;
+    f->sources[source].queued = 1;
+    if (f->tail[priority] < 0) {
+        f->head[priority] = source;
+    }
+    else {
+        f->sources[f->tail[priority]].next = source;
+    }
+    f->tail[priority] = source;
+}
+
+
+void fair_admit(fair_sched* f, int source)
+{
+    fair_source* s = &f->sources[source];
+
+    pthread_mutex_lock(&f->lock);
+
+    /* Free slots only exist while nobody in the class is waiting */
+    if (f->free[s->priority] > 0) {
+        f->free[s->priority]--;
+    }
+    else {
+        /* Several threads may wait on one source; it is listed once */
+        s->waiting++;
+        if (f->turn[s->priority] != source && !s->queued) {
+            fair_enqueue(f, source);
+        }
+        while (!s->granted) {
+            pthread_cond_wait(&s->cond, &f->lock);
+        }
+        s->granted--;
+    }
+
+    pthread_mutex_unlock(&f->lock);
+}
+
+
+/* Next waiting source of the class in deficit round-robin order, -1 if none */
+static int fair_pick(fair_sched* f, int priority)
+{
+    int turn = f->turn[priority];
+    fair_source* s;
+
+    if (turn >= 0) {
+        s = &f->sources[turn];
+        if (s->waiting && s->deficit > 0) {
+            s->deficit--;
+            return turn;
+        }
+
+        /* A spent source queues up again; an idle one forfeits its turn */
+        if (s->waiting) {
+            fair_enqueue(f, turn);
+        }
+    }
+
+    /* Pass the turn on, giving the next source its quantum */
+    if ((turn = f->head[priority]) >= 0) {
+        s = &f->sources[turn];
+        if ((f->head[priority] = s->next) < 0) {
+            f->tail[priority] = -1;
+        }
+        s->queued = 0;
+        s->deficit = s->weight - 1;
+    }
+    f->turn[priority] = turn;
+    return turn;
+}
+
+
+void fair_release(fair_sched* f, int priority)
+{
+    int source;
+
+    pthread_mutex_lock(&f->lock);
+
+    if ((source = fair_pick(f, priority)) < 0) {
+        f->free[priority]++;
+    }
+    else {
+        f->sources[source].waiting--;
+        f->sources[source].granted++;
+        pthread_cond_signal(&f->sources[source].cond);
+    }
+
+    pthread_mutex_unlock(&f->lock);
+}
+
+
+void fair_destroy(fair_sched* f)
+{
+    int i;
+
+    for (i = 0; i < f->numSources; ++i) {
+        pthread_cond_destroy(&f->sources[i].cond);
+    }
+    pthread_mutex_destroy(&f->lock);
+    free(f->sources);
+}
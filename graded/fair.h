@@ -0,0 +1,77 @@
+/******************************************************************************
+ * FILE: fair.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for fair admission of input sources to
+ *      the dispatch queue.
+ *  Each priority class has a fixed number of queue slots. While slots are
+ *      free any source takes one; once the class is full, freed slots are
+ *      handed to waiting sources by deficit round-robin, so each source gets
+ *      a share of the class proportional to its weight no matter how fast its
+ *      requester reads.
+ *  Waiting sources sit on a per-class list, so handing over a slot costs
+ *      the same whether there are ten sources or fifty thousand.
+ *
+ ******************************************************************************/
+
+#ifndef FAIR_H
+#define FAIR_H
+
+/* Standard Includes */
+#include <pthread.h>
+
+/* Local Includes */
+#include "dispatch.h"
+
+
+#define FAIR_FAILURE            -1
+#define FAIR_SUCCESS            0
+
+#define FAIR_MAX_WEIGHT         1000
+
+
+/* Admission state of one input source */
+typedef struct fair_source_s {
+    int priority;               // Class the source's names are queued in
+    int weight;                 // Slots granted per round-robin turn
+    int deficit;                // Grants left in the current turn
+    int waiting;                // Submitting threads blocked for a slot
+    int granted;                // Slots handed over, not yet taken up
+    int queued;                 // On the class's waiting list
+    int next;                   // Next source on the class's waiting list
+    pthread_cond_t cond;
+} fair_source;
+
+typedef struct fair_sched_s {
+    fair_source* sources;
+    int numSources;
+    int free[NUM_PRIORITY_CLASSES];     // Unclaimed slots per class
+    int turn[NUM_PRIORITY_CLASSES];     // Source whose turn it is, -1 if none
+    int head[NUM_PRIORITY_CLASSES];     // Waiting sources in turn order,
+    int tail[NUM_PRIORITY_CLASSES];     // not counting the one with the turn
+    pthread_mutex_t lock;
+} fair_sched;
+
+
+/* Function to set up numSources sources with the given classes and weights,
+ * and slots queue slots per class
+ * Returns FAIR_SUCCESS or FAIR_FAILURE
+ */
+int fair_init(fair_sched* f, int numSources, const int* priorities,
+              const int* weights, int slots);
+
+/* Function to block until source may queue one name; any number of threads
+ * may wait on one source */
+void fair_admit(fair_sched* f, int source);
+
+/* Function to return a slot of the given class, handing it to the next
+ * waiting source in round-robin order */
+void fair_release(fair_sched* f, int priority);
+
+/* Function to free the scheduler */
+void fair_destroy(fair_sched* f);
+
+#endif
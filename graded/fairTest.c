@@ -0,0 +1,213 @@
+/******************************************************************************
+ * FILE: fairTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the fair admission scheduler in fair.h.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "fair.h"
+
+#define TEST_RELEASES   400     // Slots handed out while both sources wait
+#define TEST_LOOPERS    2       // Threads submitting on each source
+#define TEST_WAITERS    8       // Threads waiting at once on one source
+#define TEST_WAIT_USEC  5000000 // Longest a step may take before it is a hang
+
+static fair_sched sched;
+static int admitted[2];         // Slots taken up per source
+static int stop;                // Set to let the looping threads finish
+
+
+/* Take a slot once for the source in arg */
+static void* admit_once(void* arg)
+{
+    int source = *(int*) arg;
+
+    fair_admit(&sched, source);
+    __atomic_fetch_add(&admitted[source], 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+
+/* Keep taking slots for the source in arg, so it stays backlogged */
+static void* admit_loop(void* arg)
+{
+    int source = *(int*) arg;
+
+    do {
+        fair_admit(&sched, source);
+        __atomic_fetch_add(&admitted[source], 1, __ATOMIC_RELEASE);
+    } while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE));
+    return NULL;
+}
+
+
+/* Number of threads blocked in fair_admit() on a source */
+static int waiting(int source)
+{
+    int n;
+
+    pthread_mutex_lock(&sched.lock);
+    n = sched.sources[source].waiting;
+    pthread_mutex_unlock(&sched.lock);
+    return n;
+}
+
+
+/* Wait for a source to have waiters threads blocked and count slots taken
+ * Returns 1 if that does not happen in time
+ */
+static int settle(int source, int waiters, int count)
+{
+    int usec;
+
+    for (usec = 0; usec < TEST_WAIT_USEC; usec += 100) {
+        if (waiting(source) == waiters
+                && __atomic_load_n(&admitted[source], __ATOMIC_ACQUIRE) == count) {
+            return 0;
+        }
+        usleep(100);
+    }
+    fprintf(stderr, "error: source %d has %d waiting and %d admitted, not %d and %d\n",
+            source, waiting(source), admitted[source], waiters, count);
+    return 1;
+}
+
+
+/* Start count threads running body on a source
+ * Returns 1 on a failure
+ */
+static int start(pthread_t* threads, int count, void* (*body)(void*), int* source)
+{
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        if (pthread_create(&threads[i], NULL, body, source)) {
+            perror("error: pthread_create failed");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/* Set up two sources of the normal class with no free slots */
+static void setup(int weight0, int weight1)
+{
+    static const int priorities[] = {PRIORITY_NORMAL, PRIORITY_NORMAL};
+    const int weights[] = {weight0, weight1};
+
+    fair_init(&sched, 2, priorities, weights, 0);
+    admitted[0] = 0;
+    admitted[1] = 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    static int sources[] = {0, 1};
+    pthread_t threads[2][TEST_WAITERS];
+    int failures = 0;
+    int i;
+
+    /* Backlogged sources weighted 1:3 get slots 1:3, a turn at a time */
+    setup(1, 3);
+    if (start(threads[0], TEST_LOOPERS, admit_loop, &sources[0])
+            || start(threads[1], TEST_LOOPERS, admit_loop, &sources[1])
+            || settle(0, TEST_LOOPERS, 0) || settle(1, TEST_LOOPERS, 0)) {
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < TEST_RELEASES; ++i) {
+        fair_release(&sched, PRIORITY_NORMAL);
+        while (waiting(0) + waiting(1) < 2 * TEST_LOOPERS
+                || __atomic_load_n(&admitted[0], __ATOMIC_ACQUIRE)
+                   + __atomic_load_n(&admitted[1], __ATOMIC_ACQUIRE) < i + 1) {
+            usleep(10);
+        }
+    }
+    if (admitted[0] != TEST_RELEASES / 4 || admitted[1] != TEST_RELEASES / 4 * 3) {
+        fprintf(stderr, "error: weights 1:3 got %d and %d of %d slots\n",
+                admitted[0], admitted[1], TEST_RELEASES);
+        failures++;
+    }
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < 2 * TEST_LOOPERS; ++i) {
+        fair_release(&sched, PRIORITY_NORMAL);
+    }
+    for (i = 0; i < TEST_LOOPERS; ++i) {
+        pthread_join(threads[0][i], NULL);
+        pthread_join(threads[1][i], NULL);
+    }
+    fair_destroy(&sched);
+
+    /* A source that stops waiting forfeits the rest of its turn */
+    setup(4, 1);
+    if (start(threads[0], 1, admit_once, &sources[0]) || settle(0, 1, 0)
+            || start(threads[1], 1, admit_once, &sources[1]) || settle(1, 1, 0)) {
+        return EXIT_FAILURE;
+    }
+    fair_release(&sched, PRIORITY_NORMAL);
+    failures += settle(0, 0, 1);
+    fair_release(&sched, PRIORITY_NORMAL);
+    if (settle(1, 0, 1)) {
+        fprintf(stderr, "error: an idle source held on to its turn\n");
+        return EXIT_FAILURE;
+    }
+    pthread_join(threads[0][0], NULL);
+    pthread_join(threads[1][0], NULL);
+
+    /* With nobody waiting a slot goes back to the class */
+    fair_release(&sched, PRIORITY_NORMAL);
+    if (sched.free[PRIORITY_NORMAL] != 1) {
+        fprintf(stderr, "error: %d free slots after an unclaimed release\n",
+                sched.free[PRIORITY_NORMAL]);
+        failures++;
+    }
+    fair_destroy(&sched);
+
+    /* Many threads waiting on each source each get a slot, none lost */
+    setup(1, 2);
+    if (start(threads[0], TEST_WAITERS, admit_once, &sources[0])
+            || start(threads[1], TEST_WAITERS, admit_once, &sources[1])
+            || settle(0, TEST_WAITERS, 0) || settle(1, TEST_WAITERS, 0)) {
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < 2 * TEST_WAITERS; ++i) {
+        fair_release(&sched, PRIORITY_NORMAL);
+    }
+    if (settle(0, 0, TEST_WAITERS) || settle(1, 0, TEST_WAITERS)) {
+        fprintf(stderr, "error: grants were lost with several threads waiting\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < TEST_WAITERS; ++i) {
+        pthread_join(threads[0][i], NULL);
+        pthread_join(threads[1][i], NULL);
+    }
+    if (sched.free[PRIORITY_NORMAL] != 0 || sched.head[PRIORITY_NORMAL] != -1) {
+        fprintf(stderr, "error: %d free slots and source %d listed after the last grant\n",
+                sched.free[PRIORITY_NORMAL], sched.head[PRIORITY_NORMAL]);
+        failures++;
+    }
+    fair_destroy(&sched);
+
+    if (failures) {
+        fprintf(stderr, "%d fair test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All fair tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,347 @@
+/******************************************************************************
+ * FILE: labels.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the suffix-shared hostname store.
+ *  Labels and (parent, label) pairs are found through open-addressing hash
+ *      indexes kept at most half full; reading a name walks from its node
+ *      up to the root, which yields the labels left to right.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "labels.h"
+
+#define LABELS_INITIAL_SLOTS    1024
+
+
+/* Block of a store laid out in blocks of first, 2 * first, 4 * first...
+ * that holds position i, with i's index within it in index */
+static int labels_block(size_t i, size_t first, size_t* index)
+{
+    int k = 63 - __builtin_clzll(i / first + 1);
+
+    *index = i - ((1ULL << k) - 1) * first;
+    return k;
+}
+
+
+/* A label's length byte, followed by its characters */
+static const unsigned char* labels_text(const label_store* s, unsigned int off)
+{
+    size_t index;
+    int k = labels_block(off, LABELS_TEXT_BLOCK, &index);
+
+    return s->text[k] + index;
+}
+
+
+static label_node* labels_node_at(const label_store* s, unsigned int node)
+{
+    size_t index;
+    int k = labels_block(node, LABELS_NODE_BLOCK, &index);
+
+    return &s->nodes[k][index];
+}
+
+
+static unsigned int labels_hash_text(const char* label, size_t len)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        hash = (hash ^ (unsigned char) label[i]) * 1099511628211ULL;
+    }
+    return (unsigned int) (hash ^ (hash >> 32));
+}
+
+
+static unsigned int labels_hash_node(unsigned int parent, unsigned int label)
+{
+    unsigned long long hash = ((unsigned long long) parent << 32 | label)
+        * 0x9e3779b97f4a7c15ULL;
+
+    return (unsigned int) (hash >> 32);
+}
+
+
+/* Double an index and put every entry back; hashOf gives an entry's hash
+ * Returns LABELS_SUCCESS or LABELS_FAILURE
+ */
+static int labels_grow(unsigned int** index, unsigned int* slots,
+                       unsigned int (*hashOf)(const label_store*, unsigned int),
+                       const label_store* s)
+{
+    unsigned int newSlots = *slots ? 2 * *slots : LABELS_INITIAL_SLOTS;
+    unsigned int* grown;
+    unsigned int i;
+    unsigned int j;
+
+    if (newSlots < *slots || (grown = calloc(newSlots, sizeof(*grown))) == NULL) {
+        return LABELS_FAILURE;
+    }
+    for (i = 0; i < *slots; ++i) {
+        if ((*index)[i]) {
+            for (j = hashOf(s, (*index)[i]) & (newSlots - 1); grown[j];
+                 j = (j + 1) & (newSlots - 1)) {
+            }
+            grown[j] = (*index)[i];
+        }
+    }
+    free(*index);
+    *index = grown;
+    *slots = newSlots;
+    return LABELS_SUCCESS;
+}
+
+
+static unsigned int labels_label_hash(const label_store* s, unsigned int entry)
+{
+    const unsigned char* text = labels_text(s, entry - 1);
+
+    return labels_hash_text((const char*) text + 1, text[0]);
+}
+
+
+static unsigned int labels_node_hash(const label_store* s, unsigned int node)
+{
+    const label_node* n = labels_node_at(s, node);
+
+    return labels_hash_node(n->parent, n->label);
+}
+
+
+/* Offset of a label in text, adding it if new; UINT_MAX if out of memory */
+static unsigned int labels_label(label_store* s, const char* label, size_t len)
+{
+    const unsigned char* found;
+    unsigned char* text;
+    size_t index;
+    size_t size;
+    unsigned int i;
+    unsigned int off;
+    int k;
+
+    if (2 * (s->numLabels + 1) > s->labelSlots
+            && labels_grow(&s->labelIndex, &s->labelSlots, labels_label_hash, s)) {
+        return UINT_MAX;
+    }
+    for (i = labels_hash_text(label, len) & (s->labelSlots - 1); s->labelIndex[i];
+         i = (i + 1) & (s->labelSlots - 1)) {
+        found = labels_text(s, s->labelIndex[i] - 1);
+        if (found[0] == len && !memcmp(found + 1, label, len)) {
+            return s->labelIndex[i] - 1;
+        }
+    }
+
+    /* A new label, in a new block if it does not fit in the last one */
+    if (s->textSize + 1 + len > s->textCap) {
+        k = labels_block(s->textCap, LABELS_TEXT_BLOCK, &index);
+        size = (size_t) LABELS_TEXT_BLOCK << k;
+        if (s->textCap + size > UINT_MAX || (text = malloc(size)) == NULL) {
+            return UINT_MAX;
+        }
+        s->text[k] = text;
+        s->textSize = s->textCap;
+        s->textCap += size;
+    }
+    off = s->textSize;
+    k = labels_block(off, LABELS_TEXT_BLOCK, &index);
+    s->text[k][index] = (unsigned char) len;
+    memcpy(s->text[k] + index + 1, label, len);
+    s->textSize += 1 + len;
+    s->labelIndex[i] = off + 1;
+    s->numLabels++;
+    return off;
+}
+
+
+/* The node for label under parent, adding it if new; LABELS_NONE if out of
+ * memory */
+static unsigned int labels_node(label_store* s, unsigned int parent, unsigned int label)
+{
+    label_node* n;
+    size_t index;
+    size_t size;
+    unsigned int i;
+    unsigned int node;
+    int k;
+
+    if (2 * (s->numNodes + 1) > s->nodeSlots
+            && labels_grow(&s->nodeIndex, &s->nodeSlots, labels_node_hash, s)) {
+        return LABELS_NONE;
+    }
+    for (i = labels_hash_node(parent, label) & (s->nodeSlots - 1); (node = s->nodeIndex[i]);
+         i = (i + 1) & (s->nodeSlots - 1)) {
+        n = labels_node_at(s, node);
+        if (n->parent == parent && n->label == label) {
+            return node;
+        }
+    }
+
+    /* A new node, in a new block if the last one is full */
+    if (s->numNodes == s->nodeCap) {
+        k = labels_block(s->nodeCap, LABELS_NODE_BLOCK, &index);
+        size = (size_t) LABELS_NODE_BLOCK << k;
+        if (s->nodeCap + size > LABELS_NONE
+                || (s->nodes[k] = malloc(size * sizeof(label_node))) == NULL) {
+            return LABELS_NONE;
+        }
+        s->nodeCap += size;
+    }
+    node = s->numNodes;
+    n = labels_node_at(s, node);
+    n->parent = parent;
+    n->label = label;
+    s->numNodes++;
+    s->nodeIndex[i] = node;
+    return node;
+}
+
+
+int labels_init(label_store* s)
+{
+    memset(s, 0, sizeof(*s));
+    s->nodeCap = LABELS_NODE_BLOCK;
+    if ((s->nodes[0] = malloc(s->nodeCap * sizeof(label_node))) == NULL) {
+        return LABELS_FAILURE;
+    }
+
+    /* The root: the empty name */
+    s->nodes[0][0].parent = LABELS_ROOT;
+    s->nodes[0][0].label = 0;
+    s->numNodes = 1;
+    pthread_mutex_init(&s->lock, NULL);
+    return LABELS_SUCCESS;
+}
+
+
+label_handle labels_intern(label_store* s, const char* hostname)
+{
+    const char* end = hostname + strlen(hostname);
+    const char* dot;
+    unsigned int node = LABELS_ROOT;
+    unsigned int label;
+
+    pthread_mutex_lock(&s->lock);
+    if (s->frozen) {
+        pthread_mutex_unlock(&s->lock);
+        errno = EPERM;
+        return LABELS_NONE;
+    }
+
+    /* Walk down from the last label */
+    for (;;) {
+        for (dot = end; dot > hostname && dot[-1] != '.'; --dot) {
+        }
+        if (dot == end || end - dot > UCHAR_MAX
+                || (label = labels_label(s, dot, end - dot)) == UINT_MAX
+                || (node = labels_node(s, node, label)) == LABELS_NONE) {
+            node = LABELS_NONE;
+            break;
+        }
+        if (dot == hostname) {
+            break;
+        }
+        end = dot - 1;
+    }
+
+    pthread_mutex_unlock(&s->lock);
+    return node;
+}
+
+
+size_t labels_name(const label_store* s, label_handle h, char* out, size_t size)
+{
+    const label_node* n;
+    const unsigned char* text;
+    size_t len = 0;
+
+    for (; h != LABELS_ROOT; h = n->parent) {
+        n = labels_node_at(s, h);
+        text = labels_text(s, n->label);
+        if (len && len < size) {
+            out[len] = '.';
+        }
+        len += len != 0;
+        if (len < size) {
+            memcpy(out + len, text + 1, len + text[0] < size ? text[0] : size - len);
+        }
+        len += text[0];
+    }
+    if (size) {
+        out[len < size ? len : size - 1] = '\0';
+    }
+    return len;
+}
+
+
+void labels_freeze(label_store* s)
+{
+    label_node* nodes;
+    unsigned char* text;
+    size_t index;
+    size_t used;
+    int k;
+
+    pthread_mutex_lock(&s->lock);
+
+    /* Give back the unused end of the last blocks; a failed shrink keeps
+     * the old block */
+    if (s->textSize < s->textCap) {
+        k = labels_block(s->textSize - 1, LABELS_TEXT_BLOCK, &index);
+        used = index + 1;
+        if ((text = realloc(s->text[k], used)) != NULL) {
+            s->text[k] = text;
+            s->textCap = s->textSize;
+        }
+    }
+    if (s->numNodes < s->nodeCap) {
+        k = labels_block(s->numNodes - 1, LABELS_NODE_BLOCK, &index);
+        used = index + 1;
+        if ((nodes = realloc(s->nodes[k], used * sizeof(*nodes))) != NULL) {
+            s->nodes[k] = nodes;
+            s->nodeCap = s->numNodes;
+        }
+    }
+    free(s->labelIndex);
+    free(s->nodeIndex);
+    s->labelIndex = NULL;
+    s->nodeIndex = NULL;
+    s->labelSlots = 0;
+    s->nodeSlots = 0;
+    s->frozen = 1;
+    pthread_mutex_unlock(&s->lock);
+}
+
+
+size_t labels_bytes(const label_store* s)
+{
+    return s->textCap + (size_t) s->nodeCap * sizeof(label_node)
+        + ((size_t) s->labelSlots + s->nodeSlots) * sizeof(*s->labelIndex);
+}
+
+
+void labels_free(label_store* s)
+{
+    int k;
+
+    for (k = 0; k < LABELS_BLOCKS; ++k) {
+        free(s->text[k]);
+        free(s->nodes[k]);
+    }
+    free(s->labelIndex);
+    free(s->nodeIndex);
+    if (s->numNodes) {
+        pthread_mutex_destroy(&s->lock);
+    }
+    memset(s, 0, sizeof(*s));
+}
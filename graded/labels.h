@@ -0,0 +1,101 @@
+/******************************************************************************
+ * FILE: labels.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for a suffix-shared hostname store.
+ *  Hostnames are kept as paths in a trie of reversed labels: "a.example.com"
+ *      is the node for "a" under "example" under "com". Each distinct label
+ *      is stored once and every name sharing a suffix shares its nodes, so a
+ *      name costs one 8-byte node (parent and label ID) per label not shared
+ *      with a name seen before. A name is handled as the 32-bit ID of its
+ *      last node and turned back into text only when it is needed.
+ *  Labels and nodes live in blocks that double in size as the store grows
+ *      and never move once allocated, so a handle stays readable while
+ *      other names are added. Inserts are serialized by a lock, and any
+ *      number of threads may read names at the same time, given a handle
+ *      that reached them through a lock or queue after labels_intern()
+ *      returned it. Freezing frees the indexes used to find existing labels
+ *      and nodes once no more names will be added.
+ *
+ ******************************************************************************/
+
+#ifndef LABELS_H
+#define LABELS_H
+
+/* Standard Includes */
+#include <pthread.h>
+#include <stddef.h>
+
+
+#define LABELS_FAILURE          -1
+#define LABELS_SUCCESS          0
+
+#define LABELS_NONE             0xffffffffU     // No such name
+#define LABELS_ROOT             0               // The empty name
+
+#define LABELS_TEXT_BLOCK       (64 * 1024)     // Bytes in the first text block
+#define LABELS_NODE_BLOCK       1024            // Nodes in the first node block
+#define LABELS_BLOCKS           24              // Enough blocks for 2^32 of either
+
+
+typedef unsigned int label_handle;
+
+typedef struct label_node_s {
+    unsigned int parent;        // Handle of the name this label is under
+    unsigned int label;         // Offset of the label in text
+} label_node;
+
+typedef struct label_store_s {
+    /* Distinct labels: a length byte and the characters, back to back;
+     * block k holds offsets from (2^k - 1) to (2^(k + 1) - 1) times
+     * LABELS_TEXT_BLOCK, and no label spans two blocks */
+    unsigned char* text[LABELS_BLOCKS];
+    size_t textSize;
+    size_t textCap;
+    /* Trie nodes: node i is its label under its parent, with blocks laid
+     * out as for text in units of LABELS_NODE_BLOCK */
+    label_node* nodes[LABELS_BLOCKS];
+    unsigned int numNodes;
+    unsigned int nodeCap;
+    /* Open-addressing indexes, 1 + offset or node ID; 0 is an empty slot */
+    unsigned int* labelIndex;
+    unsigned int labelSlots;
+    unsigned int numLabels;
+    unsigned int* nodeIndex;
+    unsigned int nodeSlots;
+    int frozen;
+    pthread_mutex_t lock;       // Held by inserts
+} label_store;
+
+
+/* Function to set up an empty store
+ * Returns LABELS_SUCCESS or LABELS_FAILURE
+ */
+int labels_init(label_store* s);
+
+/* Function to add a normalized hostname, or find it if it is already there
+ * Returns its handle, or LABELS_NONE if out of memory, the store is frozen
+ * or the name has an empty label
+ */
+label_handle labels_intern(label_store* s, const char* hostname);
+
+/* Function to write a name's text into out, cut short to fit size; safe
+ * alongside labels_intern()
+ * Returns the full length of the name
+ */
+size_t labels_name(const label_store* s, label_handle h, char* out, size_t size);
+
+/* Function to free the indexes and trim the last blocks, after which names
+ * can be read but no longer added; no thread may read while it runs */
+void labels_freeze(label_store* s);
+
+/* Function to return the bytes the store holds */
+size_t labels_bytes(const label_store* s);
+
+/* Function to free the store */
+void labels_free(label_store* s);
+
+#endif
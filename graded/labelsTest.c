@@ -0,0 +1,215 @@
+/******************************************************************************
+ * FILE: labelsTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the suffix-shared hostname store in
+ *      labels.h.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "labels.h"
+
+#define TEST_NAMES      200000
+#define TEST_READERS    4
+#define TEST_LENGTH     256     // MAX_NAME_LENGTH, a queued copy of a name
+#define TEST_COPY_GAIN  8       // Least times smaller than queued copies
+#define TEST_STRING_GAIN 2      // Least times smaller than packed strings
+
+/* Sites under a few shared suffixes, each with the usual hosts */
+static const char* prefixes[] = {
+    "www", "api", "mail", "cdn", "img", "static", "m", "login"
+};
+static const char* suffixes[] = {
+    "s3.amazonaws.com", "cloudfront.net", "example.com", "co.uk"
+};
+
+static label_store store;
+static label_handle handles[TEST_NAMES];
+static int published;           // Names in handles[] readers may look at
+
+
+static void test_name(int i, char* out, size_t size)
+{
+    int site = i / (sizeof(prefixes) / sizeof(prefixes[0]));
+
+    snprintf(out, size, "%s.site%d.%s", prefixes[i % (sizeof(prefixes) / sizeof(prefixes[0]))],
+             site, suffixes[site % (sizeof(suffixes) / sizeof(suffixes[0]))]);
+}
+
+
+/* Read back every name published so far, until all of them are, at once
+ * with the other readers and with inserts */
+static void* reader(void* arg)
+{
+    char expect[TEST_LENGTH];
+    char name[TEST_LENGTH];
+    long failures = 0;
+    int count;
+    int done = 0;
+    int i;
+
+    (void) arg;
+
+    do {
+        count = __atomic_load_n(&published, __ATOMIC_ACQUIRE);
+        for (i = done; i < count; ++i) {
+            test_name(i, expect, sizeof(expect));
+            labels_name(&store, handles[i], name, sizeof(name));
+            failures += strcmp(name, expect) != 0;
+        }
+        done = count;
+    } while (count < TEST_NAMES);
+    return (void*) failures;
+}
+
+
+/* Start the readers
+ * Returns 1 on a failure
+ */
+static int start_readers(pthread_t* threads)
+{
+    int i;
+
+    for (i = 0; i < TEST_READERS; ++i) {
+        if (pthread_create(&threads[i], NULL, reader, NULL)) {
+            perror("error: pthread_create failed");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/* Wait for the readers, reporting names they read back wrong
+ * Returns the number of readers that did
+ */
+static int join_readers(pthread_t* threads, const char* when)
+{
+    void* status;
+    int failures = 0;
+    int i;
+
+    for (i = 0; i < TEST_READERS; ++i) {
+        pthread_join(threads[i], &status);
+        if (status) {
+            fprintf(stderr, "error: %ld names read back wrong %s\n", (long) status, when);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    static const char* invalid[] = {"", "a..b", ".a", "a."};
+    pthread_t threads[TEST_READERS];
+    char name[TEST_LENGTH];
+    char small[8];
+    size_t copies = (size_t) TEST_NAMES * TEST_LENGTH;
+    size_t arena = 0;
+    size_t live;
+    size_t frozen;
+    size_t len;
+    int failures = 0;
+    int i;
+
+    if (labels_init(&store) == LABELS_FAILURE) {
+        fprintf(stderr, "error: labels_init failed\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Names with empty labels are rejected */
+    for (i = 0; i < (int) (sizeof(invalid) / sizeof(invalid[0])); ++i) {
+        if (labels_intern(&store, invalid[i]) != LABELS_NONE) {
+            fprintf(stderr, "error: [%s] was accepted\n", invalid[i]);
+            failures++;
+        }
+    }
+
+    /* Names read back while later ones are added, as resolvers read names
+     * requesters are still interning */
+    if (start_readers(threads)) {
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < TEST_NAMES; ++i) {
+        test_name(i, name, sizeof(name));
+        arena += strlen(name) + 1 + sizeof(unsigned int);
+        if ((handles[i] = labels_intern(&store, name)) == LABELS_NONE) {
+            fprintf(stderr, "error: intern failed! Name: %s\n", name);
+            failures++;
+        }
+        __atomic_store_n(&published, i + 1, __ATOMIC_RELEASE);
+    }
+    failures += join_readers(threads, "while interning");
+
+    /* Interning a name twice gives the same handle; a suffix of a name is
+     * a name of its own */
+    test_name(7, name, sizeof(name));
+    if (labels_intern(&store, name) != handles[7]
+            || labels_intern(&store, "example.com") == handles[7]
+            || labels_intern(&store, "example.com") != labels_intern(&store, "example.com")) {
+        fprintf(stderr, "error: handles are not one per distinct name\n");
+        failures++;
+    }
+
+    /* Names cut short still report their full length */
+    len = labels_name(&store, handles[7], small, sizeof(small));
+    if (len != strlen(name) || strlen(small) != sizeof(small) - 1
+            || strncmp(small, name, sizeof(small) - 1)) {
+        fprintf(stderr, "error: truncated name [%s] length %lu\n", small, len);
+        failures++;
+    }
+
+    /* A frozen store takes no more names but reads from many threads */
+    live = labels_bytes(&store) + TEST_NAMES * sizeof(label_handle);
+    labels_freeze(&store);
+    frozen = labels_bytes(&store) + TEST_NAMES * sizeof(label_handle);
+    if (labels_intern(&store, "new.example.com") != LABELS_NONE) {
+        fprintf(stderr, "error: frozen store accepted a name\n");
+        failures++;
+    }
+    if (start_readers(threads)) {
+        return EXIT_FAILURE;
+    }
+    failures += join_readers(threads, "after freezing");
+
+    /* Handles and the store, indexes and all, are several times smaller than
+     * a queued copy of each name; frozen, they are still smaller than the
+     * names packed end to end, though every name keeps an 8-byte node for
+     * its first label */
+    printf("%d names: %lu bytes as copies, %lu bytes as strings, %lu bytes as handles "
+           "(%lu frozen)\n", TEST_NAMES, copies, arena, live, frozen);
+    if (live * TEST_COPY_GAIN > copies) {
+        fprintf(stderr, "error: handles are only %.1f times smaller than copies\n",
+                (double) copies / live);
+        failures++;
+    }
+    if (frozen * TEST_STRING_GAIN > arena) {
+        fprintf(stderr, "error: a frozen store is only %.1f times smaller than strings\n",
+                (double) arena / frozen);
+        failures++;
+    }
+    labels_free(&store);
+
+    if (failures) {
+        fprintf(stderr, "%d label store test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All label store tests passed\n");
+
+    return EXIT_SUCCESS;
+}
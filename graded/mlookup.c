@@ -0,0 +1,1165 @@
+/******************************************************************************
+ * FILE: mlookup.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of libmultilookup.
+ *  Submitting threads play the requester role: they normalize names, wait
+ *      for a fair share of their priority class and push onto the dispatch
+ *      queue. Resolver threads pop batches, resolve them and deliver the
+ *      results. Everything a context touches lives in the context.
+ *  Queues and caches hold names as handles into the context's label store
+ *      (labels.h): a submitter interns each name it admits, and a resolver
+ *      spells it out into the result it is about to resolve. A cache hit
+ *      compares handles, since a name has exactly one. The store keeps every
+ *      distinct name submitted for the life of the context.
+ *  With affinity, each resolver has a lane: its own dispatch queue and
+ *      cache, guarded by the lane's lock, though only the resolver touches
+ *      the cache. The shared queue becomes the overflow queue. A lane's
+ *      resolver sleeps on the lane's condition; a requester that spills a
+ *      name wakes one sleeping lane, and a lane only sleeps after announcing
+ *      itself in waitingLanes and finding the overflow queue empty, so a
+ *      spilled name is never left with every resolver asleep.
+ *  With a segmented queue, qmutex is not used: levels[] replace queue, and
+ *      a resolver holding a semaphore token retries until it pops the name
+ *      the token stands for, since a pop can miss a push still in flight.
+ *  With a backlog, each ring level holds at most queueSize names and the
+ *      rest wait in order in the level's backlog file. A level's ring is
+ *      topped up from its file before every pop, so a ring is only empty
+ *      when its file is too, and dispatch_pop() sees every backlogged level.
+ *
+ ******************************************************************************/
+
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+#include "dispatch.h"
+#include "fair.h"
+#include "labels.h"
+#include "mlookup.h"
+#include "normalize.h"
+#include "probes.h"
+#include "segq.h"
+#include "spill.h"
+#include "trace.h"
+#include "util.h"
+
+_Static_assert(ML_NAME_LENGTH == MAX_NAME_LENGTH, "ML_NAME_LENGTH != MAX_NAME_LENGTH");
+_Static_assert(ML_PRIORITY_URGENT == PRIORITY_URGENT
+               && ML_PRIORITY_NORMAL == PRIORITY_NORMAL
+               && ML_PRIORITY_BULK == PRIORITY_BULK, "ML_PRIORITY_* mismatch");
+
+RING_DEFINE(ml_completions, ml_result, ML_COMPLETION_LOG2)
+
+#define ML_CACHE_WAYS           4       // Slots probed per name
+
+/* A resolved name kept by one resolver */
+typedef struct ml_cache_entry_s {
+    label_handle name;          // LABELS_ROOT for an empty slot
+    int rc;                     // UTIL_SUCCESS or UTIL_FAILURE
+    unsigned long used;         // Lookup count when last hit or stored
+    char result[ML_RESULT_LENGTH];
+    addrset addrs;
+} ml_cache_entry;
+
+/* One resolver's own queue and cache, in affinity mode */
+typedef struct ml_lane_s {
+    struct ml_context_s* ctx;
+    pthread_mutex_t lock;       // Held for queue, count, waiting and stopping
+    pthread_cond_t ready;       // Signaled when there may be names to take
+    dispatch* queue;            // Names routed to this resolver
+    int count;                  // Names in queue
+    int waiting;                // Resolver is asleep on ready
+    int stopping;               // Exit once the queue is empty
+    ml_cache_entry* cache;      // Touched only by this lane's resolver
+    unsigned long cacheMask;    // Slots - 1, a power of two
+    unsigned long clock;        // Lookups through the cache so far
+} ml_lane;
+
+struct ml_context_s {
+    ml_options opts;
+    ml_source* sources;
+    int numSources;
+    ml_callback callback;
+    void* arg;
+    label_store names;          // Every name submitted, as queued and cached
+
+    dispatch queue;             // Names waiting for a resolver; with
+                                // affinity, only names spilled over
+    fair_sched admission;       // Requesters wait for a fair share of their level
+    pthread_mutex_t qmutex;     // Held while touching queue
+    sem_t empty;                // Names in queue, plus stop tokens;
+                                // unused with affinity
+    ml_lane* lanes;             // One per resolver with affinity, else NULL
+    int segmented;              // levels[] are used instead of queue
+    segq levels[NUM_PRIORITY_CLASSES];
+    segq_pool segments;         // Shared by levels[], up to queueBytes
+    int passed[NUM_PRIORITY_CLASSES];   // As in dispatch, kept without a lock
+    int stopping;               // Tokens without a name are stop tokens
+    spill_file* backlog;        // Per class, names past queueSize in
+                                // memory, or NULL; guarded by qmutex
+    int backlogFailed;          // A backlog write failed and was reported
+    long overflow;              // Names in queue with affinity
+    int waitingLanes;           // Lanes about to sleep or asleep
+    unsigned int nextWake;      // Lane to try waking first
+
+    pthread_mutex_t lock;       // Held for pending, completions and discard
+    pthread_cond_t idle;        // Signaled when pending reaches 0
+    pthread_cond_t ready;       // Signaled when completions has results
+    pthread_cond_t room;        // Signaled when completions has room
+    long pending;               // Names submitted but not yet delivered
+    int discard;                // Drop results instead of queueing them
+    ml_completions* completions;
+
+    pthread_t* threads;
+    int numThreads;
+    ml_stats stats;             // Summed over resolvers a batch at a time
+};
+
+
+void ml_default_options(ml_options* opts)
+{
+    opts->resolvers = sysconf(_SC_NPROCESSORS_ONLN);
+    opts->queueSize = 10;
+    opts->batch = 1;
+    opts->agingThreshold = 8;
+    opts->idn = 0;
+    opts->dualStack = 0;
+    opts->reverse = 0;
+    opts->affinity = 0;
+    opts->cacheSize = ML_CACHE_ENTRIES;
+    opts->spillDepth = ML_SPILL_DEPTH;
+    opts->queueBytes = 0;
+    opts->backlogDir = NULL;
+    opts->exclude = NULL;
+    opts->excludeArg = NULL;
+}
+
+
+/* Spread a name's handle for routing and caching */
+static unsigned long ml_hash(label_handle name)
+{
+    return (unsigned long) (((unsigned long long) name * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+
+/* Find a resolver's cached result for a name
+ * Returns the entry, or NULL on a miss
+ */
+static ml_cache_entry* ml_cache_find(ml_lane* lane, label_handle name)
+{
+    ml_cache_entry* entry;
+    unsigned long hash = ml_hash(name);
+    unsigned long i;
+
+    for (i = 0; i < ML_CACHE_WAYS && i <= lane->cacheMask; ++i) {
+        entry = &lane->cache[(hash + i) & lane->cacheMask];
+        if (entry->name == name) {
+            entry->used = ++lane->clock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+
+/* Keep a resolved name, in an empty slot or over the least recently used
+ * one of its probe window */
+static void ml_cache_store(ml_lane* lane, label_handle name, const ml_result* result, int rc)
+{
+    ml_cache_entry* victim = NULL;
+    ml_cache_entry* entry;
+    unsigned long hash = ml_hash(name);
+    unsigned long i;
+
+    for (i = 0; i < ML_CACHE_WAYS && i <= lane->cacheMask; ++i) {
+        entry = &lane->cache[(hash + i) & lane->cacheMask];
+        if (entry->name == LABELS_ROOT) {
+            victim = entry;
+            break;
+        }
+        if (victim == NULL || entry->used < victim->used) {
+            victim = entry;
+        }
+    }
+    victim->name = name;
+    victim->used = ++lane->clock;
+    victim->rc = rc;
+    memcpy(victim->result, result->result, sizeof(victim->result));
+    victim->addrs.count = result->addrs.count;
+    memcpy(victim->addrs.addrs, result->addrs.addrs,
+           result->addrs.count * sizeof(result->addrs.addrs[0]));
+}
+
+
+/* Hand results to the callback or the completion queue, then retire them */
+static void ml_deliver(ml_context* ctx, const ml_result* results, int count)
+{
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        PROBE2(output_write, results[i].hostname, results[i].result);
+    }
+
+    if (ctx->callback) {
+        ctx->callback(results, count, ctx->arg);
+        pthread_mutex_lock(&ctx->lock);
+    }
+    else {
+        pthread_mutex_lock(&ctx->lock);
+        for (i = 0; i < count && !ctx->discard; ++i) {
+            while (ml_completions_is_full(ctx->completions) && !ctx->discard) {
+                pthread_cond_wait(&ctx->room, &ctx->lock);
+            }
+            if (!ctx->discard) {
+                ml_completions_push(ctx->completions, &results[i]);
+            }
+        }
+        pthread_cond_broadcast(&ctx->ready);
+    }
+
+    ctx->pending -= count;
+    if (ctx->pending == 0) {
+        pthread_cond_broadcast(&ctx->idle);
+        pthread_cond_broadcast(&ctx->ready);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+
+/* Deliver a name that never reaches the queue */
+static void ml_reject(ml_context* ctx, int source, unsigned long tag,
+                      const char* hostname, const char* status)
+{
+    ml_result result;
+
+    strncpy(result.hostname, hostname, sizeof(result.hostname));
+    result.hostname[sizeof(result.hostname) - 1] = '\0';
+    strncpy(result.result, status, sizeof(result.result));
+    result.source = source;
+    result.tag = tag;
+    result.latency = 0;
+    result.addrs.count = 0;
+
+    pthread_mutex_lock(&ctx->lock);
+    ctx->pending++;
+    pthread_mutex_unlock(&ctx->lock);
+    ml_deliver(ctx, &result, 1);
+}
+
+
+/* Record the finished timeline of a traced hostname */
+static void ml_trace(ml_context* ctx, const lookup_item* item, long long dequeued,
+                     long long lookupStart, long long lookupEnd, long long written)
+{
+    trace_span span;
+
+    labels_name(&ctx->names, item->name, span.hostname, sizeof(span.hostname));
+    span.requesterTid = item->requesterTid;
+    span.resolverTid = trace_tid();
+    span.readAt = item->readAt;
+    span.enqueued = item->enqueued;
+    span.dequeued = dequeued;
+    span.lookupStart = lookupStart;
+    span.lookupEnd = lookupEnd;
+    span.written = written;
+    trace_record(&span);
+}
+
+
+/* Report a name the queue had no room for */
+static void ml_push_failed(ml_context* ctx, const lookup_item* payload)
+{
+    char hostname[MAX_NAME_LENGTH];
+
+    labels_name(&ctx->names, payload->name, hostname, sizeof(hostname));
+    fprintf(stderr, "QUEUE ERROR: push [%s] failed!\n", hostname);
+}
+
+
+/* Wake one sleeping lane to take a spilled name */
+static void ml_wake_one(ml_context* ctx)
+{
+    unsigned int first;
+    unsigned int i;
+    ml_lane* lane;
+
+    first = __atomic_fetch_add(&ctx->nextWake, 1, __ATOMIC_RELAXED);
+    for (i = 0; i < (unsigned int) ctx->numThreads; ++i) {
+        lane = &ctx->lanes[(first + i) % ctx->numThreads];
+        pthread_mutex_lock(&lane->lock);
+        if (lane->waiting) {
+            pthread_cond_signal(&lane->ready);
+            pthread_mutex_unlock(&lane->lock);
+            return;
+        }
+        pthread_mutex_unlock(&lane->lock);
+    }
+}
+
+
+/* Queue an admitted name on the lane its hash picks, or on the overflow
+ * queue if that lane is backed up */
+static void ml_route(ml_context* ctx, const lookup_item* payload)
+{
+    ml_lane* lane = &ctx->lanes[ml_hash(payload->name) % ctx->numThreads];
+    int spillDepth = ctx->opts.spillDepth;
+
+    pthread_mutex_lock(&lane->lock);
+    if (!spillDepth || lane->count < spillDepth) {
+        if (dispatch_push(lane->queue, payload) == DISPATCH_FAILURE) {
+            ml_push_failed(ctx, payload);
+        }
+        else {
+            lane->count++;
+        }
+        if (lane->waiting) {
+            pthread_cond_signal(&lane->ready);
+        }
+        pthread_mutex_unlock(&lane->lock);
+        return;
+    }
+    pthread_mutex_unlock(&lane->lock);
+
+    pthread_mutex_lock(&ctx->qmutex);
+    if (dispatch_push(&ctx->queue, payload) == DISPATCH_FAILURE) {
+        ml_push_failed(ctx, payload);
+        pthread_mutex_unlock(&ctx->qmutex);
+        return;
+    }
+    __atomic_add_fetch(&ctx->overflow, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&ctx->qmutex);
+    __atomic_add_fetch(&ctx->stats.spilled, 1, __ATOMIC_RELAXED);
+
+    /* Pairs with the lane side of ml_claim_lane(): either it sees the name
+     * or we see it waiting */
+    if (__atomic_load_n(&ctx->waitingLanes, __ATOMIC_SEQ_CST)) {
+        ml_wake_one(ctx);
+    }
+}
+
+
+/* Queue an admitted name with qmutex held: on its ring level while that
+ * has fewer than queueSize names and nothing is backlogged ahead of it,
+ * otherwise at the end of the level's backlog file
+ * Returns DISPATCH_SUCCESS, or DISPATCH_FAILURE if there was no room
+ */
+static int ml_push(ml_context* ctx, const lookup_item* payload)
+{
+    spill_file* backlog;
+
+    if (ctx->backlog) {
+        backlog = &ctx->backlog[payload->priority];
+        if (backlog->count || dispatch_level_size(&ctx->queue.levels[payload->priority])
+                >= (unsigned long) ctx->opts.queueSize) {
+            if (spill_append(backlog, payload) == SPILL_SUCCESS) {
+                PROBE2(queue_push, payload->name, payload->priority);
+                return DISPATCH_SUCCESS;
+            }
+
+            /* Out of disk: the ring takes what it can, out of order */
+            if (!ctx->backlogFailed) {
+                fprintf(stderr, "QUEUE ERROR: backlog write failed: %s\n", strerror(errno));
+                ctx->backlogFailed = 1;
+            }
+        }
+    }
+    return dispatch_push(&ctx->queue, payload);
+}
+
+
+int ml_submit(ml_context* ctx, int source, const char* const* hostnames,
+              const unsigned long* tags, int count)
+{
+    char raw[NORMALIZE_BATCH][MAX_NAME_LENGTH];     // Names as given
+    char names[NORMALIZE_BATCH][MAX_NAME_LENGTH];   // Names as normalized
+    int codes[NORMALIZE_BATCH];
+    ml_source* src;
+    lookup_item payload;
+    long long readAt;
+    unsigned long tag;
+    int base;
+    int rc;
+    int n;
+    int i;
+
+    if (source < 0 || source >= ctx->numSources) {
+        return ML_FAILURE;
+    }
+    src = &ctx->sources[source];
+    readAt = traceEnabled ? monotonic_ns() : 0;
+
+    for (base = 0; base < count; base += n) {
+        n = count - base < NORMALIZE_BATCH ? count - base : NORMALIZE_BATCH;
+
+        /* Overlong names stay overlong when cut to the buffer size */
+        for (i = 0; i < n; ++i) {
+            strncpy(raw[i], hostnames[base + i], MAX_NAME_LENGTH);
+            raw[i][MAX_NAME_LENGTH - 1] = '\0';
+        }
+        normalize_batch(raw, names, codes, n, ctx->opts.idn);
+
+        for (i = 0; i < n; ++i) {
+            tag = tags ? tags[base + i] : 0;
+
+            /* Malformed names are reported without ever reaching the queue */
+            if (codes[i] != NAME_OK) {
+                ml_reject(ctx, source, tag, raw[i], normalize_strerror(codes[i]));
+                continue;
+            }
+
+            /* Excluded names are reported without queueing */
+            if (ctx->opts.exclude && ctx->opts.exclude(names[i], ctx->opts.excludeArg)) {
+                ml_reject(ctx, source, tag, names[i], ML_STATUS_EXCLUDED);
+                continue;
+            }
+
+            /* Names already past their deadline are reported without queueing */
+            if (src->deadline && monotonic_ns() > src->deadline) {
+                ml_reject(ctx, source, tag, names[i], ML_STATUS_DEADLINE);
+                continue;
+            }
+
+            /* The queue holds the name's handle */
+            if ((payload.name = labels_intern(&ctx->names, names[i])) == LABELS_NONE) {
+                ml_reject(ctx, source, tag, names[i], ML_STATUS_NO_MEMORY);
+                continue;
+            }
+            payload.priority = src->priority;
+            payload.source = source;
+            payload.tag = tag;
+            payload.deadline = src->deadline;
+            payload.enqueued = monotonic_ns();
+            if ((payload.traced = trace_sample())) {
+                payload.readAt = readAt;
+                payload.requesterTid = trace_tid();
+            }
+
+            pthread_mutex_lock(&ctx->lock);
+            ctx->pending++;
+            pthread_mutex_unlock(&ctx->lock);
+
+            /* Wait for this source's turn at a slot in its priority level */
+            fair_admit(&ctx->admission, source);
+
+            if (ctx->lanes) {
+                ml_route(ctx, &payload);
+                continue;
+            }
+
+            /* Only a full pool makes a segmented push wait */
+            if (ctx->segmented) {
+                while (segq_push(&ctx->levels[payload.priority], &payload) == SEGQ_FAILURE) {
+                    segq_wait(&ctx->segments);
+                }
+                PROBE2(queue_push, payload.name, payload.priority);
+                sem_post(&ctx->empty);
+                continue;
+            }
+
+            pthread_mutex_lock(&ctx->qmutex);
+            while ((rc = ml_push(ctx, &payload)) == DISPATCH_FAILURE && ctx->backlog) {
+                /* Nowhere to put the name until a resolver takes one */
+                pthread_mutex_unlock(&ctx->qmutex);
+                sched_yield();
+                pthread_mutex_lock(&ctx->qmutex);
+            }
+            if (rc == DISPATCH_FAILURE) {
+                fprintf(stderr, "QUEUE ERROR: push [%s] failed!\n", names[i]);
+            }
+            pthread_mutex_unlock(&ctx->qmutex);
+
+            /* Notify resolver threads about new hostname in queue */
+            sem_post(&ctx->empty);
+        }
+    }
+    return ML_SUCCESS;
+}
+
+
+/* Move names from the backlog files to their ring levels, with qmutex
+ * held, until each level has queueSize names or its file is empty */
+static void ml_refill(ml_context* ctx)
+{
+    dispatch_level* level;
+    spill_file* backlog;
+    lookup_item item;
+    int i;
+
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        level = &ctx->queue.levels[i];
+        backlog = &ctx->backlog[i];
+        while (backlog->count
+                && dispatch_level_size(level) < (unsigned long) ctx->opts.queueSize) {
+            if (spill_take(backlog, &item) == SPILL_FAILURE) {
+                /* Left in the file for the next pop to try again */
+                fprintf(stderr, "QUEUE ERROR: backlog read failed: %s\n", strerror(errno));
+                break;
+            }
+            dispatch_level_push(level, &item);
+        }
+    }
+}
+
+
+/* Take the next name from the segmented levels in the order dispatch_pop()
+ * would, but without a lock, so the aging counts are approximate
+ * Returns DISPATCH_SUCCESS, or DISPATCH_FAILURE if no level gave a name
+ */
+static int ml_seg_pop(ml_context* ctx, lookup_item* item)
+{
+    int level = -1;
+    int i;
+
+    /* A starved lower level first, then the most urgent non-empty one */
+    for (i = NUM_PRIORITY_CLASSES - 1; i > 0; --i) {
+        if (__atomic_load_n(&ctx->passed[i], __ATOMIC_RELAXED) >= ctx->opts.agingThreshold
+                && segq_size(&ctx->levels[i]) > 0) {
+            level = i;
+            break;
+        }
+    }
+    for (i = 0; level < 0 && i < NUM_PRIORITY_CLASSES; ++i) {
+        if (segq_size(&ctx->levels[i]) > 0) {
+            level = i;
+        }
+    }
+
+    /* Sizes lag pushes and pops, so fall back to trying every level */
+    if (level < 0 || segq_pop(&ctx->levels[level], item) == SEGQ_FAILURE) {
+        for (level = 0; level < NUM_PRIORITY_CLASSES
+                && segq_pop(&ctx->levels[level], item) == SEGQ_FAILURE; ++level) {
+        }
+        if (level == NUM_PRIORITY_CLASSES) {
+            return DISPATCH_FAILURE;
+        }
+    }
+
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        if (i == level) {
+            __atomic_store_n(&ctx->passed[i], 0, __ATOMIC_RELAXED);
+        }
+        else if (segq_size(&ctx->levels[i]) > 0) {
+            __atomic_add_fetch(&ctx->passed[i], 1, __ATOMIC_RELAXED);
+        }
+    }
+    PROBE2(queue_pop, item->name, level);
+    return DISPATCH_SUCCESS;
+}
+
+
+/* Take up to a batch of names from the shared queue, waiting for one
+ * Returns the number taken, 0 for a stop token
+ */
+static int ml_claim_shared(ml_context* ctx, lookup_item* items)
+{
+    int claimed;
+    int count;
+    int i;
+
+    /* Wait for queue to not be empty, then claim up to a batch of names
+     * without waiting */
+    sem_wait(&ctx->empty);
+    for (claimed = 1; claimed < ctx->opts.batch && !sem_trywait(&ctx->empty); ++claimed) {
+    }
+
+    /* Read the most urgent hostnames from the dispatch queue */
+    if (ctx->segmented) {
+        for (count = 0; count < claimed; ) {
+            if (ml_seg_pop(ctx, &items[count]) == DISPATCH_SUCCESS) {
+                count++;
+            }
+            else if (__atomic_load_n(&ctx->stopping, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            else {
+                sched_yield();
+            }
+        }
+    }
+    else {
+        pthread_mutex_lock(&ctx->qmutex);
+        for (count = 0; count < claimed; ++count) {
+            if (ctx->backlog) {
+                ml_refill(ctx);
+            }
+            if (dispatch_pop(&ctx->queue, &items[count]) == DISPATCH_FAILURE) {
+                break;
+            }
+        }
+        pthread_mutex_unlock(&ctx->qmutex);
+    }
+
+    /* A token without a name is a stop token: keep one, pass the rest on */
+    for (i = count; i < claimed - (count == 0); ++i) {
+        sem_post(&ctx->empty);
+    }
+    return count;
+}
+
+
+/* Take up to a batch of names from a lane, or from the overflow queue once
+ * the lane is empty, waiting for either
+ * Returns the number taken, 0 once the lane is stopping and empty
+ */
+static int ml_claim_lane(ml_lane* lane, lookup_item* items)
+{
+    ml_context* ctx = lane->ctx;
+    int stopping;
+    int count;
+
+    for (;;) {
+        pthread_mutex_lock(&lane->lock);
+        while (lane->count == 0 && !lane->stopping) {
+            /* Announce before looking, so a spill after the look wakes us */
+            __atomic_add_fetch(&ctx->waitingLanes, 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&ctx->overflow, __ATOMIC_SEQ_CST)) {
+                __atomic_sub_fetch(&ctx->waitingLanes, 1, __ATOMIC_SEQ_CST);
+                break;
+            }
+            lane->waiting = 1;
+            pthread_cond_wait(&lane->ready, &lane->lock);
+            lane->waiting = 0;
+            __atomic_sub_fetch(&ctx->waitingLanes, 1, __ATOMIC_SEQ_CST);
+        }
+        for (count = 0; count < ctx->opts.batch
+                && dispatch_pop(lane->queue, &items[count]) == DISPATCH_SUCCESS; ++count) {
+        }
+        lane->count -= count;
+        stopping = lane->stopping;
+        pthread_mutex_unlock(&lane->lock);
+
+        /* Busy with our own names: pass a wakeup for spilled ones along */
+        if (count) {
+            if (__atomic_load_n(&ctx->overflow, __ATOMIC_SEQ_CST)
+                    && __atomic_load_n(&ctx->waitingLanes, __ATOMIC_SEQ_CST)) {
+                ml_wake_one(ctx);
+            }
+            return count;
+        }
+
+        if (__atomic_load_n(&ctx->overflow, __ATOMIC_SEQ_CST)) {
+            pthread_mutex_lock(&ctx->qmutex);
+            for (count = 0; count < ctx->opts.batch
+                    && dispatch_pop(&ctx->queue, &items[count]) == DISPATCH_SUCCESS; ++count) {
+            }
+            __atomic_sub_fetch(&ctx->overflow, count, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&ctx->qmutex);
+            if (count) {
+                return count;
+            }
+        }
+        if (stopping) {
+            return 0;
+        }
+    }
+}
+
+
+/* Resolve batches of names until told to stop; lane is NULL without
+ * affinity */
+static void ml_resolve(ml_context* ctx, ml_lane* lane)
+{
+    lookup_item items[ML_MAX_BATCH];
+    ml_result results[ML_MAX_BATCH];
+    long long lookupStart[ML_MAX_BATCH];    // Set only for traced names
+    long long lookupEnd[ML_MAX_BATCH];
+    ml_cache_entry* entry;
+    unsigned long hits;
+    long long waitStart;
+    long long start;
+    long long delivered;
+    long long now;
+    int count;
+    int rc;
+    int i;
+
+    for (;;) {
+        waitStart = monotonic_ns();
+        if ((count = lane ? ml_claim_lane(lane, items) : ml_claim_shared(ctx, items)) == 0) {
+            break;
+        }
+        start = monotonic_ns();
+        hits = 0;
+
+        /* Notify requesters that there is more room in queue */
+        for (i = 0; i < count; ++i) {
+            fair_release(&ctx->admission, items[i].priority);
+        }
+
+        for (i = 0; i < count; ++i) {
+            if (items[i].traced) {
+                lookupStart[i] = monotonic_ns();
+            }
+            labels_name(&ctx->names, items[i].name, results[i].hostname,
+                        sizeof(results[i].hostname));
+            results[i].source = items[i].source;
+            results[i].tag = items[i].tag;
+            results[i].addrs.count = 0;
+
+            /* Skip the lookup if the name waited past its deadline */
+            if (items[i].deadline && monotonic_ns() > items[i].deadline) {
+                strncpy(results[i].result, ML_STATUS_DEADLINE, sizeof(results[i].result));
+            }
+            /* Lookup hostname and get IP string, unless this resolver
+             * has it cached */
+            else {
+                entry = NULL;
+                if (lane && lane->cache) {
+                    entry = ml_cache_find(lane, items[i].name);
+                }
+                if (entry) {
+                    rc = entry->rc;
+                    memcpy(results[i].result, entry->result, sizeof(results[i].result));
+                    results[i].addrs.count = entry->addrs.count;
+                    memcpy(results[i].addrs.addrs, entry->addrs.addrs,
+                           entry->addrs.count * sizeof(entry->addrs.addrs[0]));
+                    hits++;
+                }
+                else {
+                    PROBE1(dnslookup_entry, results[i].hostname);
+                    if (ctx->opts.dualStack) {
+                        rc = addrset_lookup(results[i].hostname, &results[i].addrs)
+                            == ADDRSET_SUCCESS ? UTIL_SUCCESS : UTIL_FAILURE;
+                        addrset_format(&results[i].addrs, 0, results[i].result,
+                                       sizeof(results[i].result));
+                    }
+                    else if (ctx->opts.reverse) {
+                        rc = dnsreverse(results[i].hostname, results[i].result,
+                                        sizeof(results[i].result));
+                    }
+                    else {
+                        rc = dnslookup(results[i].hostname, results[i].result,
+                                       sizeof(results[i].result));
+                    }
+                    PROBE2(dnslookup_exit, results[i].hostname, rc);
+                }
+                if (rc == UTIL_FAILURE) {
+                    fprintf(stderr, "DNSLOOKUP ERROR: %s\n", results[i].hostname);
+                    results[i].result[0] = '\0';
+                }
+                /* Failures are cached too: the name is asked again soon */
+                if (lane && lane->cache && !entry) {
+                    ml_cache_store(lane, items[i].name, &results[i], rc);
+                }
+            }
+
+            if (items[i].traced) {
+                lookupEnd[i] = monotonic_ns();
+            }
+        }
+
+        now = monotonic_ns();
+        for (i = 0; i < count; ++i) {
+            results[i].latency = now - items[i].enqueued;
+        }
+
+        /* Count names before delivering them, so the counts are whole once
+         * ml_drain() returns */
+        __atomic_fetch_add(&ctx->stats.names, count, __ATOMIC_RELAXED);
+        if (hits) {
+            __atomic_fetch_add(&ctx->stats.cacheHits, hits, __ATOMIC_RELAXED);
+        }
+        ml_deliver(ctx, results, count);
+        delivered = monotonic_ns();
+
+        /* Time spent handing results on counts as blocked, not busy */
+        __atomic_fetch_add(&ctx->stats.idle, start - waitStart, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->stats.busy, now - start, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&ctx->stats.blocked, delivered - now, __ATOMIC_RELAXED);
+
+        if (traceEnabled) {
+            now = delivered;
+            for (i = 0; i < count; ++i) {
+                if (items[i].traced) {
+                    ml_trace(ctx, &items[i], start, lookupStart[i], lookupEnd[i], now);
+                }
+            }
+        }
+    }
+}
+
+
+/* Resolver thread sharing the dispatch queue */
+static void* ml_resolver(void* arg)
+{
+    ml_resolve((ml_context*) arg, NULL);
+    return NULL;
+}
+
+
+/* Resolver thread owning a lane */
+static void* ml_lane_resolver(void* arg)
+{
+    ml_lane* lane = (ml_lane*) arg;
+
+    ml_resolve(lane->ctx, lane);
+    return NULL;
+}
+
+
+int ml_poll(ml_context* ctx, ml_result* results, int max, int wait)
+{
+    int count = 0;
+
+    pthread_mutex_lock(&ctx->lock);
+    while (wait && ml_completions_is_empty(ctx->completions) && ctx->pending > 0) {
+        pthread_cond_wait(&ctx->ready, &ctx->lock);
+    }
+    while (count < max && ml_completions_pop(ctx->completions, &results[count]) == RING_SUCCESS) {
+        count++;
+    }
+    if (count) {
+        pthread_cond_broadcast(&ctx->room);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return count;
+}
+
+
+void ml_get_stats(ml_context* ctx, ml_stats* stats)
+{
+    int i;
+
+    stats->names = __atomic_load_n(&ctx->stats.names, __ATOMIC_RELAXED);
+    stats->busy = __atomic_load_n(&ctx->stats.busy, __ATOMIC_RELAXED);
+    stats->blocked = __atomic_load_n(&ctx->stats.blocked, __ATOMIC_RELAXED);
+    stats->idle = __atomic_load_n(&ctx->stats.idle, __ATOMIC_RELAXED);
+    stats->cacheHits = __atomic_load_n(&ctx->stats.cacheHits, __ATOMIC_RELAXED);
+    stats->spilled = __atomic_load_n(&ctx->stats.spilled, __ATOMIC_RELAXED);
+    stats->queuePeak = ctx->segmented ? (long) __atomic_load_n(&ctx->segments.peakInUse,
+                                                               __ATOMIC_RELAXED)
+                                        * (long) ctx->segments.segmentBytes : 0;
+    stats->backlogged = 0;
+    stats->backlogPeak = 0;
+    pthread_mutex_lock(&ctx->qmutex);
+    for (i = 0; ctx->backlog && i < NUM_PRIORITY_CLASSES; ++i) {
+        stats->backlogged += ctx->backlog[i].appended;
+        stats->backlogPeak += ctx->backlog[i].peakBytes;
+    }
+    pthread_mutex_unlock(&ctx->qmutex);
+}
+
+
+void ml_drain(ml_context* ctx)
+{
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->pending > 0) {
+        pthread_cond_wait(&ctx->idle, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+
+/* Free every lane, which must have no resolver */
+static void ml_free_lanes(ml_context* ctx)
+{
+    int i;
+
+    if (ctx->lanes == NULL) {
+        return;
+    }
+    for (i = 0; i < ctx->opts.resolvers; ++i) {
+        pthread_mutex_destroy(&ctx->lanes[i].lock);
+        pthread_cond_destroy(&ctx->lanes[i].ready);
+        free(ctx->lanes[i].queue);
+        free(ctx->lanes[i].cache);
+    }
+    free(ctx->lanes);
+    ctx->lanes = NULL;
+}
+
+
+/* Open a backlog file per priority class in backlogDir, and set slots so
+ * admission never waits
+ * Returns ML_SUCCESS or ML_FAILURE (errno set)
+ */
+static int ml_init_backlog(ml_context* ctx, long* slots)
+{
+    int err;
+    int i;
+
+    if ((ctx->backlog = calloc(NUM_PRIORITY_CLASSES, sizeof(*ctx->backlog))) == NULL) {
+        return ML_FAILURE;
+    }
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        if (spill_open(&ctx->backlog[i], ctx->opts.backlogDir, sizeof(lookup_item),
+                       SPILL_BLOCK_BYTES) == SPILL_FAILURE) {
+            err = errno;
+            while (i-- > 0) {
+                spill_close(&ctx->backlog[i]);
+            }
+            free(ctx->backlog);
+            ctx->backlog = NULL;
+            errno = err;
+            return ML_FAILURE;
+        }
+    }
+    *slots = INT_MAX;
+    return ML_SUCCESS;
+}
+
+
+/* Close the backlog files, if any */
+static void ml_free_backlog(ml_context* ctx)
+{
+    int i;
+
+    for (i = 0; ctx->backlog && i < NUM_PRIORITY_CLASSES; ++i) {
+        spill_close(&ctx->backlog[i]);
+    }
+    free(ctx->backlog);
+    ctx->backlog = NULL;
+}
+
+
+/* Set up a lane per resolver, each with its own queue and cache
+ * Returns ML_SUCCESS or ML_FAILURE (errno set)
+ */
+static int ml_init_lanes(ml_context* ctx)
+{
+    unsigned long slots;
+    ml_lane* lane;
+    int i;
+
+    if ((ctx->lanes = calloc(ctx->opts.resolvers, sizeof(*ctx->lanes))) == NULL) {
+        return ML_FAILURE;
+    }
+    for (slots = 1; slots < (unsigned long) ctx->opts.cacheSize; slots <<= 1) {
+    }
+    for (i = 0; i < ctx->opts.resolvers; ++i) {
+        lane = &ctx->lanes[i];
+        lane->ctx = ctx;
+        pthread_mutex_init(&lane->lock, NULL);
+        pthread_cond_init(&lane->ready, NULL);
+        lane->cacheMask = slots - 1;
+        if ((lane->queue = malloc(sizeof(*lane->queue))) == NULL
+                || (ctx->opts.cacheSize
+                    && (lane->cache = calloc(slots, sizeof(*lane->cache))) == NULL)) {
+            ml_free_lanes(ctx);
+            errno = ENOMEM;
+            return ML_FAILURE;
+        }
+        dispatch_init(lane->queue, ctx->opts.agingThreshold);
+    }
+    return ML_SUCCESS;
+}
+
+
+/* Set up a segmented queue per priority class sharing one pool of up to
+ * queueBytes, and set slots to the names that fit: every segment but two
+ * per class, which may be partly used at the head and tail
+ * Returns ML_SUCCESS or ML_FAILURE (errno set)
+ */
+static int ml_init_segments(ml_context* ctx, long* slots)
+{
+    int i;
+
+    if (segq_pool_init(&ctx->segments, sizeof(lookup_item), SEGQ_SEGMENT_ITEMS,
+                       ctx->opts.queueBytes) == SEGQ_FAILURE) {
+        return ML_FAILURE;
+    }
+    if (ctx->segments.maxSegments <= 2 * NUM_PRIORITY_CLASSES) {
+        segq_pool_destroy(&ctx->segments);
+        errno = EINVAL;
+        return ML_FAILURE;
+    }
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        if (segq_init(&ctx->levels[i], &ctx->segments) == SEGQ_FAILURE) {
+            while (i-- > 0) {
+                segq_destroy(&ctx->levels[i]);
+            }
+            segq_pool_destroy(&ctx->segments);
+            return ML_FAILURE;
+        }
+    }
+    *slots = (long) (ctx->segments.maxSegments - 2 * NUM_PRIORITY_CLASSES)
+        * ctx->segments.segmentItems;
+    if (*slots > INT_MAX) {
+        *slots = INT_MAX;
+    }
+    ctx->segmented = 1;
+    return ML_SUCCESS;
+}
+
+
+/* Stop and join the first numThreads resolvers and free the context */
+static void ml_free(ml_context* ctx)
+{
+    ml_lane* lane;
+    int i;
+
+    __atomic_store_n(&ctx->stopping, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < ctx->numThreads; ++i) {
+        if (ctx->lanes) {
+            lane = &ctx->lanes[i];
+            pthread_mutex_lock(&lane->lock);
+            lane->stopping = 1;
+            pthread_cond_signal(&lane->ready);
+            pthread_mutex_unlock(&lane->lock);
+        }
+        else {
+            sem_post(&ctx->empty);
+        }
+    }
+    for (i = 0; i < ctx->numThreads; ++i) {
+        pthread_join(ctx->threads[i], NULL);
+    }
+    ml_free_lanes(ctx);
+    if (ctx->segmented) {
+        for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+            segq_destroy(&ctx->levels[i]);
+        }
+        segq_pool_destroy(&ctx->segments);
+    }
+    ml_free_backlog(ctx);
+
+    fair_destroy(&ctx->admission);
+    sem_destroy(&ctx->empty);
+    pthread_mutex_destroy(&ctx->qmutex);
+    pthread_cond_destroy(&ctx->idle);
+    pthread_cond_destroy(&ctx->ready);
+    pthread_cond_destroy(&ctx->room);
+    pthread_mutex_destroy(&ctx->lock);
+    labels_free(&ctx->names);
+    free(ctx->completions);
+    free(ctx->threads);
+    free(ctx->sources);
+    free(ctx);
+}
+
+
+ml_context* ml_create(const ml_options* opts, const ml_source* sources,
+                      int numSources, ml_callback callback, void* arg)
+{
+    ml_context* ctx;
+    int* priorities;
+    int* weights;
+    long slots = opts->queueSize;
+    int rc;
+    int i;
+
+    if (numSources < 1 || opts->resolvers < 1 || opts->queueSize < 1
+            || (opts->queueSize > dispatch_level_capacity && !opts->queueBytes)
+            || (opts->queueBytes && (opts->queueBytes < ML_MIN_QUEUE_BYTES || opts->affinity))
+            || (opts->backlogDir && (opts->affinity || opts->queueBytes))
+            || (opts->reverse && opts->dualStack)
+            || opts->batch < 1 || opts->batch > ML_MAX_BATCH
+            || opts->cacheSize < 0 || opts->cacheSize > ML_MAX_CACHE_ENTRIES
+            || opts->spillDepth < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    for (i = 0; i < numSources; ++i) {
+        if (sources[i].priority < 0 || sources[i].priority >= NUM_PRIORITY_CLASSES
+                || sources[i].weight < 1 || sources[i].weight > FAIR_MAX_WEIGHT) {
+            errno = EINVAL;
+            return NULL;
+        }
+    }
+
+    if ((ctx = calloc(1, sizeof(*ctx))) == NULL) {
+        return NULL;
+    }
+    ctx->opts = *opts;
+    ctx->numSources = numSources;
+    ctx->callback = callback;
+    ctx->arg = arg;
+    if ((ctx->sources = malloc(numSources * sizeof(*ctx->sources))) == NULL
+            || (ctx->threads = malloc(opts->resolvers * sizeof(*ctx->threads))) == NULL
+            || (!callback && (ctx->completions = malloc(sizeof(*ctx->completions))) == NULL)) {
+        free(ctx->sources);
+        free(ctx->threads);
+        free(ctx);
+        return NULL;
+    }
+    memcpy(ctx->sources, sources, numSources * sizeof(*sources));
+    if (ctx->completions) {
+        ml_completions_init(ctx->completions);
+    }
+
+    /* Initialize Queue, Semaphores and Mutexes */
+    dispatch_init(&ctx->queue, opts->agingThreshold);
+    if ((opts->queueBytes && ml_init_segments(ctx, &slots) == ML_FAILURE)
+            || (opts->backlogDir && ml_init_backlog(ctx, &slots) == ML_FAILURE)) {
+        i = errno;
+        free(ctx->completions);
+        free(ctx->threads);
+        free(ctx->sources);
+        free(ctx);
+        errno = i;
+        return NULL;
+    }
+    rc = FAIR_FAILURE;
+    if ((priorities = malloc(2 * numSources * sizeof(*priorities))) != NULL) {
+        weights = priorities + numSources;
+        for (i = 0; i < numSources; ++i) {
+            priorities[i] = sources[i].priority;
+            weights[i] = sources[i].weight;
+        }
+        rc = fair_init(&ctx->admission, numSources, priorities, weights, (int) slots);
+        free(priorities);
+    }
+    if (rc != FAIR_FAILURE && labels_init(&ctx->names) == LABELS_FAILURE) {
+        fair_destroy(&ctx->admission);
+        rc = FAIR_FAILURE;
+    }
+    if (rc == FAIR_FAILURE) {
+        if (ctx->segmented) {
+            for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+                segq_destroy(&ctx->levels[i]);
+            }
+            segq_pool_destroy(&ctx->segments);
+        }
+        ml_free_backlog(ctx);
+        free(ctx->completions);
+        free(ctx->threads);
+        free(ctx->sources);
+        free(ctx);
+        return NULL;
+    }
+    sem_init(&ctx->empty, 0, 0);
+    pthread_mutex_init(&ctx->qmutex, NULL);
+    pthread_mutex_init(&ctx->lock, NULL);
+    pthread_cond_init(&ctx->idle, NULL);
+    pthread_cond_init(&ctx->ready, NULL);
+    pthread_cond_init(&ctx->room, NULL);
+    if (opts->affinity && ml_init_lanes(ctx) == ML_FAILURE) {
+        i = errno;
+        ml_free(ctx);
+        errno = i;
+        return NULL;
+    }
+
+    /* Spawn Resolver Threads */
+    for (ctx->numThreads = 0; ctx->numThreads < opts->resolvers; ++ctx->numThreads) {
+        if ((errno = ctx->lanes
+                ? pthread_create(&ctx->threads[ctx->numThreads], NULL, ml_lane_resolver,
+                                 &ctx->lanes[ctx->numThreads])
+                : pthread_create(&ctx->threads[ctx->numThreads], NULL, ml_resolver, ctx))) {
+            i = errno;
+            ml_free(ctx);
+            errno = i;
+            return NULL;
+        }
+    }
+    return ctx;
+}
+
+
+void ml_destroy(ml_context* ctx)
+{
+    /* Nobody will poll what is left */
+    pthread_mutex_lock(&ctx->lock);
+    ctx->discard = 1;
+    pthread_cond_broadcast(&ctx->room);
+    pthread_mutex_unlock(&ctx->lock);
+
+    ml_drain(ctx);
+    ml_free(ctx);
+}
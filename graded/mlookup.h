@@ -0,0 +1,175 @@
+/******************************************************************************
+ * FILE: mlookup.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains the public interface of libmultilookup, the resolver
+ *      pipeline behind multi-lookup, for embedding in other programs.
+ *  A context owns its resolver thread pool, dispatch queue and fair
+ *      admission scheduler; any number of contexts may run in one process.
+ *  Callers submit arrays of hostnames on behalf of an input source. Each
+ *      name is normalized, admitted by its source's priority class and
+ *      weight, resolved, and delivered either to a callback or to a
+ *      completion queue drained with ml_poll().
+ *  With affinity set, each name is routed by a hash of its normalized form
+ *      to one resolver's own queue, so every lookup of a name lands on the
+ *      same resolver, which keeps recent results in a private cache that
+ *      needs no locking. A resolver whose queue is spillDepth deep sends
+ *      further names to a shared overflow queue that idle resolvers drain,
+ *      so one hot name cannot stall the rest.
+ *  With queueBytes set, each priority class is a segmented queue (segq.h)
+ *      instead of a fixed ring: submitters push and resolvers pop without a
+ *      lock, and the queue grows a segment at a time until its segments
+ *      would exceed queueBytes. Fair admission then hands out as many slots
+ *      as fit under that ceiling, in place of queueSize.
+ *  With backlogDir set, admission never makes a submitter wait: once a
+ *      class has queueSize names in memory, further names are appended to a
+ *      temporary file in backlogDir (spill.h) and read back in order as the
+ *      resolvers catch up, so memory stays flat however far they fall
+ *      behind and submitters can finish with their input early.
+ *  With an exclude filter, each normalized name is checked by the submitting
+ *      thread before admission, and names it skips are delivered at once
+ *      with ML_STATUS_EXCLUDED, never taking a queue slot.
+ *  With reverse set, the names submitted are IP addresses, and each result
+ *      is the hostname its PTR record names, found with getnameinfo().
+ *
+ ******************************************************************************/
+
+#ifndef MLOOKUP_H
+#define MLOOKUP_H
+
+/* Local Includes */
+#include "addrset.h"
+
+#define ML_FAILURE              -1
+#define ML_SUCCESS              0
+
+/* Priority classes, most urgent first */
+#define ML_PRIORITY_URGENT      0
+#define ML_PRIORITY_NORMAL      1
+#define ML_PRIORITY_BULK        2
+
+#define ML_NAME_LENGTH          256     // Including the NUL
+#define ML_RESULT_LENGTH        ML_NAME_LENGTH  // Holds a PTR name
+#define ML_MAX_BATCH            64      // Largest resolver batch
+#define ML_COMPLETION_LOG2      10      // Results held for ml_poll()
+#define ML_CACHE_ENTRIES        1024    // Default results cached per resolver
+#define ML_MAX_CACHE_ENTRIES    (1 << 18)
+#define ML_SPILL_DEPTH          16      // Default resolver queue depth to spill at
+#define ML_MIN_QUEUE_BYTES      (1024 * 1024)   // Smallest segmented queue ceiling
+
+/* Results written in place of an address for a name past its deadline,
+ * for a name the exclude filter skipped and for a name there was no memory
+ * to queue; malformed names get a status from normalize_strerror() */
+#define ML_STATUS_DEADLINE      "DEADLINE_EXCEEDED"
+#define ML_STATUS_EXCLUDED      "EXCLUDED"
+#define ML_STATUS_NO_MEMORY     "OUT_OF_MEMORY"
+
+
+typedef struct ml_context_s ml_context;
+
+/* Function deciding whether a normalized name is skipped instead of looked
+ * up; called from ml_submit(), possibly from several threads at once
+ * Returns nonzero to skip the name
+ */
+typedef int (*ml_filter)(const char* hostname, void* arg);
+
+/* Pipeline parameters */
+typedef struct ml_options_s {
+    int resolvers;              // Resolver threads
+    int queueSize;              // Names admitted to each priority class
+    int batch;                  // Names a resolver takes per queue visit
+    int agingThreshold;         // Pops a backlogged class may sit out
+    int idn;                    // Convert non-ASCII labels to punycode
+    int dualStack;              // Collect every A and AAAA address (addrset.h)
+    int reverse;                // Names are addresses; find the name each
+                                // points back to; not with dualStack
+    int affinity;               // Route each name to one resolver by hash
+    int cacheSize;              // Results cached per resolver with affinity, 0 for none
+    int spillDepth;             // Resolver queue depth at which names go to the
+                                // overflow queue, 0 to never spill
+    long queueBytes;            // Segmented queue ceiling, 0 for fixed rings;
+                                // not with affinity
+    const char* backlogDir;     // Queue names past queueSize in a file here,
+                                // NULL for none; not with affinity or queueBytes
+    ml_filter exclude;          // Names to skip, NULL to look up every name
+    void* excludeArg;
+} ml_options;
+
+/* A stream of names sharing scheduling options */
+typedef struct ml_source_s {
+    int priority;               // ML_PRIORITY_* class
+    int weight;                 // Share of the class, 1 to FAIR_MAX_WEIGHT
+    long long deadline;         // CLOCK_MONOTONIC ns, 0 if none
+} ml_source;
+
+/* The outcome of one name */
+typedef struct ml_result_s {
+    char hostname[ML_NAME_LENGTH];      // Normalized, or as given if invalid
+    char result[ML_RESULT_LENGTH];      // First address (PTR name with
+                                        // reverse set), status string, or
+                                        // "" if the lookup failed
+    addrset addrs;                      // Every address, with dualStack set
+    int source;                         // Index into the sources given
+    unsigned long tag;                  // As passed to ml_submit()
+    long long latency;                  // Enqueue to resolution ns, 0 if
+                                        // the name was never queued
+} ml_result;
+
+/* Time spent by the resolvers, summed over threads */
+typedef struct ml_stats_s {
+    unsigned long names;        // Names resolved
+    long long busy;             // ns resolving
+    long long blocked;          // ns handing results on
+    long long idle;             // ns waiting for names
+    unsigned long cacheHits;    // Names answered from a resolver's cache
+    unsigned long spilled;      // Names sent to the overflow queue
+    long queuePeak;             // Most bytes of queue segments in use
+    unsigned long backlogged;   // Names queued in the backlog files
+    long backlogPeak;           // Largest size of each backlog file, summed
+} ml_stats;
+
+/* Function receiving results; called from resolver threads (and from
+ * ml_submit() for names rejected before queueing), possibly several at
+ * once */
+typedef void (*ml_callback)(const ml_result* results, int count, void* arg);
+
+
+/* Function to fill opts with defaults: one resolver per core, shared queue */
+void ml_default_options(ml_options* opts);
+
+/* Function to start a context for numSources sources; results go to
+ * callback, or to the completion queue if callback is NULL
+ * Returns the context, or NULL (errno set)
+ */
+ml_context* ml_create(const ml_options* opts, const ml_source* sources,
+                      int numSources, ml_callback callback, void* arg);
+
+/* Function to queue count names for source, blocking while the source
+ * waits for its share of queue slots; tags, if not NULL, gives a value
+ * per name to return in its result
+ * Returns ML_SUCCESS, or ML_FAILURE if source is out of range
+ */
+int ml_submit(ml_context* ctx, int source, const char* const* hostnames,
+              const unsigned long* tags, int count);
+
+/* Function to take up to max results from the completion queue; with wait
+ * set, blocks until at least one is ready or nothing is outstanding
+ * Returns the number of results taken
+ */
+int ml_poll(ml_context* ctx, ml_result* results, int max, int wait);
+
+/* Function to read the resolvers' time so far */
+void ml_get_stats(ml_context* ctx, ml_stats* stats);
+
+/* Function to block until every submitted name has been delivered; in
+ * completion queue mode another thread must be polling */
+void ml_drain(ml_context* ctx);
+
+/* Function to drain and stop a context; results not yet polled are
+ * discarded */
+void ml_destroy(ml_context* ctx);
+
+#endif
@@ -0,0 +1,371 @@
+/******************************************************************************
+ * FILE: mlookupTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the libmultilookup API in mlookup.h:
+ *      two contexts run side by side, one delivering to a callback and one
+ *      to the completion queue, then a context with resolver affinity takes
+ *      the same hot name over and over, then a context with a segmented
+ *      queue takes every name without waiting, and last a context queues
+ *      most of them in backlog files, a reverse context finds the name of
+ *      an address, and last several threads submit on each of two sources.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mlookup.h"
+
+#define TEST_NAMES      3000    // More than the completion queue holds
+#define TEST_SUBMITTERS 8       // Threads sharing two sources
+
+static const char* testNames[] = {"localhost", "LOCALHOST.", "bad..name"};
+static const char* testResults[] = {"127.0.0.1", "127.0.0.1", "INVALID_EMPTY_LABEL"};
+
+static int submitted = 0;       // Set once the poll context has every name
+
+typedef struct tally_s {
+    pthread_mutex_t lock;
+    int count;
+    int wrong;
+} tally;
+
+/* A thread submitting on a source other threads submit on too */
+typedef struct sharer_s {
+    ml_context* ctx;
+    int source;
+} sharer;
+
+
+/* Check one result against what its name, found by its tag, should give */
+static int check(const ml_result* r)
+{
+    int i = r->tag % 3;
+
+    return r->tag < TEST_NAMES && !strcmp(r->result, testResults[i])
+        && !strcmp(r->hostname, i == 2 ? "bad..name" : "localhost");
+}
+
+
+static void on_results(const ml_result* results, int count, void* arg)
+{
+    tally* t = (tally*) arg;
+    int i;
+
+    pthread_mutex_lock(&t->lock);
+    for (i = 0; i < count; ++i) {
+        t->count++;
+        t->wrong += !check(&results[i]) || results[i].source != 1;
+    }
+    pthread_mutex_unlock(&t->lock);
+}
+
+
+/* Submit TEST_NAMES names to a context in batches of 3 */
+static void submit_all(ml_context* ctx)
+{
+    unsigned long tags[3];
+    int i;
+
+    for (i = 0; i < TEST_NAMES; i += 3) {
+        tags[0] = i;
+        tags[1] = i + 1;
+        tags[2] = i + 2;
+        ml_submit(ctx, 1, testNames, tags, TEST_NAMES - i < 3 ? TEST_NAMES - i : 3);
+    }
+}
+
+
+static void* submitter(void* arg)
+{
+    submit_all((ml_context*) arg);
+    __atomic_store_n(&submitted, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+
+/* Count results from any source */
+static void on_shared(const ml_result* results, int count, void* arg)
+{
+    tally* t = (tally*) arg;
+    int i;
+
+    pthread_mutex_lock(&t->lock);
+    for (i = 0; i < count; ++i) {
+        t->count++;
+        t->wrong += !check(&results[i]);
+    }
+    pthread_mutex_unlock(&t->lock);
+}
+
+
+/* Submit TEST_NAMES names on behalf of the source in sharer */
+static void* shared_submitter(void* arg)
+{
+    sharer* s = (sharer*) arg;
+    unsigned long tags[3];
+    int i;
+
+    for (i = 0; i < TEST_NAMES; i += 3) {
+        tags[0] = i;
+        tags[1] = i + 1;
+        tags[2] = i + 2;
+        ml_submit(s->ctx, s->source, testNames, tags, TEST_NAMES - i < 3 ? TEST_NAMES - i : 3);
+    }
+    return NULL;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    ml_options opts;
+    ml_source sources[2] = {{ML_PRIORITY_URGENT, 1, 0}, {ML_PRIORITY_NORMAL, 2, 0}};
+    ml_context* callbackCtx;
+    ml_context* pollCtx;
+    ml_context* affinityCtx;
+    ml_context* segmentedCtx;
+    ml_context* backlogCtx;
+    ml_context* reverseCtx;
+    ml_context* sharedCtx;
+    ml_source sameClass[2] = {{ML_PRIORITY_NORMAL, 1, 0}, {ML_PRIORITY_NORMAL, 2, 0}};
+    pthread_t sharerThreads[TEST_SUBMITTERS];
+    sharer sharers[TEST_SUBMITTERS];
+    const char* address = "127.0.0.1";
+    ml_stats stats;
+    ml_result results[16];
+    pthread_t thread;
+    tally t = {PTHREAD_MUTEX_INITIALIZER, 0, 0};
+    int polled = 0;
+    int done;
+    int wrong = 0;
+    int failures = 0;
+    int n;
+    int i;
+
+    ml_default_options(&opts);
+    opts.resolvers = 2;
+    opts.batch = 4;
+
+    /* Bad options are refused */
+    sources[0].weight = 0;
+    if (ml_create(&opts, sources, 2, NULL, NULL) != NULL) {
+        fprintf(stderr, "error: context created with a zero weight\n");
+        failures++;
+    }
+    sources[0].weight = 1;
+    opts.cacheSize = -1;
+    if (ml_create(&opts, sources, 2, NULL, NULL) != NULL) {
+        fprintf(stderr, "error: context created with a negative cache size\n");
+        failures++;
+    }
+    opts.cacheSize = ML_CACHE_ENTRIES;
+    opts.queueBytes = ML_MIN_QUEUE_BYTES - 1;
+    if (ml_create(&opts, sources, 2, NULL, NULL) != NULL) {
+        fprintf(stderr, "error: context created with a queue ceiling under the minimum\n");
+        failures++;
+    }
+    opts.backlogDir = "/tmp";
+    opts.queueBytes = ML_MIN_QUEUE_BYTES;
+    if (ml_create(&opts, sources, 2, NULL, NULL) != NULL) {
+        fprintf(stderr, "error: context created with both a backlog and a segmented queue\n");
+        failures++;
+    }
+    opts.queueBytes = 0;
+    opts.backlogDir = "/nonexistent/mlookupTest";
+    if (ml_create(&opts, sources, 2, NULL, NULL) != NULL) {
+        fprintf(stderr, "error: context created with a missing backlog directory\n");
+        failures++;
+    }
+    opts.backlogDir = NULL;
+    opts.reverse = 1;
+    opts.dualStack = 1;
+    if (ml_create(&opts, sources, 2, NULL, NULL) != NULL) {
+        fprintf(stderr, "error: context created for reverse and dual-stack lookups\n");
+        failures++;
+    }
+    opts.reverse = 0;
+    opts.dualStack = 0;
+
+    callbackCtx = ml_create(&opts, sources, 2, on_results, &t);
+    pollCtx = ml_create(&opts, sources, 2, NULL, NULL);
+    if (callbackCtx == NULL || pollCtx == NULL) {
+        fprintf(stderr, "error: ml_create failed\n");
+        return EXIT_FAILURE;
+    }
+    if (ml_submit(pollCtx, 2, testNames, NULL, 1) != ML_FAILURE) {
+        fprintf(stderr, "error: submit to a missing source succeeded\n");
+        failures++;
+    }
+
+    /* Both contexts work at once; the poll queue is smaller than the
+     * names submitted, so polling must keep up */
+    pthread_create(&thread, NULL, submitter, pollCtx);
+    submit_all(callbackCtx);
+    while (polled < TEST_NAMES) {
+        /* Nothing outstanding only means the submitter is between names,
+         * unless it had finished before the poll */
+        done = __atomic_load_n(&submitted, __ATOMIC_ACQUIRE);
+        if ((n = ml_poll(pollCtx, results, 16, 1)) == 0) {
+            if (done) {
+                break;
+            }
+            continue;
+        }
+        for (i = 0; i < n; ++i) {
+            wrong += !check(&results[i]) || results[i].source != 1;
+        }
+        polled += n;
+    }
+    pthread_join(thread, NULL);
+    ml_drain(callbackCtx);
+
+    if (t.count != TEST_NAMES || t.wrong) {
+        fprintf(stderr, "error: callback saw %d results, %d wrong\n", t.count, t.wrong);
+        failures++;
+    }
+    if (polled != TEST_NAMES || wrong) {
+        fprintf(stderr, "error: polled %d results, %d wrong\n", polled, wrong);
+        failures++;
+    }
+    if (ml_poll(pollCtx, results, 16, 1) != 0) {
+        fprintf(stderr, "error: poll returned results after the last\n");
+        failures++;
+    }
+
+    ml_destroy(callbackCtx);
+    ml_destroy(pollCtx);
+
+    /* Every repeat of a name goes to one resolver, which answers it from
+     * its cache; the hot resolver's queue backs up and spills the rest */
+    opts.resolvers = 3;
+    opts.affinity = 1;
+    opts.cacheSize = 4;
+    opts.spillDepth = 1;
+    t.count = 0;
+    t.wrong = 0;
+    if ((affinityCtx = ml_create(&opts, sources, 2, on_results, &t)) == NULL) {
+        fprintf(stderr, "error: ml_create with affinity failed\n");
+        return EXIT_FAILURE;
+    }
+    submit_all(affinityCtx);
+    ml_drain(affinityCtx);
+    ml_get_stats(affinityCtx, &stats);
+    if (t.count != TEST_NAMES || t.wrong) {
+        fprintf(stderr, "error: affinity context saw %d results, %d wrong\n", t.count, t.wrong);
+        failures++;
+    }
+    if (stats.cacheHits == 0 || stats.spilled == 0
+            || stats.names != TEST_NAMES - TEST_NAMES / 3) {
+        fprintf(stderr, "error: %lu cache hits and %lu spilled of %lu names\n",
+                stats.cacheHits, stats.spilled, stats.names);
+        failures++;
+    }
+    ml_destroy(affinityCtx);
+
+    /* A segmented queue grows to hold every name */
+    opts.affinity = 0;
+    opts.queueBytes = 4 * ML_MIN_QUEUE_BYTES;
+    t.count = 0;
+    t.wrong = 0;
+    if ((segmentedCtx = ml_create(&opts, sources, 2, on_results, &t)) == NULL) {
+        fprintf(stderr, "error: ml_create with a segmented queue failed\n");
+        return EXIT_FAILURE;
+    }
+    submit_all(segmentedCtx);
+    ml_drain(segmentedCtx);
+    ml_get_stats(segmentedCtx, &stats);
+    if (t.count != TEST_NAMES || t.wrong) {
+        fprintf(stderr, "error: segmented context saw %d results, %d wrong\n",
+                t.count, t.wrong);
+        failures++;
+    }
+    if (stats.queuePeak <= 0 || stats.queuePeak > opts.queueBytes) {
+        fprintf(stderr, "error: segmented queue peaked at %ld bytes\n", stats.queuePeak);
+        failures++;
+    }
+    ml_destroy(segmentedCtx);
+
+    /* Past a few names in memory, the rest go through the backlog files
+     * and come back in order */
+    opts.queueBytes = 0;
+    opts.queueSize = 4;
+    opts.backlogDir = "/tmp";
+    t.count = 0;
+    t.wrong = 0;
+    if ((backlogCtx = ml_create(&opts, sources, 2, on_results, &t)) == NULL) {
+        fprintf(stderr, "error: ml_create with a backlog failed\n");
+        return EXIT_FAILURE;
+    }
+    submit_all(backlogCtx);
+    ml_drain(backlogCtx);
+    ml_get_stats(backlogCtx, &stats);
+    if (t.count != TEST_NAMES || t.wrong) {
+        fprintf(stderr, "error: backlog context saw %d results, %d wrong\n",
+                t.count, t.wrong);
+        failures++;
+    }
+    if (stats.backlogged == 0 || stats.backlogged > TEST_NAMES) {
+        fprintf(stderr, "error: %lu names went through the backlog\n", stats.backlogged);
+        failures++;
+    }
+    ml_destroy(backlogCtx);
+    opts.backlogDir = NULL;
+
+    /* An address comes back with its name */
+    opts.reverse = 1;
+    if ((reverseCtx = ml_create(&opts, sources, 2, NULL, NULL)) == NULL) {
+        fprintf(stderr, "error: ml_create for reverse lookups failed\n");
+        return EXIT_FAILURE;
+    }
+    ml_submit(reverseCtx, 0, &address, NULL, 1);
+    if (ml_poll(reverseCtx, results, 16, 1) != 1 || strcmp(results[0].hostname, address)
+            || strcmp(results[0].result, "localhost")) {
+        fprintf(stderr, "error: reverse lookup of %s gave [%s]\n", address, results[0].result);
+        failures++;
+    }
+    ml_destroy(reverseCtx);
+    opts.reverse = 0;
+
+    /* Threads sharing each of two sources in one class all wait for slots
+     * of a small queue */
+    t.count = 0;
+    t.wrong = 0;
+    opts.queueSize = 1;
+    if ((sharedCtx = ml_create(&opts, sameClass, 2, on_shared, &t)) == NULL) {
+        fprintf(stderr, "error: ml_create for shared sources failed\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < TEST_SUBMITTERS; ++i) {
+        sharers[i].ctx = sharedCtx;
+        sharers[i].source = i % 2;
+        pthread_create(&sharerThreads[i], NULL, shared_submitter, &sharers[i]);
+    }
+    for (i = 0; i < TEST_SUBMITTERS; ++i) {
+        pthread_join(sharerThreads[i], NULL);
+    }
+    ml_drain(sharedCtx);
+    if (t.count != TEST_SUBMITTERS * TEST_NAMES || t.wrong) {
+        fprintf(stderr, "error: shared source saw %d results, %d wrong\n", t.count, t.wrong);
+        failures++;
+    }
+    ml_destroy(sharedCtx);
+
+    if (failures) {
+        fprintf(stderr, "%d libmultilookup test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All libmultilookup tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,369 @@
+/******************************************************************************
+ * FILE: monitor.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the continuous monitoring mode.
+ *  The main thread turns the timer wheel once a second and pushes due names
+ *      onto a ring; it is the ring's only producer, so it pushes without a
+ *      lock. Resolver threads pop under a lock, query the A record for its
+ *      address and TTL, report a change and put the name back on the wheel.
+ *  Per name the mode keeps 16 bytes plus its share of the label store: the
+ *      wheel link and expiry, the name's handle and its last address. Names
+ *      share their common suffixes (see labels.h) and are spelled out only
+ *      to be resolved or reported.
+ *
+ ******************************************************************************/
+
+#include <arpa/nameser.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <resolv.h>
+#include <semaphore.h>
+#include <signal.h>
+
+#include "cfile.h"
+#include "labels.h"
+#include "monitor.h"
+#include "normalize.h"
+#include "ring.h"
+#include "util.h"
+#include "wheel.h"
+
+RING_DEFINE(monitor_due, unsigned int, MONITOR_QUEUE_LOG2)
+
+typedef struct monitor_s {
+    timer_wheel wheel;
+    label_store names;          // Every hostname, suffixes shared
+    label_handle* name;         // Each name's handle in names
+    unsigned int* addr;         // Last IPv4 address, network order; 0 if none
+    unsigned int count;
+    unsigned int cap;
+    FILE* outputfd;
+    int maxTtl;
+    long long start;            // CLOCK_MONOTONIC ns of tick 0
+    pthread_mutex_t lock;       // Wheel, addresses and output
+    monitor_due due;
+    pthread_mutex_t dueLock;    // Held by resolvers popping the due ring
+    sem_t dueSlots;
+    sem_t dueItems;
+} monitor;
+
+static volatile sig_atomic_t monitorStop = 0;
+
+
+static void monitor_signal(int sig)
+{
+    (void) sig;
+    monitorStop = 1;
+}
+
+
+/* Add a name to the label store */
+static int monitor_add(monitor* m, const char* name)
+{
+    void* p;
+
+    if (m->count == m->cap) {
+        m->cap = m->cap ? m->cap * 2 : 1024;
+        if (m->cap >= WHEEL_NONE
+                || (p = realloc(m->name, m->cap * sizeof(*m->name))) == NULL) {
+            return MONITOR_FAILURE;
+        }
+        m->name = p;
+    }
+    if ((m->name[m->count] = labels_intern(&m->names, name)) == LABELS_NONE) {
+        return MONITOR_FAILURE;
+    }
+    m->count++;
+    return MONITOR_SUCCESS;
+}
+
+
+/* Read and normalize every name in the input files */
+static int monitor_load(monitor* m, char* const* inputPaths, int numInputs, int idn)
+{
+    cfile input;
+    char raw[MAX_NAME_LENGTH];
+    char name[MAX_NAME_LENGTH];
+    int code;
+    int i;
+
+    for (i = 0; i < numInputs; ++i) {
+        if (cfile_open_read(&input, inputPaths[i]) == CFILE_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error opening input file [%s]: %s\n",
+                    inputPaths[i], strerror(errno));
+            continue;
+        }
+        while ((code = normalize_read(input.fp, raw)) != EOF) {
+            if (code != NAME_OK || (code = normalize_name(raw, name, idn)) != NAME_OK) {
+                fprintf(stderr, "MONITOR WARNING: Skipping [%s]: %s\n",
+                        raw, normalize_strerror(code));
+                continue;
+            }
+            if (monitor_add(m, name) == MONITOR_FAILURE) {
+                fprintf(stderr, "MALLOC ERROR: Error storing name [%s]\n", name);
+                cfile_close(&input);
+                return MONITOR_FAILURE;
+            }
+        }
+        if (cfile_close(&input)) {
+            fprintf(stderr, "FILE ERROR: Error reading input file [%s]\n",
+                    inputPaths[i]);
+        }
+    }
+    return MONITOR_SUCCESS;
+}
+
+
+/* Look up the first IPv4 address of a name and the smallest TTL on the way
+ * to it; names DNS does not know, such as hosts file entries, fall back to
+ * dnslookup() with a default TTL */
+static int monitor_resolve(res_state res, const char* hostname,
+                           unsigned int* addr, int* ttl)
+{
+    unsigned char answer[MONITOR_PACKET_SIZE];
+    char ip[INET6_ADDRSTRLEN];
+    struct in_addr in;
+    ns_msg msg;
+    ns_rr rr;
+    int found = 0;
+    int len;
+    int i;
+
+    len = res_nquery(res, hostname, ns_c_in, ns_t_a, answer, sizeof(answer));
+    if (len > 0 && ns_initparse(answer, len, &msg) == 0) {
+        for (i = 0; i < ns_msg_count(msg, ns_s_an); ++i) {
+            if (ns_parserr(&msg, ns_s_an, i, &rr)) {
+                break;
+            }
+            if (!found || (int) ns_rr_ttl(rr) < *ttl) {
+                *ttl = ns_rr_ttl(rr);
+            }
+            if (!found && ns_rr_type(rr) == ns_t_a && ns_rr_rdlen(rr) == sizeof(*addr)) {
+                memcpy(addr, ns_rr_rdata(rr), sizeof(*addr));
+                found = 1;
+            }
+        }
+        if (found) {
+            return MONITOR_SUCCESS;
+        }
+    }
+
+    if (dnslookup(hostname, ip, sizeof(ip)) == UTIL_SUCCESS
+            && inet_pton(AF_INET, ip, &in) == 1) {
+        *addr = in.s_addr;
+        *ttl = MONITOR_DEFAULT_TTL;
+        return MONITOR_SUCCESS;
+    }
+    return MONITOR_FAILURE;
+}
+
+
+/* Resolver thread: resolve due names and put them back on the wheel */
+static void* monitor_resolver(void* arg)
+{
+    monitor* m = (monitor*) arg;
+    struct __res_state res;
+    char oldIP[INET_ADDRSTRLEN];
+    char newIP[INET_ADDRSTRLEN];
+    char hostname[MAX_NAME_LENGTH];
+    unsigned int id;
+    unsigned int addr;
+    int ttl;
+    int ok;
+
+    memset(&res, 0, sizeof(res));
+    if (res_ninit(&res)) {
+        fprintf(stderr, "MONITOR ERROR: Error initializing resolver\n");
+    }
+
+    for (;;) {
+        sem_wait(&m->dueItems);
+        pthread_mutex_lock(&m->dueLock);
+        monitor_due_pop(&m->due, &id);
+        pthread_mutex_unlock(&m->dueLock);
+        sem_post(&m->dueSlots);
+        if (id == WHEEL_NONE) {
+            break;
+        }
+
+        labels_name(&m->names, m->name[id], hostname, sizeof(hostname));
+        ok = monitor_resolve(&res, hostname, &addr, &ttl) == MONITOR_SUCCESS;
+        if (!ok) {
+            ttl = MONITOR_RETRY;
+        }
+        ttl = ttl < MONITOR_MIN_TTL ? MONITOR_MIN_TTL : ttl > m->maxTtl ? m->maxTtl : ttl;
+
+        pthread_mutex_lock(&m->lock);
+        if (ok && addr != m->addr[id]) {
+            oldIP[0] = '\0';
+            if (m->addr[id]) {
+                inet_ntop(AF_INET, &m->addr[id], oldIP, sizeof(oldIP));
+            }
+            inet_ntop(AF_INET, &addr, newIP, sizeof(newIP));
+            fprintf(m->outputfd, "%s,%s,%s\n", hostname, oldIP, newIP);
+            m->addr[id] = addr;
+        }
+        wheel_insert(&m->wheel, id, m->wheel.now + ttl);
+        pthread_mutex_unlock(&m->lock);
+    }
+
+    res_nclose(&res);
+    return NULL;
+}
+
+
+/* Push a name for the resolvers; fails only if interrupted to stop */
+static int monitor_push(monitor* m, unsigned int id)
+{
+    while (sem_wait(&m->dueSlots)) {
+        if (monitorStop) {
+            return MONITOR_FAILURE;
+        }
+    }
+    monitor_due_push(&m->due, &id);
+    sem_post(&m->dueItems);
+    return MONITOR_SUCCESS;
+}
+
+
+/* Turn the wheel once a second until stopped */
+static void monitor_loop(monitor* m)
+{
+    struct timespec wake;
+    long long next;
+    unsigned int tick;
+    unsigned int id;
+    unsigned int after;
+
+    while (!monitorStop) {
+        tick = (monotonic_ns() - m->start) / 1000000000LL;
+
+        pthread_mutex_lock(&m->lock);
+        id = wheel_advance(&m->wheel, tick);
+        pthread_mutex_unlock(&m->lock);
+
+        /* Read each link before the name goes out and comes back */
+        for (; id != WHEEL_NONE; id = after) {
+            after = wheel_next(&m->wheel, id);
+            if (monitor_push(m, id) == MONITOR_FAILURE) {
+                return;
+            }
+        }
+
+        pthread_mutex_lock(&m->lock);
+        fflush(m->outputfd);
+        pthread_mutex_unlock(&m->lock);
+
+        next = m->start + (tick + 1) * 1000000000LL;
+        wake.tv_sec = next / 1000000000LL;
+        wake.tv_nsec = next % 1000000000LL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+    }
+}
+
+
+int monitor_run(char* const* inputPaths, int numInputs, FILE* outputfd,
+                int numResolvers, int idn, int maxTtl)
+{
+    monitor m;
+    struct sigaction sa;
+    struct sigaction oldInt;
+    struct sigaction oldTerm;
+    sigset_t mask;
+    sigset_t oldMask;
+    pthread_t threads[numResolvers];
+    unsigned int i;
+    unsigned int id;
+    int started;
+    int rc = MONITOR_SUCCESS;
+
+    memset(&m, 0, sizeof(m));
+    m.outputfd = outputfd;
+    m.maxTtl = maxTtl;
+
+    if (labels_init(&m.names) == LABELS_FAILURE) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating the label store\n");
+        return MONITOR_FAILURE;
+    }
+    if (monitor_load(&m, inputPaths, numInputs, idn) == MONITOR_FAILURE) {
+        labels_free(&m.names);
+        free(m.name);
+        return MONITOR_FAILURE;
+    }
+    labels_freeze(&m.names);
+    if ((m.addr = calloc(m.count ? m.count : 1, sizeof(*m.addr))) == NULL
+            || wheel_init(&m.wheel, m.count, 0) == WHEEL_FAILURE) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating %u monitored names\n", m.count);
+        free(m.addr);
+        labels_free(&m.names);
+        free(m.name);
+        return MONITOR_FAILURE;
+    }
+    fprintf(stderr, "MONITOR: Watching %u names in %lu bytes of labels\n",
+            m.count, (unsigned long) labels_bytes(&m.names));
+
+    /* Every name is due at the first tick */
+    for (i = 0; i < m.count; ++i) {
+        wheel_insert(&m.wheel, i, 0);
+    }
+
+    monitor_due_init(&m.due);
+    pthread_mutex_init(&m.lock, NULL);
+    pthread_mutex_init(&m.dueLock, NULL);
+    sem_init(&m.dueSlots, 0, monitor_due_capacity);
+    sem_init(&m.dueItems, 0, 0);
+
+    /* Stop on SIGINT/SIGTERM; only this thread takes them */
+    monitorStop = 0;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = monitor_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, &oldInt);
+    sigaction(SIGTERM, &sa, &oldTerm);
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &oldMask);
+
+    for (started = 0; started < numResolvers; ++started) {
+        if (pthread_create(&threads[started], NULL, monitor_resolver, &m)) {
+            fprintf(stderr, "PTHREAD ERROR: Error creating monitor resolver\n");
+            rc = MONITOR_FAILURE;
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+
+    m.start = monotonic_ns();
+    if (rc == MONITOR_SUCCESS) {
+        monitor_loop(&m);
+    }
+
+    /* One stop marker per resolver, queued behind any due names */
+    for (i = 0; i < (unsigned int) started; ++i) {
+        while (sem_wait(&m.dueSlots) && errno == EINTR) {
+        }
+        id = WHEEL_NONE;
+        monitor_due_push(&m.due, &id);
+        sem_post(&m.dueItems);
+    }
+    for (i = 0; i < (unsigned int) started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    sigaction(SIGINT, &oldInt, NULL);
+    sigaction(SIGTERM, &oldTerm, NULL);
+    sem_destroy(&m.dueSlots);
+    sem_destroy(&m.dueItems);
+    pthread_mutex_destroy(&m.dueLock);
+    pthread_mutex_destroy(&m.lock);
+    wheel_free(&m.wheel);
+    free(m.addr);
+    labels_free(&m.names);
+    free(m.name);
+    return rc;
+}
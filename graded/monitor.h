@@ -0,0 +1,44 @@
+/******************************************************************************
+ * FILE: monitor.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for the continuous monitoring mode.
+ *  Every hostname is resolved once, then again each time its DNS record's
+ *      TTL runs out. Due names are kept in a timer wheel (see wheel.h) with
+ *      one-second ticks and fed to a pool of resolver threads; only
+ *      changes of address are written out, as "hostname,oldIP,newIP".
+ *  The mode runs until SIGINT or SIGTERM.
+ *
+ ******************************************************************************/
+
+#ifndef MONITOR_H
+#define MONITOR_H
+
+/* Standard Includes */
+#include <stdio.h>
+
+
+#define MONITOR_FAILURE         -1
+#define MONITOR_SUCCESS         0
+
+#define MONITOR_QUEUE_LOG2      10      // Due names waiting for a resolver
+#define MONITOR_MIN_TTL         1       // Seconds
+#define MONITOR_MAX_TTL         86400   // Default and largest --max-ttl
+#define MONITOR_DEFAULT_TTL     300     // For names answered outside DNS (hosts file)
+#define MONITOR_RETRY           60      // After a failed lookup
+#define MONITOR_PACKET_SIZE     4096    // DNS answer buffer
+
+
+/* Function to watch every name in the input files with numResolvers
+ * threads, writing address changes to outputfd until interrupted
+ * Names are normalized first (see normalize.h); idn enables punycode
+ * Names are re-resolved at least every maxTtl seconds
+ * Returns MONITOR_SUCCESS, or MONITOR_FAILURE if it could not be set up
+ */
+int monitor_run(char* const* inputPaths, int numInputs, FILE* outputfd,
+                int numResolvers, int idn, int maxTtl);
+
+#endif
@@ -6,14 +6,49 @@
  * MODIFY DATE: 02/22/2013
  * DESCRIPTION:
  *  A multi-threaded application that resolves domain names to IP addresses.
- *  The application is composed of two sub-systems, each with one thread pool:
- *  requesters and resolvers.
- *  The number of requester threads spawned is based on the number of input
- *  files given.
+ *  The application is a pipeline of three stages, each with its own thread
+ *  pool: requesters read, resolvers resolve and writers write (pipeline.h).
+ *  Bounded queues between the stages pass backpressure upstream, and each
+ *  stage finishes once the one before it has finished and it has drained;
+ *  --stats shows how busy each stage was.
+ *  A fixed pool of requester threads takes the input files in turn, opening
+ *  each one's successor ahead of time, so thousands of files (named on the
+ *  command line, by glob, by directory or in a manifest) need no more threads.
  *  The number of resolver threads spawned is based dynamically on the number
  *  of cores available on the machine running the executable.
  *  The two sub-systems communicate with each other using
- *  a bounded queue.
+ *  a bounded multi-level queue with one level per priority class; input files
+ *  may be given a priority class and a deadline on the command line.
+ *  Queue slots within a class are shared between input files by weighted
+ *  deficit round-robin, so a large file cannot crowd out a small one.
+ *  The resolver pool and queue live in a libmultilookup context (mlookup.h);
+ *  this program reads the input files into it and writes what comes out.
+ *  Queue size, resolver count and resolver batch size come from a tuned
+ *  profile when one exists; --tune fits them to a sample of the input.
+ *  A sample of hostnames can be traced end to end with --trace.
+ *  --monitor keeps re-resolving the names as their TTLs expire and reports
+ *  only address changes.
+ *  --shards partitions the output across several files, each with its own
+ *  lock, so writers do not queue behind one stream.
+ *  --affinity routes each hostname to one resolver by hash, so repeats of a
+ *  name hit that resolver's private cache; a backed-up resolver spills
+ *  names to a shared overflow queue the others drain.
+ *  --queue-mb replaces the fixed queue with segmented queues that grow on
+ *  demand up to a memory ceiling, so requesters read ahead of the resolvers.
+ *  --backlog-dir keeps the queue small in memory and sends the rest of the
+ *  names to temporary files, read back in order as the resolvers catch up.
+ *  --exclude skips names on known-dead lists and blocklists before they are
+ *  queued; --build-exclude turns such lists into a filter file once, so a
+ *  run can map it instead of reading the lists.
+ *  --ptr takes IPv4 address ranges in place of input files and finds the
+ *  name each address points back to; the requesters generate the addresses
+ *  a chunk at a time, so a range costs no more memory than a single address.
+ *  --aggregate rolls the results up by address, prefix and family as they
+ *  are written, instead of in a second pass over the output.
+ *  --diff compares the results with a previous run's output as they are
+ *  written, and writes only the hostnames added, removed or changed.
+ *  --checkpoint saves progress every few megabytes of output so an
+ *  interrupted run can pick up where it stopped with --resume.
  *
  ******************************************************************************/
 
@@ -23,316 +58,1752 @@
 //#define LOOKUP_DEBUG
 
 /* Setup Shared/Global Variables */
-FILE*           outputfd = NULL;
-int             reqRunning; // Flag to notify resolvers when all requesters done
-queue           buffer;     // Shared buffer
-sem_t           full,       // Synch, requesters wait if queue full
-                empty,      // Synch, resolvers wait if queue empty
-                resBegin;   // Synch, requesters notify resolvers to begin
-pthread_mutex_t qmutex,     // Mutex for queue
-                fmutex;     // Mutex for output file
+int             idnEnabled = 0; // Convert non-ASCII names to punycode
+int             affinity = 0;   // Route names to resolvers by hash (mlookup.h)
+long            cacheEntries = ML_CACHE_ENTRIES;    // Per resolver, with affinity
+long            spillDepth = ML_SPILL_DEPTH;        // 0 to never spill
+long            queueMb = 0;    // Segmented queue ceiling, 0 for the fixed queue
+const char*     backlogDir = NULL;  // Directory for the queue's backlog files
+int             ptrMode = 0;    // Inputs are address ranges to reverse lookup
+exclude_list    excludes = {NULL, 0};   // Names never looked up
+cfile           output;     // Output file, possibly compressed
 
+/* The default queue size must fit in a dispatch level */
+_Static_assert(QUEUE_SIZE <= dispatch_level_capacity,
+               "QUEUE_SIZE exceeds the dispatch level capacity");
 
-int main(int argc, char *argv[])
+/* Checkpoints track an input's names in flight in a fixed window: at most a
+ * full level, every resolver's batch, the write queue and every writer's
+ * batch, and the batch being submitted */
+_Static_assert(dispatch_level_capacity + TUNE_MAX_RESOLVERS * TUNE_MAX_BATCH
+               + WRITE_QUEUE_SIZE + MAX_WRITER_THREADS * ML_MAX_BATCH
+               + NORMALIZE_BATCH < CKPT_WINDOW,
+               "Names in flight exceed the checkpoint window");
+
+/* Every result line must fit a sort buffer line */
+_Static_assert(SORT_LINE_LENGTH + 1 <= EXTSORT_MAX_LINE,
+               "SORT_LINE_LENGTH exceeds the external sort line length");
+
+static const struct option longOptions[] = {
+    {"priority",    required_argument,  NULL,   'p'},
+    {"deadline",    required_argument,  NULL,   'd'},
+    {"workers",     required_argument,  NULL,   'm'},
+    {"compress",    required_argument,  NULL,   'z'},
+    {"idn",         no_argument,        NULL,   'i'},
+    {"tune",        required_argument,  NULL,   'T'},
+    {"profile",     required_argument,  NULL,   'P'},
+    {"trace",       required_argument,  NULL,   't'},
+    {"trace-sample", required_argument, NULL,   's'},
+    {"weight",      required_argument,  NULL,   'w'},
+    {"stats",       no_argument,        NULL,   'S'},
+    {"monitor",     no_argument,        NULL,   'M'},
+    {"dual-stack",  no_argument,        NULL,   'D'},
+    {"all-addrs",   no_argument,        NULL,   'A'},
+    {"max-ttl",     required_argument,  NULL,   'X'},
+    {"checkpoint",  required_argument,  NULL,   'c'},
+    {"requesters",  required_argument,  NULL,   'r'},
+    {"writers",     required_argument,  NULL,   'W'},
+    {"affinity",    no_argument,        NULL,   'a'},
+    {"cache",       required_argument,  NULL,   'C'},
+    {"spill",       required_argument,  NULL,   'V'},
+    {"queue-mb",    required_argument,  NULL,   'Q'},
+    {"backlog-dir", required_argument,  NULL,   'U'},
+    {"exclude",     required_argument,  NULL,   'x'},
+    {"build-exclude", required_argument, NULL,  'J'},
+    {"ptr",         no_argument,        NULL,   'H'},
+    {"shards",      required_argument,  NULL,   'N'},
+    {"shard-by",    required_argument,  NULL,   'B'},
+    {"aggregate",   no_argument,        NULL,   'G'},
+    {"sort",        no_argument,        NULL,   'O'},
+    {"sort-run",    required_argument,  NULL,   'Y'},
+    {"sort-fanin",  required_argument,  NULL,   'K'},
+    {"diff",        required_argument,  NULL,   'E'},
+    {"dir",         required_argument,  NULL,   'L'},
+    {"manifest",    required_argument,  NULL,   'F'},
+    {"resume",      no_argument,        NULL,   'R'},
+    {NULL,          0,                  NULL,   0}
+};
+
+static const char* priorityNames[NUM_PRIORITY_CLASSES] = {
+    "urgent", "normal", "bulk"
+};
+
+
+/* Parse a priority class given by name or number, -1 if invalid */
+static int parse_priority(const char* arg)
+{
+    int i;
+    char* end;
+    long val;
+
+    for (i = 0; i < NUM_PRIORITY_CLASSES; ++i) {
+        if (!strcmp(arg, priorityNames[i])) {
+            return i;
+        }
+    }
+    val = strtol(arg, &end, 10);
+    if (*end != '\0' || end == arg || val < 0 || val >= NUM_PRIORITY_CLASSES) {
+        return -1;
+    }
+    return (int) val;
+}
+
+
+/* Append an input file with the scheduling options of opts, keeping a
+ * copy of path
+ * Returns 0, or -1 if out of memory
+ */
+static int add_source(source_list* list, const char* path, const input_source* opts)
+{
+    input_source* items;
+    unsigned int capacity;
+
+    if (list->count == list->capacity) {
+        capacity = list->capacity ? 2 * list->capacity : 64;
+        if ((items = realloc(list->items, capacity * sizeof(*items))) == NULL) {
+            return -1;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    items = &list->items[list->count];
+    *items = *opts;
+    if ((items->path = strdup(path)) == NULL) {
+        return -1;
+    }
+    list->count++;
+    return 0;
+}
+
+
+/* Append the files matching a glob pattern, or the argument itself when it
+ * has no wildcards or matches nothing
+ * Returns the number of files added, or -1 if out of memory
+ */
+static int add_glob(source_list* list, const char* pattern, const input_source* opts)
+{
+    glob_t matches;
+    size_t i;
+    int added = 0;
+
+    if (!strpbrk(pattern, "*?[") || glob(pattern, 0, NULL, &matches)) {
+        return add_source(list, pattern, opts) ? -1 : 1;
+    }
+    for (i = 0; i < matches.gl_pathc; ++i) {
+        if (add_source(list, matches.gl_pathv[i], opts)) {
+            added = -1;
+            break;
+        }
+        added++;
+    }
+    globfree(&matches);
+    return added;
+}
+
+
+static int visible_entry(const struct dirent* entry)
+{
+    return entry->d_name[0] != '.';
+}
+
+
+/* Append every regular file in a directory, in name order
+ * Returns 0, or -1 (errno set)
+ */
+static int add_dir(source_list* list, const char* dir, const input_source* opts)
+{
+    struct dirent** entries;
+    struct stat st;
+    char path[PATH_MAX];
+    int count;
+    int rc = 0;
+    int i;
+
+    if ((count = scandir(dir, &entries, visible_entry, alphasort)) < 0) {
+        return -1;
+    }
+    for (i = 0; i < count; ++i) {
+        snprintf(path, sizeof(path), "%s/%s", dir, entries[i]->d_name);
+        if (!rc && !stat(path, &st) && S_ISREG(st.st_mode)) {
+            rc = add_source(list, path, opts);
+        }
+        free(entries[i]);
+    }
+    free(entries);
+    return rc;
+}
+
+
+/* Append the files listed one per line in a manifest, skipping blank lines
+ * and lines starting with '#'
+ * Returns 0, or -1 (errno set)
+ */
+static int add_manifest(source_list* list, const char* manifest, const input_source* opts)
+{
+    FILE* fp;
+    char* line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+    int rc = 0;
+
+    if ((fp = fopen(manifest, "r")) == NULL) {
+        return -1;
+    }
+    while (!rc && (len = getline(&line, &cap, fp)) >= 0) {
+        while (len > 0 && isspace((unsigned char) line[len - 1])) {
+            line[--len] = '\0';
+        }
+        if (len > 0 && line[0] != '#') {
+            rc = add_source(list, line, opts);
+        }
+    }
+    free(line);
+    fclose(fp);
+    return rc;
+}
+
+
+/* Free the list and its copies of the paths */
+static void free_sources(source_list* list)
 {
-    /* Setup Local Variables */
     unsigned int i;
-    int rc;             // Return code from pthread_create() call
-    void* status = 0;   // Return value from thread from pthread_join() call
-    /* Create one requester thread per input file */
-    unsigned int numRequesterThreads = argc - 2;
-    reqRunning = numRequesterThreads;
-    /* Create as many resolver threads as cores */
-    unsigned int numResolverThreads = sysconf( _SC_NPROCESSORS_ONLN );
 
-    /* Verify Correct Usage */
-    if (argc < MIN_ARGS) {
-        fprintf(stderr, "USAGE ERROR: Not enough arguments: %d\n", (argc - 1));
-        fprintf(stderr, "Usage:\n  %s %s\n", argv[0], USAGE);
-        return ERR_ARGS;
+    for (i = 0; i < list->count; ++i) {
+        free(list->items[i].path);
     }
+    free(list->items);
+}
 
-    /* Verify Minimum Resolver Thread Limit */
-    if (numResolverThreads < MIN_RESOLVER_THREADS) {
-        fprintf(stderr, "WARNING: Program must provide at least %d resolver threads",
-                MIN_RESOLVER_THREADS);
-        numResolverThreads = 2;
+
+/* Read up to NORMALIZE_BATCH names; longer names come back cut short and
+ * are rejected as too long */
+static int read_batch(FILE* inputfd, char raw[][MAX_NAME_LENGTH])
+{
+    int count = 0;
+
+    while (count < NORMALIZE_BATCH && normalize_read(inputfd, raw[count]) != EOF) {
+        count++;
     }
+    return count;
+}
 
-    /* Setup Requester/Resolver Thread Arrays */
-    pthread_t reqThreads[numRequesterThreads];
-    pthread_t resThreads[numResolverThreads];
 
-    /* Open Output File */
-    outputfd = fopen(argv[argc-1], "w");
-    if (!outputfd) {
-        fprintf(stderr, "FILE ERROR: Error opening output file [%s]: %s\n",
-                argv[argc-1], strerror(errno));
-        return ERR_FOPEN;
+/* Text written after a result's hostname: the first address or status, or
+ * every address, formatted into all */
+static const char* result_value(const output_sink* sink, const ml_result* result,
+                                char all[ADDRSET_TEXT_LENGTH])
+{
+    if (sink->allAddrs && result->addrs.count > 1) {
+        addrset_format(&result->addrs, 1, all, ADDRSET_TEXT_LENGTH);
+        return all;
     }
+    return result->result;
+}
+
+
+/* Write one result line, returning the bytes written */
+static int write_result(const output_sink* sink, const ml_result* result, FILE* fp)
+{
+    char all[ADDRSET_TEXT_LENGTH];
+
+    return fprintf(fp, "%s,%s\n", result->hostname, result_value(sink, result, all));
+}
+
+
+/* Write a batch of results across the output shards, holding one shard's
+ * lock at a time; per-file counts are shared between shards */
+static void write_sharded(output_sink* sink, const ml_result* results, int count,
+                          long long now)
+{
+    output_shard* held = NULL;
+    output_shard* shard;
+    input_source* src;
+    int i;
 
-    /* Initialize Bounded Queue */
-    if (queue_init(&buffer, QUEUE_SIZE) == QUEUE_FAILURE) {
-        fprintf(stderr, "QUEUE ERROR: init failed!\n");
+    for (i = 0; i < count; ++i) {
+        shard = &sink->shards[(sink->shardByFile
+                               ? (unsigned long long) results[i].source
+                               : fnv1a_hash(results[i].hostname)) % sink->numShards];
+        if (shard != held) {
+            if (held) {
+                pthread_mutex_unlock(&held->lock);
+            }
+            pthread_mutex_lock(&shard->lock);
+            held = shard;
+        }
+        write_result(sink, &results[i], shard->file.fp);
+        shard->lines++;
+
+        src = &sink->sources[results[i].source];
+        __atomic_fetch_add(&src->written, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&src->finished, now, __ATOMIC_RELAXED);
+    }
+    if (held) {
+        pthread_mutex_unlock(&held->lock);
     }
+}
 
-    /* Initialize Semaphores and Mutexes */
-    if (sem_init(&full, 0, QUEUE_SIZE)) {
-        fprintf(stderr, "SEMAPHORE ERROR: Error initializing semaphore 'full': %s\n",
-                strerror(errno));
-        return ERR_SEMAPHORE;
+
+/* Add a batch of results to the writing thread's sort buffer; per-file
+ * counts are shared between writers */
+static void write_sorted(output_sink* sink, const ml_result* results, int count,
+                         long long now)
+{
+    char all[ADDRSET_TEXT_LENGTH];
+    char line[SORT_LINE_LENGTH];
+    input_source* src;
+    int len;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        len = snprintf(line, sizeof(line), "%s,%s", results[i].hostname,
+                       result_value(sink, &results[i], all));
+        /* A failure is kept by the sort and reported when it finishes */
+        extsort_add(sink->sort, line, len);
+
+        src = &sink->sources[results[i].source];
+        __atomic_fetch_add(&src->written, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&src->finished, now, __ATOMIC_RELAXED);
     }
-    if (sem_init(&empty, 0, 0)) {
-        fprintf(stderr, "SEMAPHORE ERROR: Error initializing semaphore 'empty': %s\n",
-                strerror(errno));
-        return ERR_SEMAPHORE;
+}
+
+
+/* Write the added and changed results of a batch to the one output file,
+ * comparing outside its lock */
+static void write_diff(output_sink* sink, const ml_result* results, int count,
+                       long long now)
+{
+    char all[ADDRSET_TEXT_LENGTH];
+    const char* value;
+    input_source* src;
+    int found[ML_MAX_BATCH];
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        found[i] = diff_check(sink->diff, results[i].hostname,
+                              result_value(sink, &results[i], all));
     }
-    if (sem_init(&resBegin, 0, 0)) {
-        fprintf(stderr, "SEMAPHORE ERROR: Error initializing semaphore 'resBegin': %s\n",
-                strerror(errno));
-        return ERR_SEMAPHORE;
+
+    pthread_mutex_lock(&sink->lock);
+    for (i = 0; i < count; ++i) {
+        if (found[i] == DIFF_ADDED || found[i] == DIFF_CHANGED) {
+            value = result_value(sink, &results[i], all);
+            fprintf(sink->fp, "%c%s,%s\n", found[i] == DIFF_ADDED ? '+' : '~',
+                    results[i].hostname, value);
+        }
+        src = &sink->sources[results[i].source];
+        src->written++;
+        src->finished = now;
     }
-    if (pthread_mutex_init(&qmutex, NULL)) {
-        fprintf(stderr, "MUTEX ERROR: Error initializing mutex 'qmutex': %s\n",
-                strerror(errno));
-        return ERR_MUTEX;
+    pthread_mutex_unlock(&sink->lock);
+}
+
+
+/* Write a batch of results to the one output file, holding its lock once */
+static void write_single(output_sink* sink, const ml_result* results, int count,
+                         long long now)
+{
+    input_source* src;
+    int bytes;
+    int i;
+
+    pthread_mutex_lock(&sink->lock);
+    for (i = 0; i < count; ++i) {
+        bytes = write_result(sink, &results[i], sink->fp);
+        src = &sink->sources[results[i].source];
+        src->written++;
+        src->finished = now;
+        if (src->ckpt) {
+            ckpt_written(src->ckpt, results[i].tag);
+            sink->sinceCkpt += bytes > 0 ? bytes : 0;
+        }
     }
-    if (pthread_mutex_init(&fmutex, NULL)) {
-        fprintf(stderr, "MUTEX ERROR: Error initializing mutex 'fmutex': %s\n",
-                strerror(errno));
-        return ERR_MUTEX;
+
+    /* Checkpoint from the writer path, so the output length is exact */
+    if (sink->ckptPath && sink->sinceCkpt >= sink->ckptEvery) {
+        if (ckpt_save(sink->ckptPath, sink->fp, sink->ckpts,
+                      sink->paths, sink->numSources) == CKPT_FAILURE) {
+            fprintf(stderr, "FILE WARNING: Error writing checkpoint [%s]: %s\n",
+                    sink->ckptPath, strerror(errno));
+        }
+        sink->sinceCkpt = 0;
     }
+    pthread_mutex_unlock(&sink->lock);
+}
+
 
-    /* Spawn Requester Threads */
-    for (i = 0; i < numRequesterThreads; ++i) {
-        rc = pthread_create(&reqThreads[i], NULL, requester, argv[i+1]);
-        if (rc) {
-            fprintf(stderr, "PTHREAD ERROR: Return code from pthread_create() is %d\n", rc);
-            return ERR_PTHREAD_CREATE;
+/* Count a written result in the rollups, by the addresses written for it */
+static void aggregate_result(const output_sink* sink, const ml_result* result)
+{
+    addrset set;
+    unsigned char bytes[16];
+
+    /* Names rejected before queueing, or dropped at their deadline, were
+     * never looked up, so they did not fail */
+    if (result->latency == 0 || !strcmp(result->result, ML_STATUS_DEADLINE)) {
+        agg_skip(result->hostname, result->result);
+        return;
+    }
+    if (sink->allAddrs) {
+        agg_record(result->hostname, &result->addrs, result->result);
+        return;
+    }
+    set.count = 0;
+    if (inet_pton(AF_INET, result->result, bytes) == 1) {
+        addrset_add(&set, AF_INET, bytes);
+    }
+    else if (inet_pton(AF_INET6, result->result, bytes) == 1) {
+        addrset_add(&set, AF_INET6, bytes);
+    }
+    agg_record(result->hostname, &set, result->result);
+}
+
+
+/* Write a batch of results as they come from the write queue */
+static void write_results(const ml_result* results, int count, void* arg)
+{
+    output_sink* sink = (output_sink*) arg;
+    long long now = monotonic_ns();
+    int i;
+
+    if (sink->numShards) {
+        write_sharded(sink, results, count, now);
+    }
+    else if (sink->sort) {
+        write_sorted(sink, results, count, now);
+    }
+    else if (sink->diff) {
+        write_diff(sink, results, count, now);
+    }
+    else {
+        write_single(sink, results, count, now);
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (results[i].latency) {
+            latency_record(&sink->latency, results[i].latency);
+        }
+        if (sink->aggregate) {
+            aggregate_result(sink, &results[i]);
         }
     }
+}
+
 
-    /* Spawn Resolver Threads */
-    for (i = 0; i < numResolverThreads; ++i) {
-        rc = pthread_create(&resThreads[i], NULL, resolver, NULL);
-        if (rc) {
-            fprintf(stderr, "PTHREAD ERROR: Return code from pthread_create() is %d\n", rc);
-            return ERR_PTHREAD_CREATE;
+/* Hand resolved names to the write stage, waiting while its queue is full */
+static void queue_results(const ml_result* results, int count, void* arg)
+{
+    output_sink* sink = (output_sink*) arg;
+
+    pipeline_push(sink->writer, results, count);
+}
+
+
+/* Write stage: write a batch of results taken off the queue */
+static int write_stage(pipeline_worker* w, void* items, int count, void* arg)
+{
+    (void) w;
+
+    write_results((const ml_result*) items, count, arg);
+    return PIPELINE_MORE;
+}
+
+
+/* Resolve stage: once the readers are done, wait for the resolvers to hand
+ * on every name they were given */
+static void drain_resolvers(void* ctx)
+{
+    ml_drain((ml_context*) ctx);
+}
+
+
+/* Open numShards output files named after the manifest at path
+ * Returns 0, or -1 (errno set) with every shard closed
+ */
+static int open_shards(output_sink* sink, const char* path, int numShards, int format)
+{
+    output_shard* shard;
+    int saved;
+    int i;
+
+    if ((sink->shards = calloc(numShards, sizeof(*sink->shards))) == NULL) {
+        return -1;
+    }
+    for (i = 0; i < numShards; ++i) {
+        shard = &sink->shards[i];
+        if ((shard->path = malloc(strlen(path) + 16)) == NULL) {
+            break;
+        }
+        sprintf(shard->path, OUTPUT_SHARD_NAME, path, i);
+        if (cfile_open_write(&shard->file, shard->path, format) == CFILE_FAILURE) {
+            free(shard->path);
+            break;
         }
+        setvbuf(shard->file.fp, NULL, _IOFBF, OUTPUT_SHARD_BUFFER);
+        pthread_mutex_init(&shard->lock, NULL);
     }
+    if (i < numShards) {
+        saved = errno;
+        while (i-- > 0) {
+            cfile_close(&sink->shards[i].file);
+            pthread_mutex_destroy(&sink->shards[i].lock);
+            free(sink->shards[i].path);
+        }
+        free(sink->shards);
+        errno = saved;
+        return -1;
+    }
+    sink->numShards = numShards;
+    return 0;
+}
 
-    /* Wait for All Requester Threads to Finish */
-    for (i = 0; i < numRequesterThreads; ++i) {
-        pthread_join(reqThreads[i], &status);
-#ifdef LOOKUP_DEBUG
-        printf("REQUESTER THREAD #%d FINISHED\n", i+1);
-#endif
+
+/* Close every shard, then list them in the manifest at path
+ * Returns 0, or -1 if a shard or the manifest could not be written
+ */
+static int close_shards(output_sink* sink, const char* path)
+{
+    FILE* manifest;
+    int rc = 0;
+    int i;
+
+    for (i = 0; i < sink->numShards; ++i) {
+        if (cfile_close(&sink->shards[i].file)) {
+            fprintf(stderr, "FILE ERROR: Error closing output shard [%s]: %s\n",
+                    sink->shards[i].path, strerror(errno));
+            rc = -1;
+        }
+        pthread_mutex_destroy(&sink->shards[i].lock);
     }
 
-    /* In case all input files were bogus, notify resolver threads to stop sleeping */
-    sem_post(&resBegin);
+    /* The manifest doubles as a --manifest input list */
+    if ((manifest = fopen(path, "w")) == NULL) {
+        rc = -1;
+    }
+    else {
+        fprintf(manifest, "# %d shards by %s\n", sink->numShards,
+                sink->shardByFile ? "file" : "host");
+        for (i = 0; i < sink->numShards; ++i) {
+            fprintf(manifest, "%s\n", sink->shards[i].path);
+        }
+        if (fclose(manifest)) {
+            rc = -1;
+        }
+    }
 
-#ifdef LOOKUP_DEBUG
-    printf("FINISHED ALL REQUESTER THREADS\n");
-#endif
+    for (i = 0; i < sink->numShards; ++i) {
+        free(sink->shards[i].path);
+    }
+    free(sink->shards);
+    sink->shards = NULL;
+    sink->numShards = 0;
+    return rc;
+}
 
-    /* Wait for All Resolver Threads to Finish */
-    for (i = 0; i < numResolverThreads; ++i) {
-        pthread_join(resThreads[i], &status);
-#ifdef LOOKUP_DEBUG
-        printf("RESOLVER THREAD #%d FINISHED\n", i+1);
-#endif
+
+/* Skip a name found in any exclusion filter */
+static int is_excluded(const char* hostname, void* arg)
+{
+    exclude_list* list = (exclude_list*) arg;
+    int i;
+
+    for (i = 0; i < list->count; ++i) {
+        if (exclude_match(&list->filters[i], hostname)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/* Add the names of an exclusion list to a filter being built, normalized
+ * as input names are; names that do not normalize are left out
+ * Returns 0, or -1 (errno set) if the list cannot be read
+ */
+static int read_exclude_list(exclude_builder* b, const char* path)
+{
+    char raw[MAX_NAME_LENGTH];
+    char name[MAX_NAME_LENGTH];
+    cfile list;
+    int code;
+    int err;
+
+    if (cfile_open_read(&list, path) == CFILE_FAILURE) {
+        return -1;
+    }
+    while ((code = normalize_read(list.fp, raw)) != EOF) {
+        if (code == NAME_OK && normalize_name(raw, name, idnEnabled) == NAME_OK
+                && exclude_builder_add(b, name) == EXCLUDE_FAILURE) {
+            err = errno;
+            cfile_close(&list);
+            errno = err;
+            return -1;
+        }
+    }
+    return cfile_close(&list) ? -1 : 0;
+}
+
+
+/* Free every exclusion filter */
+static void free_excludes(exclude_list* list)
+{
+    int i;
+
+    for (i = 0; i < list->count; ++i) {
+        exclude_free(&list->filters[i]);
+    }
+    free(list->filters);
+    list->filters = NULL;
+    list->count = 0;
+}
+
+
+/* Load each --exclude path: filter files are mapped as they are, and name
+ * lists are built together into one more filter
+ * Returns EXIT_SUCCESS, or ERR_FOPEN or ERR_MALLOC
+ */
+static int load_excludes(exclude_list* list, char** paths, int count)
+{
+    exclude_builder builder;
+    int lists = 0;
+    int i;
+
+    if ((list->filters = calloc(count + 1, sizeof(*list->filters))) == NULL) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating exclusion filters\n");
+        return ERR_MALLOC;
+    }
+    exclude_builder_init(&builder);
+    for (i = 0; i < count; ++i) {
+        if (exclude_is_image(paths[i])) {
+            if (exclude_load(&list->filters[list->count], paths[i]) == EXCLUDE_FAILURE) {
+                fprintf(stderr, "FILE ERROR: Error loading exclusion filter [%s]: %s\n",
+                        paths[i], strerror(errno));
+                exclude_builder_free(&builder);
+                free_excludes(list);
+                return ERR_FOPEN;
+            }
+            list->count++;
+        }
+        else if (read_exclude_list(&builder, paths[i])) {
+            fprintf(stderr, "FILE ERROR: Error reading exclusion list [%s]: %s\n",
+                    paths[i], strerror(errno));
+            exclude_builder_free(&builder);
+            free_excludes(list);
+            return ERR_FOPEN;
+        }
+        else {
+            lists++;
+        }
+    }
+    if (lists && exclude_build(&builder, &list->filters[list->count]) == EXCLUDE_FAILURE) {
+        fprintf(stderr, "MALLOC ERROR: Error building exclusion filter\n");
+        exclude_builder_free(&builder);
+        free_excludes(list);
+        return ERR_MALLOC;
+    }
+    list->count += lists > 0;
+    exclude_builder_free(&builder);
+    return EXIT_SUCCESS;
+}
+
+
+/* Print how many names the exclusion filters skipped; every name checked
+ * goes through the first */
+static void report_excludes(const exclude_list* list)
+{
+    unsigned long matches = 0;
+    unsigned long falsePositives = 0;
+    int i;
+
+    for (i = 0; i < list->count; ++i) {
+        matches += list->filters[i].matches;
+        falsePositives += list->filters[i].bloomHits - list->filters[i].matches;
+    }
+    fprintf(stderr, "EXCLUDE: %lu of %lu names skipped, %lu Bloom filter false positives\n",
+            matches, list->filters[0].checked, falsePositives);
+}
+
+
+/* Run one requester thread per source against a pipeline context until
+ * every name has been written to the sink */
+static int run_pipeline(input_source* sources, unsigned int numSources,
+                        const tune_params* params, unsigned int requesters,
+                        unsigned int writers, output_sink* sink, int stats)
+{
+    unsigned int i;
+    unsigned int numReaders = numSources < requesters && !ptrMode ? numSources : requesters;
+    requester_pool pool = {sources, numSources, 0, ptrMode};
+    pipeline stages;
+    pipeline_stage* resolve;
+    ml_source* mlSources;
+    ml_options opts;
+    ml_stats resolved;
+    ml_context* ctx;
+    int rc = EXIT_SUCCESS;
+
+    ml_default_options(&opts);
+    opts.resolvers = params->resolvers;
+    opts.queueSize = params->queueSize;
+    opts.batch = params->batch;
+    opts.agingThreshold = AGING_THRESHOLD;
+    opts.idn = idnEnabled;
+    opts.dualStack = sink->dualStack;
+    opts.reverse = ptrMode;
+    opts.affinity = affinity;
+    opts.cacheSize = (int) cacheEntries;
+    opts.spillDepth = (int) spillDepth;
+    opts.queueBytes = queueMb * 1024 * 1024;
+    opts.backlogDir = backlogDir;
+    opts.exclude = excludes.count ? is_excluded : NULL;
+    opts.excludeArg = &excludes;
+
+    sink->sources = sources;
+    if ((mlSources = malloc(numSources * sizeof(*mlSources))) == NULL) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating sources\n");
+        return ERR_MALLOC;
+    }
+    for (i = 0; i < numSources; ++i) {
+        mlSources[i].priority = sources[i].priority;
+        mlSources[i].weight = sources[i].weight;
+        mlSources[i].deadline = sources[i].deadline;
+        sources[i].id = i;
+        sources[i].written = 0;
+        sources[i].finished = 0;
+    }
+
+    /* Start the Resolver Pool */
+    ctx = ml_create(&opts, mlSources, numSources, queue_results, sink);
+    free(mlSources);
+    if (ctx == NULL) {
+        fprintf(stderr, "PTHREAD ERROR: Error starting resolver pool: %s\n",
+                strerror(errno));
+        return ERR_PTHREAD_CREATE;
+    }
+    for (i = 0; i < numSources; ++i) {
+        sources[i].ctx = ctx;
     }
 
+    /* Read -> Resolve -> Write, Each Stage with Its Own Pool; the Resolvers
+     * Belong to ctx */
+    pipeline_init(&stages);
+    if (pipeline_add_stage(&stages, "read", numReaders ? numReaders : 1, 1, 0, 0,
+                           requester, NULL, &pool) == NULL
+            || (resolve = pipeline_add_stage(&stages, "resolve", opts.resolvers, opts.batch,
+                                             0, 0, NULL, drain_resolvers, ctx)) == NULL
+            || (sink->writer = pipeline_add_stage(&stages, "write", writers, ML_MAX_BATCH,
+                                                  WRITE_QUEUE_SIZE, sizeof(ml_result),
+                                                  write_stage, NULL, sink)) == NULL) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating pipeline stages\n");
+        ml_destroy(ctx);
+        pipeline_free(&stages);
+        return ERR_MALLOC;
+    }
+
+    /* Run Until the Last Result Is Written; Completion Cascades From the
+     * Readers Through the Resolvers to the Writers */
+    if (pipeline_run(&stages) == PIPELINE_FAILURE) {
+        rc = ERR_PTHREAD_CREATE;
+    }
+
+    /* Resolvers still waiting for names have not counted that wait yet, so
+     * idle is whatever time they were neither busy nor blocked */
+    ml_get_stats(ctx, &resolved);
+    resolve->items = resolved.names;
+    resolve->busy = resolved.busy;
+    resolve->blocked = resolved.blocked;
+    resolve->idle = opts.resolvers * stages.elapsed - resolved.busy - resolved.blocked;
+    if (resolve->idle < 0) {
+        resolve->idle = 0;
+    }
+    ml_destroy(ctx);
+
 #ifdef LOOKUP_DEBUG
     printf("FINISHED ALL RESOLVER THREADS\n");
 #endif
 
-    /* Close Output File */
-    if (fclose(outputfd)) {
-        fprintf(stderr, "FILE ERROR: Error closing output file [%s]: %s\n",
-                argv[argc-1], strerror(errno));
+    if (stats) {
+        pipeline_report(&stages, stderr);
+        if (affinity) {
+            fprintf(stderr, "AFFINITY: %lu of %lu names answered from resolver caches, "
+                    "%lu spilled to the overflow queue\n",
+                    resolved.cacheHits, resolved.names, resolved.spilled);
+        }
+        if (queueMb) {
+            fprintf(stderr, "QUEUE: peak %.1f MB of segments, ceiling %ld MB\n",
+                    resolved.queuePeak / (1024.0 * 1024.0), queueMb);
+        }
+        if (excludes.count) {
+            report_excludes(&excludes);
+        }
+        if (backlogDir) {
+            fprintf(stderr, "BACKLOG: %lu names queued on disk, files peaked at %.1f MB\n",
+                    resolved.backlogged, resolved.backlogPeak / (1024.0 * 1024.0));
+        }
     }
+    pipeline_free(&stages);
+    sink->writer = NULL;
+    return rc;
+}
 
-    /* Cleanup Queue Memory */
-    queue_cleanup(&buffer);
 
-    /* Cleanup Semaphore Memory */
-    if (sem_destroy(&full)) {
-        fprintf(stderr, "SEMAPHORE ERROR: Error destroying semaphore 'full': %s\n",
-                strerror(errno));
+/* Print each input file's completion time and share of the names written */
+static void report_stats(const input_source* sources, unsigned int numSources,
+                         long long startTime)
+{
+    unsigned long total = 0;
+    double elapsed;
+    unsigned int i;
+
+    for (i = 0; i < numSources; ++i) {
+        total += sources[i].written;
     }
-    if (sem_destroy(&empty)) {
-        fprintf(stderr, "SEMAPHORE ERROR: Error destroying semaphore 'empty': %s\n",
-                strerror(errno));
+    fprintf(stderr, "STATS: %-8s %7s %-7s %-10s %-10s %s\n",
+            "names", "share", "weight", "done (s)", "names/s", "file");
+    for (i = 0; i < numSources; ++i) {
+        elapsed = sources[i].written ? (sources[i].finished - startTime) / 1e9 : 0.0;
+        fprintf(stderr, "STATS: %-8lu %6.1f%% %-7d %-10.3f %-10.0f %s\n",
+                sources[i].written,
+                total ? 100.0 * sources[i].written / total : 0.0,
+                sources[i].weight, elapsed,
+                elapsed > 0 ? sources[i].written / elapsed : 0.0,
+                sources[i].path);
     }
-    if (sem_destroy(&resBegin)) {
-        fprintf(stderr, "SEMAPHORE ERROR: Error destroying semaphore 'resBegin': %s\n",
-                strerror(errno));
+}
+
+
+/* Resolve the tuning sample once with the given parameters */
+static int tune_trial(const tune_params* params, tune_result* result, void* arg)
+{
+    tune_sample* sample = (tune_sample*) arg;
+    output_sink sink = {0};
+    long long start;
+    long long elapsed;
+    int rc;
+
+    if ((sink.fp = fopen("/dev/null", "w")) == NULL) {
+        return TUNE_FAILURE;
     }
-    if (pthread_mutex_destroy(&qmutex)) {
-        fprintf(stderr, "MUTEX ERROR: Error destroying mutex 'qmutex': %s\n",
-                strerror(errno));
+    sink.dualStack = 0;
+    sink.allAddrs = 0;
+    sink.ckptPath = NULL;
+    pthread_mutex_init(&sink.lock, NULL);
+    latency_reset(&sink.latency);
+
+    start = monotonic_ns();
+    rc = run_pipeline(&sample->source, 1, params, 1, WRITER_THREADS, &sink, 0);
+    elapsed = monotonic_ns() - start;
+    fclose(sink.fp);
+    pthread_mutex_destroy(&sink.lock);
+    if (rc != EXIT_SUCCESS) {
+        return TUNE_FAILURE;
     }
-    if (pthread_mutex_destroy(&fmutex)) {
-        fprintf(stderr, "MUTEX ERROR: Error destroying mutex 'fmutex': %s\n",
+
+    result->rate = sample->count / (elapsed / 1e9);
+    result->p99ms = latency_percentile_ms(&sink.latency, 0.99);
+    return TUNE_SUCCESS;
+}
+
+
+/* Copy up to sampleSize names, spread across the inputs, into a temporary
+ * file and search for the best parameters on it */
+static int tune(input_source* sources, unsigned int numSources, int sampleSize,
+                tune_params* params)
+{
+    tune_sample sample;
+    char path[] = "/tmp/multi-lookup-tune.XXXXXX";
+    char name[MAX_NAME_LENGTH];
+    int perSource = (sampleSize + numSources - 1) / numSources;
+    int taken;
+    int fd;
+    int rc;
+    FILE* samplefd;
+    cfile input;
+    unsigned int i;
+
+    if ((fd = mkstemp(path)) < 0 || (samplefd = fdopen(fd, "w")) == NULL) {
+        fprintf(stderr, "FILE ERROR: Error creating tuning sample: %s\n",
                 strerror(errno));
+        return ERR_FOPEN;
+    }
+    sample.count = 0;
+    for (i = 0; i < numSources && sample.count < sampleSize; ++i) {
+        if (cfile_open_read(&input, sources[i].path) == CFILE_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error opening input file [%s]: %s\n",
+                    sources[i].path, strerror(errno));
+            continue;
+        }
+        for (taken = 0; taken < perSource && sample.count < sampleSize
+                && normalize_read(input.fp, name) != EOF; ++taken) {
+            fprintf(samplefd, "%s\n", name);
+            sample.count++;
+        }
+        cfile_close(&input);
     }
+    fclose(samplefd);
 
-    return EXIT_SUCCESS;
+    sample.source.path = path;
+    sample.source.priority = PRIORITY_NORMAL;
+    sample.source.deadline = 0;
+    sample.source.weight = 1;
+    sample.source.ckpt = NULL;
+
+    if (sample.count == 0) {
+        fprintf(stderr, "TUNE ERROR: No names to sample\n");
+        rc = ERR_TUNE;
+    }
+    else {
+        fprintf(stderr, "TUNE: Sampled %d names\n", sample.count);
+        rc = tune_search(params, dispatch_level_capacity, tune_trial, &sample)
+            == TUNE_SUCCESS ? EXIT_SUCCESS : ERR_TUNE;
+    }
+    unlink(path);
+    return rc;
 }
 
 
-void* requester(void* inputFilePath)
+int main(int argc, char *argv[])
 {
-    FILE* inputfd = NULL;
-    char* payload;
-    char hostname[MAX_NAME_LENGTH];
+    /* Setup Local Variables */
+    unsigned int i;
+    int rc;
+    int opt;
+    long long startTime = monotonic_ns();
+    long deadlineMs;
+    long numWorkers = 0;    // Worker processes for sharded mode, 0 if threaded
+    long tuneSample = 0;    // Names to tune on, 0 for a normal run
+    int outputFormat = CFILE_PLAIN;
+    char* profilePath = NULL;
+    char* tracePath = NULL;
+    double traceSample = 1.0;   // Fraction of hostnames traced
+    char* end;
+    /* Options given before an input file apply to it and every later file */
+    input_source cur = {0};
+    int stats = 0;              // Report per-file completion at exit
+    output_sink sink = {0};
+    int monitorMode = 0;        // Watch for address changes until stopped
+    long maxTtl = MONITOR_MAX_TTL;
+    long checkpointMb = 0;      // Output between checkpoints, 0 for none
+    int resume = 0;             // Continue from the last checkpoint
+    long outputBytes;           // Output length the checkpoint vouches for
+    char ckptPath[PATH_MAX];
+    ckpt_source* ckpts = NULL;
+    char** inputPaths;
+    long weight;
+    long numRequesters = REQUESTER_THREADS;
+    long numWriters = WRITER_THREADS;
+    long numShards = 0;         // Output files to partition into, 0 for one
+    int sorted = 0;             // Write the output in hostname order
+    long sortRunMb = SORT_RUN_MB;
+    long sortFanIn = SORT_FAN_IN;
+    extsort sorter;
+    char* diffPath = NULL;      // Previous results to diff against
+    diff_index previous;
+    struct stat diffStat;
+    struct stat outputStat;
+    struct stat backlogStat;
+    char** excludePaths = NULL; // --exclude filters and lists, in order
+    int numExcludePaths = 0;
+    char* buildExcludePath = NULL;  // Filter to build, 0 for a normal run
+    exclude_builder builder;
+    exclude_filter built;
+    void* grown;
+    /* Input files, followed on the command line by the output file */
+    source_list list = {0};
+    input_source* sources;
+    unsigned int numSources;
+    char* outputPath = NULL;    // Last positional argument
+    unsigned int outputStart = 0;   // Files it was taken for when globbed
+    int outputCount = 0;
+    /* Create as many resolver threads as cores unless a profile says otherwise */
+    tune_params params = {QUEUE_SIZE, sysconf( _SC_NPROCESSORS_ONLN ), 1};
 
-    /* Open Input File */
-    inputfd = fopen((char*) inputFilePath, "r");
-    if (!inputfd) {
-        fprintf(stderr, "FILE ERROR: Error opening input file [%s]: %s\n",
-                (char*) inputFilePath, strerror(errno));
+    cur.priority = PRIORITY_NORMAL;
+    cur.weight = 1;
 
-        /* Notify resolver threads that a requester thread has finished */
-        pthread_mutex_lock(&qmutex);
-        reqRunning--;
-        pthread_mutex_unlock(&qmutex);
+    /* Parse Options, Keeping Input Files in Command Line Order */
+    while ((opt = getopt_long(argc, argv, "-p:d:m:z:iT:P:t:s:w:SMX:DAc:Rr:W:L:F:N:B:GOY:K:aC:V:E:Q:U:x:J:H", longOptions, NULL)) != -1) {
+        switch (opt) {
+        case 1:
+            outputPath = optarg;
+            outputStart = list.count;
+            if ((outputCount = add_glob(&list, optarg, &cur)) < 0) {
+                fprintf(stderr, "MALLOC ERROR: Error adding input file [%s]\n", optarg);
+                return ERR_MALLOC;
+            }
+            break;
+        case 'L':
+            if (add_dir(&list, optarg, &cur)) {
+                fprintf(stderr, "FILE ERROR: Error reading input directory [%s]: %s\n",
+                        optarg, strerror(errno));
+                return ERR_FOPEN;
+            }
+            break;
+        case 'F':
+            if (add_manifest(&list, optarg, &cur)) {
+                fprintf(stderr, "FILE ERROR: Error reading manifest [%s]: %s\n",
+                        optarg, strerror(errno));
+                return ERR_FOPEN;
+            }
+            break;
+        case 'N':
+            numShards = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || numShards < 1
+                    || numShards > MAX_OUTPUT_SHARDS) {
+                fprintf(stderr, "USAGE ERROR: Invalid shard count: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'B':
+            if (!strcmp(optarg, "host") || !strcmp(optarg, "file")) {
+                sink.shardByFile = optarg[0] == 'f';
+            }
+            else {
+                fprintf(stderr, "USAGE ERROR: Invalid shard key: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'O':
+            sorted = 1;
+            break;
+        case 'Y':
+            sortRunMb = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || sortRunMb < 1
+                    || sortRunMb > MAX_SORT_RUN_MB) {
+                fprintf(stderr, "USAGE ERROR: Invalid sort run size: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'K':
+            sortFanIn = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || sortFanIn < EXTSORT_MIN_FAN_IN
+                    || sortFanIn > EXTSORT_MAX_FAN_IN) {
+                fprintf(stderr, "USAGE ERROR: Invalid sort fan-in: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'E':
+            diffPath = optarg;
+            break;
+        case 'r':
+            numRequesters = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || numRequesters < 1
+                    || numRequesters > MAX_REQUESTER_THREADS) {
+                fprintf(stderr, "USAGE ERROR: Invalid requester count: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'W':
+            numWriters = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || numWriters < 1
+                    || numWriters > MAX_WRITER_THREADS) {
+                fprintf(stderr, "USAGE ERROR: Invalid writer count: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'a':
+            affinity = 1;
+            break;
+        case 'C':
+            cacheEntries = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || cacheEntries < 0
+                    || cacheEntries > ML_MAX_CACHE_ENTRIES) {
+                fprintf(stderr, "USAGE ERROR: Invalid cache size: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'V':
+            spillDepth = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || spillDepth < 0
+                    || spillDepth > dispatch_level_capacity) {
+                fprintf(stderr, "USAGE ERROR: Invalid spill depth: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'p':
+            if ((cur.priority = parse_priority(optarg)) < 0) {
+                fprintf(stderr, "USAGE ERROR: Invalid priority class: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'd':
+            deadlineMs = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || deadlineMs < 0) {
+                fprintf(stderr, "USAGE ERROR: Invalid deadline: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            cur.deadline = deadlineMs ? startTime + deadlineMs * 1000000LL : 0;
+            break;
+        case 'w':
+            weight = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || weight < 1 || weight > FAIR_MAX_WEIGHT) {
+                fprintf(stderr, "USAGE ERROR: Invalid weight: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            cur.weight = (int) weight;
+            break;
+        case 'S':
+            stats = 1;
+            break;
+        case 'G':
+            sink.aggregate = 1;
+            break;
+        case 'M':
+            monitorMode = 1;
+            break;
+        case 'D':
+            sink.dualStack = 1;
+            break;
+        case 'A':
+            /* Every address needs the dual-stack lookup */
+            sink.dualStack = 1;
+            sink.allAddrs = 1;
+            break;
+        case 'X':
+            maxTtl = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || maxTtl < MONITOR_MIN_TTL
+                    || maxTtl > MONITOR_MAX_TTL) {
+                fprintf(stderr, "USAGE ERROR: Invalid maximum TTL: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'Q':
+            queueMb = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || queueMb < ML_MIN_QUEUE_BYTES / (1024 * 1024)
+                    || queueMb > MAX_QUEUE_MB) {
+                fprintf(stderr, "USAGE ERROR: Invalid queue ceiling: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'U':
+            backlogDir = optarg;
+            break;
+        case 'x':
+            if ((grown = realloc(excludePaths, (numExcludePaths + 1) * sizeof(*excludePaths)))
+                    == NULL) {
+                fprintf(stderr, "MALLOC ERROR: Error allocating exclusion lists\n");
+                return ERR_MALLOC;
+            }
+            excludePaths = grown;
+            excludePaths[numExcludePaths++] = optarg;
+            break;
+        case 'J':
+            buildExcludePath = optarg;
+            break;
+        case 'H':
+            ptrMode = 1;
+            break;
+        case 'c':
+            checkpointMb = strtol(optarg, &end, 10);
+            if (*end != '\0' || end == optarg || checkpointMb < 1
+                    || checkpointMb > LONG_MAX / (1024 * 1024)) {
+                fprintf(stderr, "USAGE ERROR: Invalid checkpoint interval: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'R':
+            resume = 1;
+            break;
+        case 'm':
+            numWorkers = strtol(optarg, &end, 10);
+            if (*end != '\0' || numWorkers < 1 || numWorkers > SHARD_MAX_WORKERS) {
+                fprintf(stderr, "USAGE ERROR: Invalid worker count: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'i':
+            idnEnabled = 1;
+            break;
+        case 'z':
+            if ((outputFormat = cfile_parse_format(optarg)) == CFILE_FAILURE) {
+                fprintf(stderr, "USAGE ERROR: Unsupported compression: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'T':
+            tuneSample = strtol(optarg, &end, 10);
+            if (*end != '\0' || tuneSample < 1) {
+                fprintf(stderr, "USAGE ERROR: Invalid tuning sample size: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        case 'P':
+            profilePath = optarg;
+            break;
+        case 't':
+            tracePath = optarg;
+            break;
+        case 's':
+            traceSample = strtod(optarg, &end);
+            if (*end != '\0' || end == optarg || !(traceSample > 0.0 && traceSample <= 1.0)) {
+                fprintf(stderr, "USAGE ERROR: Invalid trace sample rate: %s\n", optarg);
+                return ERR_ARGS;
+            }
+            break;
+        default:
+            fprintf(stderr, "Usage:\n  %s %s\n", argv[0], USAGE);
+            return ERR_ARGS;
+        }
+    }
 
-        return (void*) ERR_FOPEN;
+    /* Load the Tuned Profile, if Any */
+    if (!tuneSample && tune_load_profile(profilePath ? profilePath : DEFAULT_PROFILE,
+                                         &params) == TUNE_FAILURE && profilePath) {
+        fprintf(stderr, "FILE ERROR: Error reading profile [%s]: %s\n",
+                profilePath, strerror(errno));
+        return ERR_FOPEN;
+    }
+    if (params.queueSize < TUNE_MIN_QUEUE || params.queueSize > dispatch_level_capacity) {
+        fprintf(stderr, "WARNING: Queue size must be 1 to %d\n", dispatch_level_capacity);
+        params.queueSize = QUEUE_SIZE;
+    }
+    if (params.resolvers > TUNE_MAX_RESOLVERS) {
+        fprintf(stderr, "WARNING: At most %d resolver threads\n", TUNE_MAX_RESOLVERS);
+        params.resolvers = TUNE_MAX_RESOLVERS;
+    }
+    if (params.batch < TUNE_MIN_BATCH || params.batch > TUNE_MAX_BATCH) {
+        fprintf(stderr, "WARNING: Batch size must be 1 to %d\n", TUNE_MAX_BATCH);
+        params.batch = 1;
+    }
+
+    /* Verify Minimum Resolver Thread Limit */
+    if (params.resolvers < MIN_RESOLVER_THREADS) {
+        fprintf(stderr, "WARNING: Program must provide at least %d resolver threads\n",
+                MIN_RESOLVER_THREADS);
+        params.resolvers = MIN_RESOLVER_THREADS;
     }
 
-    /* Notify resolver threads that at least one input file has been opened (is not bogus) */
-    sem_post(&resBegin);
+    sources = list.items;
+    numSources = list.count;
 
-    /* Read File and Process */
-    while (fscanf(inputfd, INPUTFS, hostname) > 0) {
-        /* Must make a copy of the hostname to be placed in the queue;
-         * otherwise, the queue will be full of pointers to hostname */
-        if ((payload = (char*) malloc(sizeof(hostname))) == NULL) {
-            fprintf(stderr, "MALLOC ERROR: Error allocating memory for payload [%s]: %s\n",
-                    hostname, strerror(errno));
+    /* Address Ranges Are Only Looked Up, Not Tuned On or Filtered */
+    if (ptrMode && (tuneSample || buildExcludePath)) {
+        fprintf(stderr, "USAGE ERROR: --ptr cannot be used with --tune or --build-exclude\n");
+        return ERR_ARGS;
+    }
+
+    /* Tuning Mode: Every Positional Argument Is an Input File */
+    if (tuneSample) {
+        if (numSources < 1) {
+            fprintf(stderr, "USAGE ERROR: No input files to tune on\n");
+            return ERR_ARGS;
+        }
+        if ((rc = tune(sources, numSources, tuneSample, &params)) != EXIT_SUCCESS) {
+            return rc;
+        }
+        if (tune_save_profile(profilePath ? profilePath : DEFAULT_PROFILE,
+                              &params) == TUNE_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error writing profile: %s\n", strerror(errno));
+            return ERR_FOPEN;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    /* Filter Building Mode: Every Positional Argument Is an Exclusion List */
+    if (buildExcludePath) {
+        if (numSources < 1) {
+            fprintf(stderr, "USAGE ERROR: No exclusion lists to build from\n");
+            return ERR_ARGS;
+        }
+        exclude_builder_init(&builder);
+        for (i = 0; i < numSources; ++i) {
+            if (read_exclude_list(&builder, sources[i].path)) {
+                fprintf(stderr, "FILE ERROR: Error reading exclusion list [%s]: %s\n",
+                        sources[i].path, strerror(errno));
+                exclude_builder_free(&builder);
+                return ERR_FOPEN;
+            }
+        }
+        if (exclude_build(&builder, &built) == EXCLUDE_FAILURE) {
+            fprintf(stderr, "MALLOC ERROR: Error building exclusion filter\n");
+            exclude_builder_free(&builder);
+            return ERR_MALLOC;
+        }
+        rc = exclude_save(&built, buildExcludePath);
+        if (rc == EXCLUDE_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error writing exclusion filter [%s]: %s\n",
+                    buildExcludePath, strerror(errno));
+        }
+        else {
+            fprintf(stderr, "EXCLUDE: %llu names in a %.1f MB filter\n",
+                    built.header->names, built.size / (1024.0 * 1024.0));
+        }
+        exclude_free(&built);
+        return rc == EXCLUDE_FAILURE ? ERR_FOPEN : EXIT_SUCCESS;
+    }
+
+    /* Verify Correct Usage */
+    if (outputPath == NULL || numSources - outputCount + 2 < MIN_ARGS) {
+        fprintf(stderr, "USAGE ERROR: Not enough arguments: %d\n", numSources);
+        fprintf(stderr, "Usage:\n  %s %s\n", argv[0], USAGE);
+        return ERR_ARGS;
+    }
+    if (outputCount != 1) {
+        fprintf(stderr, "USAGE ERROR: Output file [%s] matches %d files\n",
+                outputPath, outputCount);
+        return ERR_ARGS;
+    }
+
+    /* The Last Positional Argument Was the Output File, Not an Input */
+    free(sources[outputStart].path);
+    memmove(&sources[outputStart], &sources[outputStart + 1],
+            (numSources - outputStart - 1) * sizeof(*sources));
+    numSources = --list.count;
+    if ((inputPaths = malloc(numSources * sizeof(*inputPaths))) == NULL) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating input paths\n");
+        return ERR_MALLOC;
+    }
+    for (i = 0; i < numSources; ++i) {
+        inputPaths[i] = sources[i].path;
+    }
+
+    /* Worker Processes Only Look Up the First Address */
+    if (numWorkers && sink.dualStack) {
+        fprintf(stderr, "USAGE ERROR: --dual-stack and --all-addrs cannot be used with --workers\n");
+        return ERR_ARGS;
+    }
+
+    /* Reverse Mode: Every Input Is an Address Range, Looked Up by the
+     * Threaded Pipeline Alone */
+    if (ptrMode) {
+        if (sink.dualStack || numWorkers || monitorMode || checkpointMb || resume
+                || sink.aggregate) {
+            fprintf(stderr, "USAGE ERROR: --ptr cannot be used with --dual-stack, --all-addrs, "
+                    "--workers, --monitor, --checkpoint, --resume or --aggregate\n");
+            return ERR_ARGS;
+        }
+        for (i = 0; i < numSources; ++i) {
+            if (ptr_parse(&sources[i].range, sources[i].path) == PTR_FAILURE) {
+                fprintf(stderr, "USAGE ERROR: Invalid address range: %s\n", sources[i].path);
+                return ERR_ARGS;
+            }
+        }
+    }
 
-            /* Notify resolver threads that a requester thread has finished */
-            pthread_mutex_lock(&qmutex);
-            reqRunning--;
-            pthread_mutex_unlock(&qmutex);
+    /* A Segmented Queue Is Shared, and Holds More Names Than a Checkpoint Tracks */
+    if (queueMb && (affinity || checkpointMb || resume)) {
+        fprintf(stderr, "USAGE ERROR: --queue-mb cannot be used with --affinity, "
+                "--checkpoint or --resume\n");
+        return ERR_ARGS;
+    }
+    if (backlogDir && (affinity || queueMb || checkpointMb || resume)) {
+        fprintf(stderr, "USAGE ERROR: --backlog-dir cannot be used with --affinity, "
+                "--queue-mb, --checkpoint or --resume\n");
+        return ERR_ARGS;
+    }
+    if (backlogDir && (stat(backlogDir, &backlogStat) || !S_ISDIR(backlogStat.st_mode))) {
+        fprintf(stderr, "FILE ERROR: Backlog directory [%s] is not a directory\n", backlogDir);
+        return ERR_FOPEN;
+    }
 
-            return (void*) ERR_MALLOC;
+    /* Checkpoints Need the Threaded Pipeline and a Seekable Output */
+    if (checkpointMb || resume) {
+        if (numWorkers || monitorMode || outputFormat != CFILE_PLAIN) {
+            fprintf(stderr, "USAGE ERROR: --checkpoint and --resume need uncompressed "
+                    "output and cannot be used with --workers or --monitor\n");
+            return ERR_ARGS;
         }
-        if (strncpy(payload, hostname, MAX_NAME_LENGTH) != payload) {
-            fprintf(stderr, "STRNCPY ERROR: Error copying string [%s]\n",
-                    hostname);
+        snprintf(ckptPath, sizeof(ckptPath), "%s%s", outputPath, CKPT_SUFFIX);
+        if ((ckpts = malloc(numSources * sizeof(*ckpts))) == NULL) {
+            fprintf(stderr, "MALLOC ERROR: Error allocating checkpoint state\n");
+            return ERR_MALLOC;
+        }
+        for (i = 0; i < numSources; ++i) {
+            ckpt_source_init(&ckpts[i]);
+            sources[i].ckpt = &ckpts[i];
+        }
+        sink.ckptPath = ckptPath;
+        sink.ckpts = ckpts;
+        sink.paths = inputPaths;
+        sink.numSources = numSources;
+        sink.ckptEvery = (checkpointMb ? checkpointMb : CHECKPOINT_MB) * 1024 * 1024;
+    }
 
-            /* Notify resolver threads that a requester thread has finished */
-            pthread_mutex_lock(&qmutex);
-            reqRunning--;
-            pthread_mutex_unlock(&qmutex);
+    /* Rollups Only Cover the Names a Run Writes Itself */
+    if (sink.aggregate && resume) {
+        fprintf(stderr, "USAGE ERROR: --aggregate cannot be used with --resume\n");
+        return ERR_ARGS;
+    }
 
-            return (void*) ERR_STRNCPY;
+    /* Partitioned Output Is Written by the Threaded Pipeline Alone */
+    if (numShards && (numWorkers || monitorMode || checkpointMb || resume)) {
+        fprintf(stderr, "USAGE ERROR: --shards cannot be used with --workers, "
+                "--monitor, --checkpoint or --resume\n");
+        return ERR_ARGS;
+    }
+
+    /* Sorted Output Is Merged From Runs the Threaded Pipeline Writes */
+    if (sorted && (numWorkers || monitorMode || numShards || checkpointMb || resume)) {
+        fprintf(stderr, "USAGE ERROR: --sort cannot be used with --workers, "
+                "--monitor, --shards, --checkpoint or --resume\n");
+        return ERR_ARGS;
+    }
+
+    /* A Diff Is Written by the Threaded Pipeline to One File */
+    if (diffPath && (numWorkers || monitorMode || numShards || sorted
+                     || checkpointMb || resume)) {
+        fprintf(stderr, "USAGE ERROR: --diff cannot be used with --workers, "
+                "--monitor, --shards, --sort, --checkpoint or --resume\n");
+        return ERR_ARGS;
+    }
+
+    /* Exclusion Filters Are Checked by the Threaded Pipeline's Requesters */
+    if (numExcludePaths && (numWorkers || monitorMode)) {
+        fprintf(stderr, "WARNING: --exclude is ignored with --workers and --monitor\n");
+        numExcludePaths = 0;
+    }
+    if (numExcludePaths
+            && (rc = load_excludes(&excludes, excludePaths, numExcludePaths)) != EXIT_SUCCESS) {
+        return rc;
+    }
+    free(excludePaths);
+
+    /* Index the Previous Results Before the Output Is Truncated */
+    if (diffPath) {
+        if (stat(diffPath, &diffStat) == 0 && stat(outputPath, &outputStat) == 0
+                && diffStat.st_dev == outputStat.st_dev && diffStat.st_ino == outputStat.st_ino) {
+            fprintf(stderr, "USAGE ERROR: --diff [%s] is the output file\n", diffPath);
+            return ERR_ARGS;
+        }
+        if (diff_open(&previous, diffPath) == DIFF_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error reading previous results [%s] "
+                    "(must be uncompressed): %s\n", diffPath, strerror(errno));
+            return ERR_FOPEN;
         }
+        sink.diff = &previous;
+    }
+
+    /* Open Output File, or Cut It Back to the Checkpoint */
+    if (resume) {
+        if (ckpt_load(ckptPath, &outputBytes, ckpts, inputPaths, numSources) == CKPT_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error reading checkpoint [%s]: %s\n",
+                    ckptPath, strerror(errno));
+            return ERR_CHECKPOINT;
+        }
+        if (truncate(outputPath, outputBytes)
+                || cfile_open_append(&output, outputPath) == CFILE_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error reopening output file [%s]: %s\n",
+                    outputPath, strerror(errno));
+            return ERR_FOPEN;
+        }
+    }
+    else if (numShards) {
+        if (open_shards(&sink, outputPath, numShards, outputFormat)) {
+            fprintf(stderr, "FILE ERROR: Error opening output shards [%s]: %s\n",
+                    outputPath, strerror(errno));
+            return ERR_FOPEN;
+        }
+    }
+    else if (cfile_open_write(&output, outputPath, outputFormat) == CFILE_FAILURE) {
+        fprintf(stderr, "FILE ERROR: Error opening output file [%s]: %s\n",
+                outputPath, strerror(errno));
+        return ERR_FOPEN;
+    }
 
-        /* Sleep for 0 to 100 microseconds - as per Section 2.2 of handout */
-        usleep(rand() % 100);
+    /* Runs Go in a Directory Next to the Output */
+    if (sorted) {
+        if (extsort_init(&sorter, outputPath, (size_t) sortRunMb * 1024 * 1024,
+                         (int) sortFanIn, sysconf(_SC_NPROCESSORS_ONLN)) == EXTSORT_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error creating sort directory for [%s]: %s\n",
+                    outputPath, strerror(errno));
+            cfile_close(&output);
+            return ERR_FOPEN;
+        }
+        sink.sort = &sorter;
+    }
 
-        /* Make sure the queue is not full */
-        sem_wait(&full);
+    /* Trace Spans Follow Names Through the Threaded Pipeline Only */
+    if (tracePath && (numWorkers || monitorMode)) {
+        fprintf(stderr, "WARNING: --trace is ignored with --workers and --monitor; use the USDT probes\n");
+        tracePath = NULL;
+    }
+    if (tracePath) {
+        trace_init(traceSample);
+    }
+    if (sink.aggregate && (numWorkers || monitorMode)) {
+        fprintf(stderr, "WARNING: --aggregate is ignored with --workers and --monitor\n");
+        sink.aggregate = 0;
+    }
+    if (affinity && (numWorkers || monitorMode)) {
+        fprintf(stderr, "WARNING: --affinity is ignored with --workers and --monitor\n");
+        affinity = 0;
+    }
+    if (queueMb && (numWorkers || monitorMode)) {
+        fprintf(stderr, "WARNING: --queue-mb is ignored with --workers and --monitor\n");
+        queueMb = 0;
+    }
+    if (backlogDir && (numWorkers || monitorMode)) {
+        fprintf(stderr, "WARNING: --backlog-dir is ignored with --workers and --monitor\n");
+        backlogDir = NULL;
+    }
 
-        /* Acquire exclusive access to queue so it can be updated safely */
-        pthread_mutex_lock(&qmutex);
+    /* Monitoring Mode: Re-resolve Names as Their TTLs Expire */
+    if (monitorMode) {
+        rc = monitor_run(inputPaths, numSources, output.fp, params.resolvers,
+                         idnEnabled, maxTtl);
+        rc = rc == MONITOR_SUCCESS ? EXIT_SUCCESS : ERR_MONITOR;
+    }
+    /* Sharded Mode: Worker Processes Replace the Thread Pools */
+    else if (numWorkers) {
+        rc = shard_run(inputPaths, numSources, output.fp, numWorkers, idnEnabled);
+        rc = rc == SHARD_SUCCESS ? EXIT_SUCCESS : ERR_SHARD;
+    }
+    else {
+        sink.fp = output.fp;
+        pthread_mutex_init(&sink.lock, NULL);
+        latency_reset(&sink.latency);
+        rc = run_pipeline(sources, numSources, &params, numRequesters, numWriters,
+                          &sink, stats);
+        pthread_mutex_destroy(&sink.lock);
 
-        /* Add hostname to Bounded Queue */
-        if (queue_push(&buffer, (void*) payload) == QUEUE_FAILURE) {
-            fprintf(stderr, "QUEUE ERROR: push [%s] failed!\n", payload);
+        /* Merge the Sorted Runs Into the Output */
+        if (sink.sort && rc == EXIT_SUCCESS) {
+            if (extsort_finish(sink.sort, output.fp) == EXTSORT_FAILURE) {
+                fprintf(stderr, "FILE ERROR: Error sorting output [%s]: %s\n",
+                        outputPath, strerror(errno));
+                rc = ERR_FOPEN;
+            }
+            else if (stats) {
+                fprintf(stderr, "SORT: %lu runs, %d merge passes, peak temporary space %.1f MB\n",
+                        sink.sort->runsWritten, sink.sort->passes,
+                        sink.sort->peakTempBytes / (1024.0 * 1024.0));
+            }
+        }
+        if (sink.sort) {
+            extsort_free(sink.sort);
         }
 
-        /* Release exclusive access to queue */
-        pthread_mutex_unlock(&qmutex);
+        /* Every Previous Hostname No Result Matched Was Removed */
+        if (sink.diff) {
+            if (rc == EXIT_SUCCESS && diff_write_removed(sink.diff, output.fp) == DIFF_FAILURE) {
+                fprintf(stderr, "FILE ERROR: Error writing output file [%s]: %s\n",
+                        outputPath, strerror(errno));
+                rc = ERR_FOPEN;
+            }
+            else if (rc == EXIT_SUCCESS) {
+                fprintf(stderr, "DIFF: %lu added, %lu removed, %lu changed, %lu unchanged\n",
+                        sink.diff->numAdded, sink.diff->numRemoved,
+                        sink.diff->numChanged, sink.diff->numUnchanged);
+            }
+            diff_close(sink.diff);
+        }
+        if (stats && rc == EXIT_SUCCESS) {
+            report_stats(sources, numSources, startTime);
+        }
+    }
 
-        /* Notify resolver threads about new hostname in queue */
-        sem_post(&empty);
+    /* Close Output File */
+    if (sink.numShards) {
+        if (close_shards(&sink, outputPath)) {
+            fprintf(stderr, "FILE ERROR: Error writing shard manifest [%s]: %s\n",
+                    outputPath, strerror(errno));
+            rc = rc == EXIT_SUCCESS ? ERR_FOPEN : rc;
+        }
+    }
+    else if (cfile_close(&output)) {
+        fprintf(stderr, "FILE ERROR: Error closing output file [%s]: %s\n",
+                outputPath, strerror(errno));
+        rc = rc == EXIT_SUCCESS ? ERR_FOPEN : rc;
+    }
 
-#ifdef LOOKUP_DEBUG
-        printf("Pushed: %s\n", payload);
-#endif
+    /* A Finished Run Has Nothing to Resume */
+    if (ckpts) {
+        if (rc == EXIT_SUCCESS) {
+            unlink(ckptPath);
+        }
+        for (i = 0; i < numSources; ++i) {
+            ckpt_source_free(&ckpts[i]);
+        }
+        free(ckpts);
     }
 
-    /* Close Input File */
-    if (fclose(inputfd)) {
-        fprintf(stderr, "FILE ERROR: Error closing input file [%s]: %s\n",
-                (char*) inputFilePath, strerror(errno));
+    /* Write Rollups Next to the Results */
+    if (sink.aggregate && agg_write(outputPath) == AGG_FAILURE) {
+        fprintf(stderr, "FILE ERROR: Error writing rollups for [%s]: %s\n",
+                outputPath, strerror(errno));
+        rc = rc == EXIT_SUCCESS ? ERR_FOPEN : rc;
     }
 
-    /* Notify resolver threads that a requester thread has finished */
-    pthread_mutex_lock(&qmutex);
-    reqRunning--;
-    pthread_mutex_unlock(&qmutex);
+    /* Write Trace Spans */
+    if (tracePath && trace_dump(tracePath) == TRACE_FAILURE) {
+        fprintf(stderr, "FILE ERROR: Error writing trace file [%s]: %s\n",
+                tracePath, strerror(errno));
+    }
 
-    return NULL;
+    free_excludes(&excludes);
+    free(inputPaths);
+    free_sources(&list);
+    return rc;
 }
 
 
-void* resolver()
+/* Claim the next unread input file and open it, starting readahead so it
+ * is cached by the time this thread gets to it
+ * Returns the file's source, or NULL once every file has been claimed
+ */
+static input_source* claim_source(requester_pool* pool, cfile* input)
 {
-    char* hostname;
-    char resolvedIP[INET6_ADDRSTRLEN];
-
-    /* Wait for at least one input file to be opened (non bogus)
-     * and notify other sleeping resolver threads of the same
-     */
-    sem_wait(&resBegin);
-    sem_post(&resBegin);
+    input_source* src;
+    unsigned int i;
 
-    /* Lock while checking reqRunning and queue */
-    pthread_mutex_lock(&qmutex);
-    while (reqRunning || !queue_is_empty(&buffer)) {
-        pthread_mutex_unlock(&qmutex);
+    while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->numSources) {
+        src = &pool->sources[i];
+        if (cfile_open_read(input, src->path) == CFILE_SUCCESS) {
+            return src;
+        }
+        fprintf(stderr, "FILE ERROR: Error opening input file [%s]: %s\n",
+                src->path, strerror(errno));
+    }
+    return NULL;
+}
 
-        /* Wait for queue to not be empty */
-        sem_wait(&empty);
 
-        /* Acquire exclusive access to queue so it can be read safely */
-        pthread_mutex_lock(&qmutex);
+/* Submit every name in an open input file, then close it; time spent in
+ * ml_submit() waiting for queue slots is counted as blocked */
+static void request_file(pipeline_worker* w, input_source* src, cfile* input)
+{
+    char raw[NORMALIZE_BATCH][MAX_NAME_LENGTH];     // Names as read
+    const char* names[NORMALIZE_BATCH];
+    unsigned long tags[NORMALIZE_BATCH];            // Index of each name in the file
+    ckpt_source* ckpt = src->ckpt;
+    unsigned long index = 0;
+    long long start;
+    int skipped = 0;                                // Entries of ckpt->skip passed
+    int count;
+    int n;
+    int i;
 
-        /* Read hostname from Bounded Queue */
-        if ((hostname = (char*) queue_pop(&buffer)) == NULL) {
-            fprintf(stderr, "QUEUE ERROR: pop failed!\n");
+    /* Skip What the Checkpoint Says Is Written, Seeking When We Can */
+    if (ckpt && ckpt->resume.names) {
+        if (input->format == CFILE_PLAIN && ckpt->resume.offset >= 0
+                && fseek(input->fp, ckpt->resume.offset, SEEK_SET) == 0) {
+            index = ckpt->resume.names;
+        }
+        while (index < ckpt->resume.names && normalize_read(input->fp, raw[0]) != EOF) {
+            index++;
         }
+    }
 
-        /* Release exclusive access to queue */
-        pthread_mutex_unlock(&qmutex);
+    /* Read File and Submit a Batch of Names at a Time */
+    while ((count = read_batch(input->fp, raw)) > 0) {
+        for (i = 0, n = 0; i < count; ++i, ++index) {
+            if (ckpt && skipped < ckpt->numSkip && ckpt->skip[skipped] == index) {
+                skipped++;
+                continue;
+            }
+            names[n] = raw[i];
+            tags[n++] = index;
+            /* Sleep for 0 to 100 microseconds per name - as per Section 2.2 of handout */
+            usleep(rand() % 100);
+        }
 
-        /* Notify requester threads that there is more room in queue */
-        sem_post(&full);
+        if (n) {
+            start = monotonic_ns();
+            ml_submit(src->ctx, src->id, names, tags, n);
+            pipeline_blocked(w, monotonic_ns() - start);
+            w->items += n;
+        }
+        if (ckpt) {
+            ckpt_mark_input(ckpt, index,
+                            input->format == CFILE_PLAIN ? ftell(input->fp) : -1);
+        }
 
 #ifdef LOOKUP_DEBUG
-        printf("Popped: %s\n", hostname);
+        printf("Submitted %d names from %s\n", n, src->path);
 #endif
+    }
+
+    /* Close Input File */
+    if (cfile_close(input)) {
+        fprintf(stderr, "FILE ERROR: Error reading input file [%s]\n",
+                src->path);
+    }
+}
+
+
+/* Claim the next chunk of addresses, moving the pool on to the next range
+ * once this one is used up
+ * Returns the chunk's source, or NULL once every address has been claimed
+ */
+static input_source* claim_addresses(requester_pool* pool, unsigned long long* offset,
+                                     unsigned long long* count)
+{
+    input_source* src;
+    unsigned int i;
+
+    while ((i = __atomic_load_n(&pool->next, __ATOMIC_RELAXED)) < pool->numSources) {
+        src = &pool->sources[i];
+        if ((*count = ptr_claim(&src->range, PTR_CHUNK, offset)) > 0) {
+            return src;
+        }
+        /* Only the first thread to find it empty moves the pool on */
+        __atomic_compare_exchange_n(&pool->next, &i, i + 1, 0,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
 
-        /* Lookup hostname and get IP string */
-        if (dnslookup(hostname, resolvedIP, sizeof(resolvedIP))
-                == UTIL_FAILURE) {
-            fprintf(stderr, "DNSLOOKUP ERROR: %s\n", hostname);
-            strncpy(resolvedIP, "", sizeof(resolvedIP));
+/* Submit a chunk of a range's addresses, generating them a batch at a time;
+ * there is no file to read, so no per-name sleep */
+static void request_addresses(pipeline_worker* w, input_source* src,
+                              unsigned long long offset, unsigned long long count)
+{
+    char addresses[NORMALIZE_BATCH][PTR_ADDRESS_LENGTH];
+    const char* names[NORMALIZE_BATCH];
+    unsigned long tags[NORMALIZE_BATCH];            // Offset of each address in the range
+    long long start;
+    int n;
+
+    while (count > 0) {
+        for (n = 0; n < NORMALIZE_BATCH && (unsigned long long) n < count; ++n) {
+            ptr_format(&src->range, offset + n, addresses[n]);
+            names[n] = addresses[n];
+            tags[n] = offset + n;
         }
+        start = monotonic_ns();
+        ml_submit(src->ctx, src->id, names, tags, n);
+        pipeline_blocked(w, monotonic_ns() - start);
+        w->items += n;
+        offset += n;
+        count -= n;
+    }
+}
+
 
-        /* Acquire exclusive access to output file */
-        pthread_mutex_lock(&fmutex);
+/* Read stage: take input files from the pool until there are none left, or
+ * with --ptr chunks of addresses until every range is done */
+int requester(pipeline_worker* w, void* items, int count, void* pool)
+{
+    cfile files[2];     // The codec thread of a compressed file keeps its address
+    cfile* input = &files[0];
+    cfile* prefetched = &files[1];
+    cfile* swap;
+    input_source* src;
+    input_source* next;
 
-        /* Write to Output File */
-        fprintf(outputfd, "%s,%s\n", hostname, resolvedIP);
+    unsigned long long offset;
+    unsigned long long chunk;
 
-        /* Release exclusive access to output file */
-        pthread_mutex_unlock(&fmutex);
+    (void) items;
+    (void) count;
 
-        /* Free malloc'd Memory */
-        free(hostname);
+    /* Generate Addresses Instead of Reading Files */
+    if (((requester_pool*) pool)->ranges) {
+        while ((src = claim_addresses((requester_pool*) pool, &offset, &chunk)) != NULL) {
+            request_addresses(w, src, offset, chunk);
+        }
+        return PIPELINE_DONE;
+    }
 
-        /* Acquire lock to check WHILE condition */
-        pthread_mutex_lock(&qmutex);
+    /* Open Each File While the One Before It Is Parsed */
+    next = claim_source((requester_pool*) pool, prefetched);
+    while ((src = next) != NULL) {
+        swap = input;
+        input = prefetched;
+        prefetched = swap;
+        next = claim_source((requester_pool*) pool, prefetched);
+        request_file(w, src, input);
     }
-    pthread_mutex_unlock(&qmutex);
 
-    return NULL;
+    return PIPELINE_DONE;
 }
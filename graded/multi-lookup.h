@@ -14,15 +14,37 @@
 #define MULTI_LOOKUP_H
 
 /* Standard Includes */
+#include <ctype.h>
+#include <dirent.h>
+#include <getopt.h>
+#include <glob.h>
+#include <limits.h>     // PATH_MAX
 #include <pthread.h>
 #include <semaphore.h>
 #include <stdio.h>
 //#include <stdlib.h>
+#include <sys/stat.h>
 #include <unistd.h>     // Provides usleep, num cores
 
 
 /* Local Includes */
-#include "queue.h"
+#include "agg.h"
+#include "cfile.h"
+#include "ckpt.h"
+#include "diff.h"
+#include "exclude.h"
+#include "extsort.h"
+#include "dispatch.h"
+#include "fair.h"
+#include "mlookup.h"
+#include "monitor.h"
+#include "normalize.h"
+#include "pipeline.h"
+#include "probes.h"
+#include "ptr.h"
+#include "shard.h"
+#include "trace.h"
+#include "tune.h"
 #include "util.h"
 
 
@@ -34,20 +56,120 @@
 #define ERR_STRNCPY         4
 #define ERR_SEMAPHORE       5
 #define ERR_MUTEX           6
+#define ERR_SHARD           7
+#define ERR_TUNE            8
+#define ERR_MONITOR         9
+#define ERR_CHECKPOINT      10
 
 
 /* Miscellaneous Helpful Defines */
 // Requires: <exe_name> <input_file>+ <results_file>
 #define MIN_ARGS                3
-#define USAGE                   "<inputFilePath> [inputFilePath...] <outputFilePath>"
+#define USAGE                   "[--requesters n] [--writers n] [--workers n] [--compress gzip|zstd] [--idn] [--profile path] " \
+                                "[--trace path [--trace-sample rate]] " \
+                                "[--dual-stack | --all-addrs] [--affinity [--cache n] [--spill n]] [--queue-mb n | --backlog-dir path] [--exclude path]... [--ptr] [--checkpoint mb] [--resume] [--shards n [--shard-by host|file]] [--sort [--sort-run mb] [--sort-fanin k]] [--diff previous] [--aggregate] [--stats] [--priority urgent|normal|bulk] [--deadline ms] [--weight w] " \
+                                "<input> [[options] input...] <outputFilePath>\n" \
+                                "  where each input is a file, a quoted glob, --dir path or --manifest path,\n" \
+                                "  or with --ptr an IPv4 address range a.b.c.d/len\n" \
+                                "  --tune samples [--profile path] <inputFilePath>...\n" \
+                                "  --build-exclude filterPath <listFilePath>...\n" \
+                                "  --monitor [--max-ttl s] <inputFilePath>... <outputFilePath>"
 #define MIN_RESOLVER_THREADS    2       // Mandatory lower-limit
-#define MAX_NAME_LENGTH         256     // Maximum hostname length
-#define INPUTFS                 "%255s"
-#define QUEUE_SIZE              10
+#define REQUESTER_THREADS       32      // Requester pool size by default
+#define MAX_REQUESTER_THREADS   1024
+#define WRITER_THREADS          1       // Write stage pool size by default
+#define MAX_WRITER_THREADS      64
+#define WRITE_QUEUE_SIZE        256     // Results between resolvers and writers
+#define QUEUE_SIZE              10      // Items admitted to each priority level
+#define AGING_THRESHOLD         8       // Pops a backlogged class may sit out
+#define CHECKPOINT_MB           64      // Output between checkpoints when resuming
+#define MAX_OUTPUT_SHARDS       1024
+#define OUTPUT_SHARD_NAME       "%s.%04d"       // Output path, shard number
+#define OUTPUT_SHARD_BUFFER     (1 << 20)       // stdio buffer per shard
+#define SORT_RUN_MB             64      // Sort buffer per writer thread
+#define MAX_SORT_RUN_MB         4096
+#define MAX_QUEUE_MB            65536   // Segmented queue ceiling
+#define SORT_FAN_IN             64      // Runs merged at once
+#define SORT_LINE_LENGTH        (ML_NAME_LENGTH + ADDRSET_TEXT_LENGTH + 2)
+
+
+/* An input file and the scheduling options it was given on the command line */
+typedef struct input_source_s {
+    char* path;
+    int priority;               // PRIORITY_* class for every name in the file
+    long long deadline;         // CLOCK_MONOTONIC ns, 0 if none
+    int weight;                 // Share of its priority level, see fair.h
+    ml_context* ctx;            // Resolve stage
+    int id;                     // Source index in ctx
+    unsigned long written;      // Names written so far, under the sink lock
+    long long finished;         // CLOCK_MONOTONIC ns of the last one
+    ckpt_source* ckpt;          // Checkpoint progress, NULL if not checkpointing
+    ptr_range range;            // Addresses named by path, with --ptr
+} input_source;
+
+/* Input files in command line order, grown as they are found */
+typedef struct source_list_s {
+    input_source* items;
+    unsigned int count;
+    unsigned int capacity;
+} source_list;
+
+/* Exclusion filters from --exclude; a name in any of them is skipped */
+typedef struct exclude_list_s {
+    exclude_filter* filters;
+    int count;
+} exclude_list;
+
+/* One output file of a partitioned run, with its own lock and buffer */
+typedef struct output_shard_s {
+    cfile file;
+    char* path;
+    pthread_mutex_t lock;       // Held while writing file
+    unsigned long lines;        // Results written, under the lock
+} output_shard;
+
+/* Where the pipeline's results are written */
+typedef struct output_sink_s {
+    pipeline_stage* writer;     // Stage the resolvers queue results for
+    FILE* fp;
+    pthread_mutex_t lock;       // Held while writing fp and counting
+    output_shard* shards;       // Used instead of fp when numShards > 0
+    int numShards;
+    int shardByFile;            // Partition by input file, not hostname hash
+    extsort* sort;              // Used instead of fp when sorting, else NULL
+    diff_index* diff;           // Previous results to write changes against,
+                                // else NULL
+    input_source* sources;      // Per-file counts for --stats
+    latency_hist latency;       // Enqueue-to-write latency of every name
+    int dualStack;              // Look up A and AAAA together
+    int allAddrs;               // Write every address, not just the first
+    int aggregate;              // Roll results up as they are written
+    /* Checkpoints, with ckptPath NULL if not checkpointing */
+    char* ckptPath;
+    ckpt_source* ckpts;         // One per input
+    char** paths;               // Input paths recorded in the checkpoint
+    int numSources;
+    long ckptEvery;             // Output bytes between checkpoints
+    long sinceCkpt;             // Output bytes since the last one
+} output_sink;
+
+/* Input files shared out to the requester pool in order; address ranges
+ * are shared out a chunk at a time, so every requester works on each one */
+typedef struct requester_pool_s {
+    input_source* sources;
+    unsigned int numSources;
+    unsigned int next;          // Next file to claim, taken atomically
+    int ranges;                 // Sources are address ranges (--ptr)
+} requester_pool;
+
+/* The temporary input used for tuning trials */
+typedef struct tune_sample_s {
+    input_source source;
+    int count;                  // Names in the sample
+} tune_sample;
 
 
 /* Prototypes for Local Functions */
-void* requester(void* inputFilePath);
-void* resolver();
+int requester(pipeline_worker* w, void* items, int count, void* pool);
 
 #endif
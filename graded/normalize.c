@@ -0,0 +1,428 @@
+/******************************************************************************
+ * FILE: normalize.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of hostname normalization and validation with an
+ *      SSE2 fast path and an RFC 3492 punycode encoder for IDN labels.
+ *
+ ******************************************************************************/
+
+#include <ctype.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "normalize.h"
+
+#define CHUNK                   16
+#define NUM_CHUNKS              (MAX_NAME_LENGTH / CHUNK)
+
+/* RFC 3492 bootstring parameters for punycode */
+#define PUNY_BASE               36
+#define PUNY_TMIN               1
+#define PUNY_TMAX               26
+#define PUNY_SKEW               38
+#define PUNY_DAMP               700
+#define PUNY_INITIAL_BIAS       72
+#define PUNY_INITIAL_N          0x80
+
+_Static_assert(MAX_NAME_LENGTH % CHUNK == 0,
+               "name buffers must be a whole number of chunks");
+_Static_assert(NAME_MAX_TEXT < MAX_NAME_LENGTH,
+               "NAME_MAX_TEXT must fit in a name buffer");
+
+static const char* nameErrors[] = {
+    "",
+    "INVALID_EMPTY",
+    "INVALID_LENGTH",
+    "INVALID_LABEL_LENGTH",
+    "INVALID_EMPTY_LABEL",
+    "INVALID_CHARSET",
+    "INVALID_IDN"
+};
+
+
+#if !defined(__SSE2__) || defined(NORMALIZE_TEST)
+/* Lowercase len bytes of in into out a byte at a time, collecting the same
+ * masks as classify(); the fallback where SSE2 is not available */
+static void classify_scalar(const char* in, char* out, size_t len,
+                            unsigned short* dots, unsigned short* bad,
+                            unsigned short* high)
+{
+    size_t chunks = (len + CHUNK - 1) / CHUNK;
+    unsigned char ch;
+    size_t c;
+    size_t i;
+
+    for (c = 0; c < chunks; ++c) {
+        dots[c] = bad[c] = high[c] = 0;
+        for (i = 0; i < CHUNK && c * CHUNK + i < len; ++i) {
+            ch = (unsigned char) tolower((unsigned char) in[c * CHUNK + i]);
+            out[c * CHUNK + i] = ch;
+            if (ch == '.') {
+                dots[c] |= 1u << i;
+            }
+            else if (!(islower(ch) || isdigit(ch) || ch == '-' || ch == '_')) {
+                bad[c] |= 1u << i;
+            }
+            if (ch & 0x80) {
+                high[c] |= 1u << i;
+            }
+        }
+    }
+}
+#endif
+
+
+/* Lowercase len bytes of in into out, collecting per-chunk bitmasks of
+ * dots, bytes outside [a-z0-9._-], and non-ASCII bytes */
+static void classify(const char* in, char* out, size_t len,
+                     unsigned short* dots, unsigned short* bad,
+                     unsigned short* high)
+{
+#ifdef __SSE2__
+    size_t c;
+    size_t chunks = (len + CHUNK - 1) / CHUNK;
+    unsigned int limit;
+
+    for (c = 0; c < chunks; ++c) {
+        /* Bits past the end of the name are ignored */
+        limit = len - c * CHUNK >= CHUNK ? 0xffff
+                                         : (1u << (len - c * CHUNK)) - 1;
+        __m128i v = _mm_loadu_si128((const __m128i*) (in + c * CHUNK));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+        v = _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        __m128i dot = _mm_cmpeq_epi8(v, _mm_set1_epi8('.'));
+        __m128i ok = _mm_or_si128(_mm_or_si128(lower, digit),
+                     _mm_or_si128(_mm_or_si128(dot, _mm_cmpeq_epi8(v, _mm_set1_epi8('-'))),
+                                  _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+        _mm_storeu_si128((__m128i*) (out + c * CHUNK), v);
+        dots[c] = _mm_movemask_epi8(dot) & limit;
+        bad[c] = ~_mm_movemask_epi8(ok) & limit;
+        high[c] = _mm_movemask_epi8(v) & limit;
+    }
+#else
+    classify_scalar(in, out, len, dots, bad, high);
+#endif
+}
+
+
+/* Lowercase and validate len bytes of in into out */
+static int validate(const char* in, char* out, size_t len, int* hasHigh)
+{
+    unsigned short dots[NUM_CHUNKS];
+    unsigned short bad[NUM_CHUNKS];
+    unsigned short high[NUM_CHUNKS];
+    unsigned int m;
+    size_t chunks = (len + CHUNK - 1) / CHUNK;
+    size_t c;
+    size_t pos;
+    size_t start = 0;
+    unsigned int anyBad = 0;
+    unsigned int anyHigh = 0;
+
+    classify(in, out, len, dots, bad, high);
+    out[len] = '\0';
+
+    for (c = 0; c < chunks; ++c) {
+        anyBad |= bad[c];
+        anyHigh |= high[c];
+    }
+    *hasHigh = anyHigh != 0;
+    if (anyBad) {
+        return NAME_ERR_CHARSET;
+    }
+
+    /* Walk the label boundaries; the final label ends at len */
+    for (c = 0; c <= chunks; ++c) {
+        m = c < chunks ? dots[c] : 0;
+        for (;;) {
+            if (m) {
+                pos = c * CHUNK + __builtin_ctz(m);
+                m &= m - 1;
+            }
+            else if (c == chunks) {
+                pos = len;
+            }
+            else {
+                break;
+            }
+
+            if (pos == start) {
+                return NAME_ERR_EMPTY_LABEL;
+            }
+            if (pos - start > NAME_MAX_LABEL) {
+                return NAME_ERR_LABEL_LENGTH;
+            }
+            if (out[start] == '-' || out[pos - 1] == '-') {
+                return NAME_ERR_CHARSET;
+            }
+            start = pos + 1;
+            if (pos == len) {
+                break;
+            }
+        }
+    }
+    return NAME_OK;
+}
+
+
+/* Decode one UTF-8 sequence, returning its length or 0 if malformed */
+static int utf8_decode(const unsigned char* s, size_t len, unsigned int* cp)
+{
+    int n;
+    int i;
+
+    if (s[0] < 0x80) {
+        *cp = s[0];
+        return 1;
+    }
+    else if ((s[0] & 0xe0) == 0xc0) {
+        *cp = s[0] & 0x1f;
+        n = 2;
+    }
+    else if ((s[0] & 0xf0) == 0xe0) {
+        *cp = s[0] & 0x0f;
+        n = 3;
+    }
+    else if ((s[0] & 0xf8) == 0xf0) {
+        *cp = s[0] & 0x07;
+        n = 4;
+    }
+    else {
+        return 0;
+    }
+    if ((size_t) n > len) {
+        return 0;
+    }
+    for (i = 1; i < n; ++i) {
+        if ((s[i] & 0xc0) != 0x80) {
+            return 0;
+        }
+        *cp = (*cp << 6) | (s[i] & 0x3f);
+    }
+    /* Reject overlong forms, surrogates and out of range values */
+    if ((n == 2 && *cp < 0x80) || (n == 3 && *cp < 0x800)
+            || (n == 4 && *cp < 0x10000) || *cp > 0x10ffff
+            || (*cp >= 0xd800 && *cp <= 0xdfff)) {
+        return 0;
+    }
+    return n;
+}
+
+
+static unsigned int puny_adapt(unsigned int delta, unsigned int points, int first)
+{
+    unsigned int k = 0;
+
+    delta = first ? delta / PUNY_DAMP : delta / 2;
+    delta += delta / points;
+    while (delta > ((PUNY_BASE - PUNY_TMIN) * PUNY_TMAX) / 2) {
+        delta /= PUNY_BASE - PUNY_TMIN;
+        k += PUNY_BASE;
+    }
+    return k + (PUNY_BASE - PUNY_TMIN + 1) * delta / (delta + PUNY_SKEW);
+}
+
+
+/* Append one character to out, failing once size is exhausted */
+#define PUT(ch) do {                                \
+        if (*outLen + 1 >= size) {                  \
+            return NAME_ERR_IDN;                    \
+        }                                           \
+        out[(*outLen)++] = (ch);                    \
+    } while (0)
+
+
+/* Encode one label as "xn--" punycode (RFC 3492) */
+static int puny_label(const unsigned char* label, size_t len,
+                      char* out, size_t* outLen, size_t size)
+{
+    unsigned int cps[MAX_NAME_LENGTH];
+    unsigned int n = PUNY_INITIAL_N;
+    unsigned int bias = PUNY_INITIAL_BIAS;
+    unsigned int delta = 0;
+    unsigned int h;
+    unsigned int b = 0;
+    unsigned int m;
+    unsigned int q;
+    unsigned int k;
+    unsigned int t;
+    size_t count = 0;
+    size_t i;
+    int step;
+
+    for (i = 0; i < len; i += step) {
+        if ((step = utf8_decode(label + i, len - i, &cps[count])) == 0) {
+            return NAME_ERR_IDN;
+        }
+        count++;
+    }
+
+    PUT('x'); PUT('n'); PUT('-'); PUT('-');
+    for (i = 0; i < count; ++i) {
+        if (cps[i] < 0x80) {
+            PUT(tolower(cps[i]));
+            b++;
+        }
+    }
+    if (b > 0) {
+        PUT('-');
+    }
+
+    for (h = b; h < count; ++n, ++delta) {
+        for (m = 0xffffffff, i = 0; i < count; ++i) {
+            if (cps[i] >= n && cps[i] < m) {
+                m = cps[i];
+            }
+        }
+        if ((m - n) > (0xffffffff - delta) / (h + 1)) {
+            return NAME_ERR_IDN;
+        }
+        delta += (m - n) * (h + 1);
+        n = m;
+
+        for (i = 0; i < count; ++i) {
+            if (cps[i] < n && ++delta == 0) {
+                return NAME_ERR_IDN;
+            }
+            if (cps[i] != n) {
+                continue;
+            }
+            for (q = delta, k = PUNY_BASE; ; k += PUNY_BASE) {
+                t = k <= bias ? PUNY_TMIN
+                  : k >= bias + PUNY_TMAX ? PUNY_TMAX : k - bias;
+                if (q < t) {
+                    break;
+                }
+                m = t + (q - t) % (PUNY_BASE - t);
+                PUT(m < 26 ? 'a' + m : '0' + m - 26);
+                q = (q - t) / (PUNY_BASE - t);
+            }
+            PUT(q < 26 ? 'a' + q : '0' + q - 26);
+            bias = puny_adapt(delta, h + 1, h == b);
+            delta = 0;
+            h++;
+        }
+    }
+    return NAME_OK;
+}
+
+
+/* Rewrite every non-ASCII label of name as punycode */
+static int idn_encode(const char* name, size_t len, char* out)
+{
+    size_t start;
+    size_t end;
+    size_t outLen = 0;
+    size_t i;
+    int ascii;
+    int rc;
+
+    for (start = 0; start <= len; start = end + 1) {
+        for (end = start, ascii = 1; end < len && name[end] != '.'; ++end) {
+            ascii &= !(name[end] & 0x80);
+        }
+        if (ascii) {
+            if (outLen + (end - start) + 1 >= MAX_NAME_LENGTH) {
+                return NAME_ERR_LENGTH;
+            }
+            for (i = start; i < end; ++i) {
+                out[outLen++] = name[i];
+            }
+        }
+        else if ((rc = puny_label((const unsigned char*) name + start, end - start,
+                                  out, &outLen, MAX_NAME_LENGTH)) != NAME_OK) {
+            return rc;
+        }
+        if (end < len) {
+            out[outLen++] = '.';
+        }
+    }
+    out[outLen] = '\0';
+    return NAME_OK;
+}
+
+
+int normalize_read(FILE* fp, char* name)
+{
+    int c;
+    int rc = NAME_OK;
+
+    if (fscanf(fp, "%255s", name) != 1) {
+        return EOF;
+    }
+
+    /* Swallow the rest of a token too long for the buffer */
+    while ((c = getc(fp)) != EOF && !isspace(c)) {
+        rc = NAME_ERR_LENGTH;
+    }
+    return rc;
+}
+
+
+int normalize_name(const char* in, char* out, int idn)
+{
+    char encoded[MAX_NAME_LENGTH];
+    size_t len = strnlen(in, MAX_NAME_LENGTH - 1);
+    int hasHigh;
+    int rc;
+
+    /* A fully qualified name means the same thing without its root dot */
+    while (len > 0 && in[len - 1] == '.') {
+        len--;
+    }
+    if (len == 0) {
+        out[0] = '\0';
+        return NAME_ERR_EMPTY;
+    }
+
+    rc = validate(in, out, len, &hasHigh);
+    if (hasHigh && idn) {
+        /* Encode from the caller's text, then validate the ASCII result */
+        memcpy(encoded, in, len);
+        if ((rc = idn_encode(encoded, len, out)) != NAME_OK) {
+            return rc;
+        }
+        len = strlen(out);
+        memcpy(encoded, out, len + 1);
+        rc = validate(encoded, out, len, &hasHigh);
+    }
+    if (rc == NAME_OK && len > NAME_MAX_TEXT) {
+        rc = NAME_ERR_LENGTH;
+    }
+    return rc;
+}
+
+
+int normalize_batch(char in[][MAX_NAME_LENGTH], char out[][MAX_NAME_LENGTH],
+                    int* codes, int count, int idn)
+{
+    int i;
+    int ok = 0;
+
+    for (i = 0; i < count; ++i) {
+        codes[i] = normalize_name(in[i], out[i], idn);
+        ok += codes[i] == NAME_OK;
+    }
+    return ok;
+}
+
+
+const char* normalize_strerror(int code)
+{
+    if (code < 0 || code > NAME_ERR_IDN) {
+        return "INVALID";
+    }
+    return nameErrors[code];
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * FILE: normalize.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for hostname normalization and
+ *      validation, run by requesters before a name is queued.
+ *  Names are lowercased and stripped of trailing dots, then checked for
+ *      total length, label length, empty labels and character set, so a
+ *      malformed name never costs a resolver round-trip.
+ *  Names are scanned 16 bytes at a time with SSE2 where available.
+ *  Non-ASCII labels may optionally be converted to punycode (RFC 3492).
+ *
+ ******************************************************************************/
+
+#ifndef NORMALIZE_H
+#define NORMALIZE_H
+
+/* Standard Includes */
+#include <stdio.h>
+
+/* Local Includes */
+#include "dispatch.h"
+
+
+/* Normalization results */
+#define NAME_OK                 0
+#define NAME_ERR_EMPTY          1       // Nothing left after stripping dots
+#define NAME_ERR_LENGTH         2       // Longer than NAME_MAX_TEXT
+#define NAME_ERR_LABEL_LENGTH   3       // A label longer than NAME_MAX_LABEL
+#define NAME_ERR_EMPTY_LABEL    4       // Leading or doubled dot
+#define NAME_ERR_CHARSET        5       // Not [a-z0-9_-], or hyphen at label edge
+#define NAME_ERR_IDN            6       // Bad UTF-8 or punycode overflow
+
+#define NAME_MAX_TEXT           253     // Longest name DNS can carry
+#define NAME_MAX_LABEL          63
+#define NORMALIZE_BATCH         16      // Names normalized per batch
+
+
+/* Function to read the next whitespace separated name from fp into
+ * name (MAX_NAME_LENGTH bytes); a longer token is consumed and truncated
+ * Returns NAME_OK, NAME_ERR_LENGTH if truncated, or EOF
+ */
+int normalize_read(FILE* fp, char* name);
+
+/* Function to normalize one name from in into out (both MAX_NAME_LENGTH
+ * bytes; they may be the same buffer), converting non-ASCII labels to
+ * punycode when idn is set
+ * Returns NAME_OK or a NAME_ERR_* code
+ */
+int normalize_name(const char* in, char* out, int idn);
+
+/* Function to normalize count names, storing each result code in codes
+ * Returns the number of names that normalized to NAME_OK
+ */
+int normalize_batch(char in[][MAX_NAME_LENGTH], char out[][MAX_NAME_LENGTH],
+                    int* codes, int count, int idn);
+
+/* Function to return the output status string for a NAME_ERR_* code */
+const char* normalize_strerror(int code);
+
+#endif
@@ -0,0 +1,253 @@
+/******************************************************************************
+ * FILE: normalizeTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for hostname normalization in normalize.h.
+ *  normalize.c is built into this file, so the SSE2 classifier can be
+ *      checked against the scalar fallback and punycode encoded directly.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NORMALIZE_TEST          // Build the scalar fallback too
+#include "normalize.c"
+
+#define TEST_RANDOM     200000  // Random names scanned both ways
+#define TEST_SEED       3753
+
+/* RFC 3492 section 7.1 samples, with basic code points lowercased */
+static const char* const punySamples[][2] = {
+        {"\u0644\u064A\u0647\u0645\u0627\u0628\u062A\u0643\u0644\u0645\u0648\u0634\u0639\u0631\u0628\u064A\u061F",
+         "xn--egbpdaj6bu4bxfgehfvwxn"},   // (A)
+        {"\u4ED6\u4EEC\u4E3A\u4EC0\u4E48\u4E0D\u8BF4\u4E2D\u6587",
+         "xn--ihqwcrb4cv8a8dqg056pqjye"},   // (B)
+        {"\u4ED6\u5011\u7232\u4EC0\u9EBD\u4E0D\u8AAA\u4E2D\u6587",
+         "xn--ihqwctvzc91f659drss3x8bo0yb"},   // (C)
+        {"Pro\u010Dprost\u011Bnemluv\u00ED\u010Desky",
+         "xn--proprostnemluvesky-uyb24dma41a"},   // (D)
+        {"\u05DC\u05DE\u05D4\u05D4\u05DD\u05E4\u05E9\u05D5\u05D8\u05DC\u05D0\u05DE\u05D3\u05D1\u05E8\u05D9\u05DD\u05E2\u05D1\u05E8\u05D9\u05EA",
+         "xn--4dbcagdahymbxekheh6e0a7fei0b"},   // (E)
+        {"\u092F\u0939\u0932\u094B\u0917\u0939\u093F\u0928\u094D\u0926\u0940\u0915\u094D\u092F\u094B\u0902\u0928\u0939\u0940\u0902\u092C\u094B\u0932\u0938\u0915\u0924\u0947\u0939\u0948\u0902",
+         "xn--i1baa7eci9glrd9b2ae1bj0hfcgg6iyaf8o0a1dig0cd"},   // (F)
+        {"\u306A\u305C\u307F\u3093\u306A\u65E5\u672C\u8A9E\u3092\u8A71\u3057\u3066\u304F\u308C\u306A\u3044\u306E\u304B",
+         "xn--n8jok5ay5dzabd5bym9f0cm5685rrjetr6pdxa"},   // (G)
+        {"\u043F\u043E\u0447\u0435\u043C\u0443\u0436\u0435\u043E\u043D\u0438\u043D\u0435\u0433\u043E\u0432\u043E\u0440\u044F\u0442\u043F\u043E\u0440\u0443\u0441\u0441\u043A\u0438",
+         "xn--b1abfaaepdrnnbgefbadotcwatmq2g4l"},   // (I)
+        {"Porqu\u00E9nopuedensimplementehablarenEspa\u00F1ol",
+         "xn--porqunopuedensimplementehablarenespaol-fmd56a"},   // (J)
+        {"T\u1EA1isaoh\u1ECDkh\u00F4ngth\u1EC3ch\u1EC9n\u00F3iti\u1EBFngVi\u1EC7t",
+         "xn--tisaohkhngthchnitingvit-kjcr8268qyxafd2f1b9g"},   // (K)
+        {"3\u5E74B\u7D44\u91D1\u516B\u5148\u751F",
+         "xn--3b-ww4c5e180e575a65lsy2b"},   // (L)
+        {"\u5B89\u5BA4\u5948\u7F8E\u6075-with-SUPER-MONKEYS",
+         "xn---with-super-monkeys-pc58ag80a8qai00g7n9n"},   // (M)
+        {"Hello-Another-Way-\u305D\u308C\u305E\u308C\u306E\u5834\u6240",
+         "xn--hello-another-way--fc4qua05auwb3674vfr0b"},   // (N)
+        {"\u3072\u3068\u3064\u5C4B\u6839\u306E\u4E0B2",
+         "xn--2-u9tlzr9756bt3uc0v"},   // (O)
+        {"Maji\u3067Koi\u3059\u308B5\u79D2\u524D",
+         "xn--majikoi5-783gue6qz075azm5e"},   // (P)
+        {"\u30D1\u30D5\u30A3\u30FCde\u30EB\u30F3\u30D0",
+         "xn--de-jg4avhby1noc0d"},   // (Q)
+        {"\u305D\u306E\u30B9\u30D4\u30FC\u30C9\u3067",
+         "xn--d9juau41awczczp"},   // (R)
+};
+
+
+/* Check normalize_name() gives code and, on success, expect
+ * Returns 1 on a mismatch
+ */
+static int check(const char* in, int idn, int code, const char* expect)
+{
+    char name[MAX_NAME_LENGTH];
+    char out[MAX_NAME_LENGTH];
+    int rc;
+
+    /* The classifier may read a whole chunk past the name, as in a buffer */
+    memset(name, 'X', sizeof(name));
+    strcpy(name, in);
+    rc = normalize_name(name, out, idn);
+    if (rc != code || (code == NAME_OK && strcmp(out, expect))) {
+        fprintf(stderr, "error: [%.40s%s] (%zu bytes) gave %s [%.40s], expected %s [%.40s]\n",
+                in, strlen(in) > 40 ? "..." : "", strlen(in), normalize_strerror(rc),
+                rc == NAME_OK ? out : "", normalize_strerror(code),
+                code == NAME_OK ? expect : "");
+        return 1;
+    }
+    return 0;
+}
+
+
+/* Fill name with labels of the given lengths, joined by dots */
+static char* labels(char* name, const int* lengths, int count)
+{
+    char* p = name;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        if (i) {
+            *p++ = '.';
+        }
+        memset(p, 'a' + i, lengths[i]);
+        p += lengths[i];
+    }
+    *p = '\0';
+    return name;
+}
+
+
+/* Scan a name with the SSE2 and scalar classifiers
+ * Returns 1 if they disagree
+ */
+static int compare(const char* in, size_t len)
+{
+    unsigned short dots[2][NUM_CHUNKS];
+    unsigned short bad[2][NUM_CHUNKS];
+    unsigned short high[2][NUM_CHUNKS];
+    char out[2][MAX_NAME_LENGTH];
+    size_t chunks = (len + CHUNK - 1) / CHUNK;
+
+    classify(in, out[0], len, dots[0], bad[0], high[0]);
+    classify_scalar(in, out[1], len, dots[1], bad[1], high[1]);
+    if (memcmp(out[0], out[1], len)
+            || memcmp(dots[0], dots[1], chunks * sizeof(dots[0][0]))
+            || memcmp(bad[0], bad[1], chunks * sizeof(bad[0][0]))
+            || memcmp(high[0], high[1], chunks * sizeof(high[0][0]))) {
+        fprintf(stderr, "error: classifiers disagree on a %zu byte name\n", len);
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    static const char alphabet[] = "abcXYZ059.-_ $@\x7f\x80\xc3\xa9\xff";
+    char name[MAX_NAME_LENGTH];
+    char expect[MAX_NAME_LENGTH];
+    char out[MAX_NAME_LENGTH];
+    int lengths[5];
+    int failures = 0;
+    int code;
+    int rc;
+    int len;
+    int i;
+    int j;
+
+    /* Lowercasing and trailing dots */
+    failures += check("WWW.Example.COM", 0, NAME_OK, "www.example.com");
+    failures += check("www.example.com.", 0, NAME_OK, "www.example.com");
+    failures += check("Host_1-2.Example...", 0, NAME_OK, "host_1-2.example");
+    failures += check("", 0, NAME_ERR_EMPTY, NULL);
+    failures += check("...", 0, NAME_ERR_EMPTY, NULL);
+
+    /* Empty labels, hyphens at label edges and stray characters */
+    failures += check(".example.com", 0, NAME_ERR_EMPTY_LABEL, NULL);
+    failures += check("www..example.com", 0, NAME_ERR_EMPTY_LABEL, NULL);
+    failures += check("-www.example.com", 0, NAME_ERR_CHARSET, NULL);
+    failures += check("www-.example.com", 0, NAME_ERR_CHARSET, NULL);
+    failures += check("www.example.com-", 0, NAME_ERR_CHARSET, NULL);
+    failures += check("www.ex-ample.com", 0, NAME_OK, "www.ex-ample.com");
+    failures += check("www.exa$mple.com", 0, NAME_ERR_CHARSET, NULL);
+
+    /* Labels of 63 and 64 characters, names of 253 and 254 */
+    lengths[0] = 63;
+    lengths[1] = 3;
+    failures += check(labels(name, lengths, 2), 0, NAME_OK, name);
+    lengths[0] = 64;
+    failures += check(labels(name, lengths, 2), 0, NAME_ERR_LABEL_LENGTH, NULL);
+    lengths[0] = lengths[1] = lengths[2] = 63;
+    lengths[3] = 61;
+    failures += check(labels(name, lengths, 4), 0, NAME_OK, name);
+    strcpy(expect, name);
+    strcat(name, ".");
+    failures += check(name, 0, NAME_OK, expect);
+    lengths[3] = 62;
+    failures += check(labels(name, lengths, 4), 0, NAME_ERR_LENGTH, NULL);
+
+    /* Names and labels ending on and across 16-byte chunk edges, with the
+     * character at the edge checked on both sides */
+    for (len = 1; len <= 4 * CHUNK + 1; ++len) {
+        code = len <= NAME_MAX_LABEL ? NAME_OK : NAME_ERR_LABEL_LENGTH;
+        memset(name, 'a', len);
+        name[len] = '\0';
+        failures += check(name, 0, code, name);
+        for (j = CHUNK - 1; j <= CHUNK; ++j) {
+            lengths[0] = j;
+            lengths[1] = len;
+            failures += check(labels(name, lengths, 2), 0, code, name);
+            name[j - 1] = '-';
+            failures += check(name, 0, NAME_ERR_CHARSET, NULL);
+            name[j - 1] = 'a';
+            name[j + 1] = '-';
+            failures += check(name, 0, code ? code : NAME_ERR_CHARSET, NULL);
+            name[j + len] = '-';
+            failures += check(name, 0, code ? code : NAME_ERR_CHARSET, NULL);
+            name[j + len] = 'b';
+            name[j + 1] = 'B';
+            strcpy(expect, name);
+            expect[j + 1] = 'b';
+            failures += check(name, 0, code, expect);
+            if (len > 1) {
+                name[j + 1] = '.';
+                failures += check(name, 0, NAME_ERR_EMPTY_LABEL, NULL);
+            }
+        }
+    }
+
+    /* The SSE2 classifier agrees with the scalar one on random names */
+    srand(TEST_SEED);
+    for (i = 0; i < TEST_RANDOM; ++i) {
+        len = rand() % (MAX_NAME_LENGTH - 1) + 1;
+        for (j = 0; j < len; ++j) {
+            name[j] = alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        memset(name + len, 'X', sizeof(name) - len);
+        if (compare(name, len)) {
+            failures++;
+            break;
+        }
+    }
+
+    /* RFC 3492 samples, as one label and between ASCII labels */
+    for (i = 0; i < (int) (sizeof(punySamples) / sizeof(punySamples[0])); ++i) {
+        rc = idn_encode(punySamples[i][0], strlen(punySamples[i][0]), out);
+        if (rc != NAME_OK || strcmp(out, punySamples[i][1])) {
+            fprintf(stderr, "error: sample %d encoded to %s, expected %s\n",
+                    i, rc == NAME_OK ? out : normalize_strerror(rc), punySamples[i][1]);
+            failures++;
+        }
+    }
+    snprintf(name, sizeof(name), "www.%s.com", punySamples[0][0]);
+    snprintf(expect, sizeof(expect), "www.%s.com", punySamples[0][1]);
+    rc = idn_encode(name, strlen(name), out);
+    if (rc != NAME_OK || strcmp(out, expect)) {
+        fprintf(stderr, "error: a name with an IDN label encoded to %s\n", out);
+        failures++;
+    }
+
+    /* IDN through normalize_name(), and only when asked for */
+    failures += check("Bücher.Example.", 1, NAME_OK, "xn--bcher-kva.example");
+    failures += check("Bücher.Example.", 0, NAME_ERR_CHARSET, NULL);
+    failures += check("\xff\xfe.example", 1, NAME_ERR_IDN, NULL);
+    failures += check("\xc3.example", 1, NAME_ERR_IDN, NULL);
+
+    if (failures) {
+        fprintf(stderr, "%d normalize test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All normalize tests passed\n");
+
+    return EXIT_SUCCESS;
+}
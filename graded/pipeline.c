@@ -0,0 +1,334 @@
+/******************************************************************************
+ * FILE: pipeline.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the staged pipeline runtime.
+ *  Each queue is a ring of item-sized slots under one lock; takers wait on
+ *      notEmpty and putters on notFull. A stage's threads keep their time
+ *      and item counts locally and add them to the stage as they exit; the
+ *      last one out closes the next queue.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+#include "util.h"
+
+
+static int pipeline_queue_init(pipeline_queue* q, int capacity, size_t itemSize)
+{
+    memset(q, 0, sizeof(*q));
+    if ((q->items = malloc((size_t) capacity * itemSize)) == NULL) {
+        return PIPELINE_FAILURE;
+    }
+    q->itemSize = itemSize;
+    q->capacity = capacity;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->notEmpty, NULL);
+    pthread_cond_init(&q->notFull, NULL);
+    return PIPELINE_SUCCESS;
+}
+
+
+static void pipeline_queue_close(pipeline_queue* q)
+{
+    pthread_mutex_lock(&q->lock);
+    q->closed = 1;
+    pthread_cond_broadcast(&q->notEmpty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+
+/* Put count items, waiting for room as needed */
+static void pipeline_queue_put(pipeline_queue* q, const unsigned char* items, int count)
+{
+    int tail;
+    int n;
+
+    pthread_mutex_lock(&q->lock);
+    while (count > 0) {
+        while (q->count == q->capacity) {
+            pthread_cond_wait(&q->notFull, &q->lock);
+        }
+        for (n = 0; n < count && q->count < q->capacity; ++n) {
+            tail = (q->head + q->count) % q->capacity;
+            memcpy(q->items + (size_t) tail * q->itemSize, items, q->itemSize);
+            items += q->itemSize;
+            q->count++;
+        }
+        count -= n;
+        pthread_cond_broadcast(&q->notEmpty);
+    }
+    pthread_mutex_unlock(&q->lock);
+}
+
+
+/* Take up to max items, waiting until there is one or the queue is closed
+ * Returns the items taken, 0 once the queue is closed and empty
+ */
+static int pipeline_queue_take(pipeline_queue* q, unsigned char* items, int max)
+{
+    int n;
+
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0 && !q->closed) {
+        pthread_cond_wait(&q->notEmpty, &q->lock);
+    }
+    for (n = 0; n < max && q->count > 0; ++n) {
+        memcpy(items + (size_t) n * q->itemSize,
+               q->items + (size_t) q->head * q->itemSize, q->itemSize);
+        q->head = (q->head + 1) % q->capacity;
+        q->count--;
+    }
+    if (n) {
+        pthread_cond_broadcast(&q->notFull);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
+
+
+void pipeline_init(pipeline* p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+
+pipeline_stage* pipeline_add_stage(pipeline* p, const char* name, int threads,
+                                   int batch, int capacity, size_t itemSize,
+                                   pipeline_fn fn, pipeline_finish_fn finish,
+                                   void* arg)
+{
+    pipeline_stage* s;
+
+    if (p->numStages == PIPELINE_MAX_STAGES || threads < 1
+            || threads > PIPELINE_MAX_THREADS || batch < 1
+            || (fn == NULL && p->numStages == 0)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    s = &p->stages[p->numStages];
+    memset(s, 0, sizeof(*s));
+    if (p->numStages && fn
+            && (capacity < 1 || itemSize == 0
+                || pipeline_queue_init(&s->input, capacity, itemSize) == PIPELINE_FAILURE)) {
+        return NULL;
+    }
+    /* Batch buffers are allocated here, so a thread never starts without
+     * one and leaves upstream blocked on a queue nobody drains */
+    if ((s->tids = malloc(threads * sizeof(*s->tids))) == NULL
+            || (s->input.items
+                && (s->buffers = malloc((size_t) threads * batch * itemSize)) == NULL)) {
+        free(s->tids);
+        free(s->input.items);
+        return NULL;
+    }
+    s->name = name;
+    s->threads = threads;
+    s->batch = batch;
+    s->fn = fn;
+    s->finish = finish;
+    s->arg = arg;
+    if (p->numStages) {
+        p->stages[p->numStages - 1].next = s;
+    }
+    p->numStages++;
+    return s;
+}
+
+
+int pipeline_emit(pipeline_worker* w, const void* items, int count)
+{
+    long long start = monotonic_ns();
+
+    if (w->stage->next == NULL) {
+        return PIPELINE_FAILURE;
+    }
+    pipeline_queue_put(&w->stage->next->input, (const unsigned char*) items, count);
+    w->blocked += monotonic_ns() - start;
+    w->items += count;
+    return PIPELINE_SUCCESS;
+}
+
+
+int pipeline_push(pipeline_stage* stage, const void* items, int count)
+{
+    if (stage->input.itemSize == 0) {
+        return PIPELINE_FAILURE;
+    }
+    pipeline_queue_put(&stage->input, (const unsigned char*) items, count);
+    return PIPELINE_SUCCESS;
+}
+
+
+void pipeline_blocked(pipeline_worker* w, long long ns)
+{
+    w->blocked += ns;
+}
+
+
+/* Run the finish hook of a stage with no threads left and close the next
+ * stage's queue, or finish the next stage too if it is external */
+static void pipeline_stage_exit(pipeline_stage* s)
+{
+    for (; s; s = s->next) {
+        if (s->finish) {
+            s->finish(s->arg);
+        }
+        if (s->next && s->next->fn) {
+            pipeline_queue_close(&s->next->input);
+            break;
+        }
+    }
+}
+
+
+static void* pipeline_thread(void* arg)
+{
+    pipeline_stage* s = (pipeline_stage*) arg;
+    pipeline_worker w = {s, 0, 0};
+    unsigned char* batch = NULL;
+    unsigned long items = 0;
+    unsigned long batches = 0;
+    long long busy = 0;
+    long long blocked = 0;
+    long long idle = 0;
+    long long start;
+    int source = s->input.itemSize == 0;
+    int count = 0;
+    int rc;
+
+    if (!source) {
+        batch = s->buffers + (size_t) __atomic_fetch_add(&s->claimed, 1, __ATOMIC_RELAXED)
+            * s->batch * s->input.itemSize;
+    }
+
+    for (;;) {
+        if (!source) {
+            start = monotonic_ns();
+            count = pipeline_queue_take(&s->input, batch, s->batch);
+            idle += monotonic_ns() - start;
+            if (count == 0) {
+                break;
+            }
+        }
+
+        w.blocked = 0;
+        w.items = 0;
+        start = monotonic_ns();
+        rc = s->fn(&w, batch, count, s->arg);
+        busy += monotonic_ns() - start - w.blocked;
+        blocked += w.blocked;
+        items += source ? w.items : (unsigned long) count;
+        batches++;
+
+        if (source && rc == PIPELINE_DONE) {
+            break;
+        }
+    }
+
+    __atomic_fetch_add(&s->items, items, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->batches, batches, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->busy, busy, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->blocked, blocked, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->idle, idle, __ATOMIC_RELAXED);
+
+    /* The Last Thread Out Passes Completion Downstream */
+    if (__atomic_sub_fetch(&s->running, 1, __ATOMIC_ACQ_REL) == 0) {
+        pipeline_stage_exit(s);
+    }
+    return NULL;
+}
+
+
+int pipeline_run(pipeline* p)
+{
+    long long start = monotonic_ns();
+    pipeline_stage* s;
+    int started;
+    int rc = PIPELINE_SUCCESS;
+    int i;
+    int t;
+
+    /* Start Downstream First, So No Stage Waits on One Not Yet Running */
+    for (i = p->numStages - 1; i >= 0; --i) {
+        s = &p->stages[i];
+        if (s->fn == NULL) {
+            continue;
+        }
+        s->running = s->threads;
+        for (started = 0; started < s->threads; ++started) {
+            if (pthread_create(&s->tids[started], NULL, pipeline_thread, s)) {
+                break;
+            }
+        }
+        if (started < s->threads) {
+            /* Nothing upstream will start: drain what did, then cascade */
+            fprintf(stderr, "PTHREAD ERROR: Started %d of %d %s threads\n",
+                    started, s->threads, s->name);
+            rc = PIPELINE_FAILURE;
+            if (i > 0) {
+                pipeline_queue_close(&s->input);
+            }
+            if (__atomic_sub_fetch(&s->running, s->threads - started, __ATOMIC_ACQ_REL) == 0) {
+                pipeline_stage_exit(s);
+            }
+            s->threads = started;
+            break;
+        }
+    }
+    for (i = i < 0 ? 0 : i; i < p->numStages; ++i) {
+        for (t = 0; p->stages[i].fn && t < p->stages[i].threads; ++t) {
+            pthread_join(p->stages[i].tids[t], NULL);
+        }
+    }
+
+    p->elapsed = monotonic_ns() - start;
+    return rc;
+}
+
+
+void pipeline_report(const pipeline* p, FILE* fp)
+{
+    const pipeline_stage* s;
+    double capacity;
+    int i;
+
+    fprintf(fp, "STAGE: %-10s %7s %10s %8s %8s %8s\n",
+            "stage", "threads", "items", "busy", "blocked", "idle");
+    for (i = 0; i < p->numStages; ++i) {
+        s = &p->stages[i];
+        capacity = (double) s->threads * p->elapsed;
+        if (capacity <= 0) {
+            capacity = 1;
+        }
+        fprintf(fp, "STAGE: %-10s %7d %10lu %7.1f%% %7.1f%% %7.1f%%\n",
+                s->name, s->threads, s->items,
+                100.0 * s->busy / capacity, 100.0 * s->blocked / capacity,
+                100.0 * s->idle / capacity);
+    }
+}
+
+
+void pipeline_free(pipeline* p)
+{
+    int i;
+
+    for (i = 0; i < p->numStages; ++i) {
+        if (p->stages[i].input.items) {
+            free(p->stages[i].input.items);
+            pthread_mutex_destroy(&p->stages[i].input.lock);
+            pthread_cond_destroy(&p->stages[i].input.notEmpty);
+            pthread_cond_destroy(&p->stages[i].input.notFull);
+        }
+        free(p->stages[i].tids);
+        free(p->stages[i].buffers);
+    }
+    memset(p, 0, sizeof(*p));
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * FILE: pipeline.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for a small staged pipeline runtime.
+ *  A pipeline is a chain of stages, each with its own thread pool and batch
+ *      size. The first stage is a source: its function is called until it
+ *      says it is done. Every later stage reads fixed-size items from a
+ *      bounded queue fed by the stage before it, a batch at a time.
+ *  A full queue blocks the stage feeding it, so a slow stage holds back
+ *      every stage before it. When the last thread of a stage exits, the
+ *      stage's finish hook runs and the next stage's queue is closed; that
+ *      stage exits once it has drained its queue, and so on down the chain.
+ *  A stage without a function is external: its threads belong to someone
+ *      else (a resolver pool, say) and are fed and drained outside the
+ *      runtime. It has no queue and is done once the stage before it is
+ *      done and its finish hook returns; the caller fills in its accounting.
+ *  Each stage's threads are timed as busy (in the stage function), blocked
+ *      (waiting for room downstream) or idle (waiting for input), so
+ *      pipeline_report() shows which stage is the bottleneck.
+ *
+ ******************************************************************************/
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/* Standard Includes */
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+#define PIPELINE_FAILURE        -1
+#define PIPELINE_SUCCESS        0
+
+#define PIPELINE_MORE           0       // Source stage: call again
+#define PIPELINE_DONE           1       // Source stage: this thread is done
+
+#define PIPELINE_MAX_STAGES     8
+#define PIPELINE_MAX_THREADS    1024    // Per stage
+
+
+struct pipeline_s;
+
+/* A bounded queue of fixed-size items, copied in and out */
+typedef struct pipeline_queue_s {
+    unsigned char* items;
+    size_t itemSize;
+    int capacity;
+    int head;                   // Next item to take
+    int count;
+    int closed;                 // No more items will be put
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+} pipeline_queue;
+
+/* The thread running a stage function, passed to it for emitting */
+typedef struct pipeline_worker_s {
+    struct pipeline_stage_s* stage;
+    long long blocked;          // ns spent waiting downstream this call
+    unsigned long items;        // Items emitted this call, or counted by a
+                                // source stage that feeds something else
+} pipeline_worker;
+
+/* Function run on a batch of count items (NULL and 0 for a source stage)
+ * Returns PIPELINE_MORE or PIPELINE_DONE; only a source stage may finish
+ * early
+ */
+typedef int (*pipeline_fn)(pipeline_worker* w, void* items, int count, void* arg);
+
+/* Function run once, after the last thread of a stage exits */
+typedef void (*pipeline_finish_fn)(void* arg);
+
+typedef struct pipeline_stage_s {
+    const char* name;
+    int threads;
+    int batch;                  // Most items handed to fn at once
+    pipeline_fn fn;             // NULL for an external stage
+    pipeline_finish_fn finish;  // May be NULL
+    void* arg;
+    pipeline_queue input;       // Unused for source and external stages
+    struct pipeline_stage_s* next;      // NULL for the last stage
+    pthread_t* tids;
+    unsigned char* buffers;     // A batch of items per thread, NULL for
+                                // source and external stages
+    int claimed;                // Buffers handed to threads so far
+    int running;                // Threads not yet exited
+    /* Accounting, summed over the stage's threads as they exit */
+    unsigned long items;        // Taken, or produced by the source stage
+    unsigned long batches;      // Calls to fn
+    long long busy;
+    long long blocked;
+    long long idle;
+} pipeline_stage;
+
+typedef struct pipeline_s {
+    pipeline_stage stages[PIPELINE_MAX_STAGES];
+    int numStages;
+    long long elapsed;          // ns from start to the last stage exiting
+} pipeline;
+
+
+/* Function to set up an empty pipeline */
+void pipeline_init(pipeline* p);
+
+/* Function to add a stage after the existing ones; the first stage added is
+ * the source and ignores capacity and itemSize, as does an external stage
+ * (fn NULL), which may not be the source
+ * Returns the stage, or NULL if out of memory or stages
+ */
+pipeline_stage* pipeline_add_stage(pipeline* p, const char* name, int threads,
+                                   int batch, int capacity, size_t itemSize,
+                                   pipeline_fn fn, pipeline_finish_fn finish,
+                                   void* arg);
+
+/* Function to put count items on the next stage's queue from a stage
+ * function, waiting for room
+ * Returns PIPELINE_SUCCESS, or PIPELINE_FAILURE if there is no next stage
+ */
+int pipeline_emit(pipeline_worker* w, const void* items, int count);
+
+/* Function to put count items on a stage's queue from a thread outside
+ * the pipeline, waiting for room; stage must not have been closed
+ * Returns PIPELINE_SUCCESS or PIPELINE_FAILURE
+ */
+int pipeline_push(pipeline_stage* stage, const void* items, int count);
+
+/* Function to count ns a stage function spent waiting on something outside
+ * the pipeline as blocked time */
+void pipeline_blocked(pipeline_worker* w, long long ns);
+
+/* Function to start every stage and wait until the last one has drained
+ * Returns PIPELINE_SUCCESS, or PIPELINE_FAILURE if a thread could not be
+ * started (stages already running are still drained)
+ */
+int pipeline_run(pipeline* p);
+
+/* Function to print each stage's thread count, items and utilization */
+void pipeline_report(const pipeline* p, FILE* fp);
+
+/* Function to free the stages' queues */
+void pipeline_free(pipeline* p);
+
+#endif
@@ -0,0 +1,254 @@
+/******************************************************************************
+ * FILE: pipelineTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the staged pipeline runtime in
+ *      pipeline.h.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pipeline.h"
+
+#define TEST_ITEMS      200000
+#define SLOW_ITEMS      2000
+#define SOURCE_BATCH    64
+
+typedef struct test_state_s {
+    long limit;                 // Items the source produces
+    long next;                  // Next item to produce, taken atomically
+    long count;                 // Items reaching the last stage
+    long long sum;
+    int slow;                   // Sleep in the last stage
+    int finished[3];            // Order in which finish hooks ran
+    int numFinished;
+} test_state;
+
+
+static int produce(pipeline_worker* w, void* items, int count, void* arg)
+{
+    test_state* t = (test_state*) arg;
+    long batch[SOURCE_BATCH];
+    long first;
+    int n;
+
+    (void) items;
+    (void) count;
+
+    first = __atomic_fetch_add(&t->next, SOURCE_BATCH, __ATOMIC_RELAXED);
+    for (n = 0; n < SOURCE_BATCH && first + n < t->limit; ++n) {
+        batch[n] = first + n;
+    }
+    if (n) {
+        pipeline_emit(w, batch, n);
+    }
+    return n < SOURCE_BATCH ? PIPELINE_DONE : PIPELINE_MORE;
+}
+
+
+static int square(pipeline_worker* w, void* items, int count, void* arg)
+{
+    long* values = (long*) items;
+    int i;
+
+    (void) arg;
+
+    for (i = 0; i < count; ++i) {
+        values[i] *= values[i];
+    }
+    pipeline_emit(w, values, count);
+    return PIPELINE_MORE;
+}
+
+
+/* One thread, so no lock is needed for the totals */
+static int total(pipeline_worker* w, void* items, int count, void* arg)
+{
+    test_state* t = (test_state*) arg;
+    long* values = (long*) items;
+    int i;
+
+    (void) w;
+
+    for (i = 0; i < count; ++i) {
+        t->sum += values[i];
+        t->count++;
+        if (t->slow) {
+            usleep(100);
+        }
+    }
+    return PIPELINE_MORE;
+}
+
+
+/* Source for an external middle stage: pushes past it to the last stage */
+static pipeline_stage* outsideNext;
+
+static int produce_around(pipeline_worker* w, void* items, int count, void* arg)
+{
+    test_state* t = (test_state*) arg;
+    long value;
+
+    (void) items;
+    (void) count;
+
+    if ((value = __atomic_fetch_add(&t->next, 1, __ATOMIC_RELAXED)) >= t->limit) {
+        return PIPELINE_DONE;
+    }
+    value *= value;
+    pipeline_push(outsideNext, &value, 1);
+    w->items++;
+    return PIPELINE_MORE;
+}
+
+
+static test_state* finishing;
+
+static void finish_source(void* arg)
+{
+    (void) arg;
+    finishing->finished[finishing->numFinished++] = 0;
+}
+
+static void finish_square(void* arg)
+{
+    (void) arg;
+    finishing->finished[finishing->numFinished++] = 1;
+}
+
+static void finish_total(void* arg)
+{
+    (void) arg;
+    finishing->finished[finishing->numFinished++] = 2;
+}
+
+
+/* Run source -> square -> total over limit items
+ * Returns the number of failed checks
+ */
+static int run(test_state* t, long limit, int slow, pipeline* p)
+{
+    long long expect = 0;
+    long i;
+    int failures = 0;
+
+    memset(t, 0, sizeof(*t));
+    t->limit = limit;
+    t->slow = slow;
+    finishing = t;
+    for (i = 0; i < limit; ++i) {
+        expect += i * i;
+    }
+
+    pipeline_init(p);
+    if (pipeline_add_stage(p, "source", 4, 1, 0, 0, produce, finish_source, t) == NULL
+            || pipeline_add_stage(p, "square", 3, 16, 8, sizeof(long), square,
+                                  finish_square, t) == NULL
+            || pipeline_add_stage(p, "total", 1, 32, 64, sizeof(long), total,
+                                  finish_total, t) == NULL) {
+        fprintf(stderr, "error: pipeline_add_stage failed\n");
+        return 1;
+    }
+    if (pipeline_run(p) == PIPELINE_FAILURE) {
+        fprintf(stderr, "error: pipeline_run failed\n");
+        failures++;
+    }
+
+    /* Every item arrives once, and each stage finishes after the one before */
+    if (t->count != limit || t->sum != expect) {
+        fprintf(stderr, "error: %ld items summing to %lld, expected %ld and %lld\n",
+                t->count, t->sum, limit, expect);
+        failures++;
+    }
+    if (t->numFinished != 3 || t->finished[0] != 0 || t->finished[1] != 1
+            || t->finished[2] != 2) {
+        fprintf(stderr, "error: stages finished out of order\n");
+        failures++;
+    }
+    if (p->stages[0].items != (unsigned long) limit
+            || p->stages[1].items != (unsigned long) limit
+            || p->stages[2].items != (unsigned long) limit) {
+        fprintf(stderr, "error: stage item counts are %lu, %lu, %lu\n",
+                p->stages[0].items, p->stages[1].items, p->stages[2].items);
+        failures++;
+    }
+    return failures;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    test_state t;
+    pipeline p;
+    int failures = 0;
+
+    /* A stage must have threads and a batch; the source needs no queue */
+    pipeline_init(&p);
+    if (pipeline_add_stage(&p, "none", 0, 1, 0, 0, produce, NULL, &t) != NULL
+            || pipeline_add_stage(&p, "none", 1, 0, 0, 0, produce, NULL, &t) != NULL) {
+        fprintf(stderr, "error: a stage without threads or batch was added\n");
+        failures++;
+    }
+    pipeline_free(&p);
+
+    /* Many items through small queues */
+    failures += run(&t, TEST_ITEMS, 0, &p);
+    pipeline_free(&p);
+
+    /* An empty source still cascades completion */
+    failures += run(&t, 0, 0, &p);
+    pipeline_free(&p);
+
+    /* An external stage finishes between its neighbours */
+    memset(&t, 0, sizeof(t));
+    t.limit = TEST_ITEMS / 10;
+    finishing = &t;
+    pipeline_init(&p);
+    if (pipeline_add_stage(&p, "outside", 2, 1, 0, 0, NULL, NULL, &t) != NULL) {
+        fprintf(stderr, "error: an external source stage was added\n");
+        failures++;
+    }
+    if (pipeline_add_stage(&p, "source", 2, 1, 0, 0, produce_around, finish_source, &t) == NULL
+            || pipeline_add_stage(&p, "outside", 2, 1, 0, 0, NULL, finish_square, &t) == NULL
+            || (outsideNext = pipeline_add_stage(&p, "total", 1, 32, 64, sizeof(long), total,
+                                                 finish_total, &t)) == NULL
+            || pipeline_run(&p) == PIPELINE_FAILURE) {
+        fprintf(stderr, "error: pipeline with an external stage failed\n");
+        failures++;
+    }
+    if (t.count != t.limit || t.numFinished != 3 || t.finished[1] != 1 || t.finished[2] != 2) {
+        fprintf(stderr, "error: external stage run gave %ld of %ld items\n", t.count, t.limit);
+        failures++;
+    }
+    pipeline_free(&p);
+
+    /* A slow last stage backs up the stages before it and shows as the
+     * busiest */
+    failures += run(&t, SLOW_ITEMS, 1, &p);
+    pipeline_report(&p, stdout);
+    if (p.stages[2].busy <= p.stages[1].busy || p.stages[0].blocked == 0) {
+        fprintf(stderr, "error: the slow stage did not hold back the others\n");
+        failures++;
+    }
+    pipeline_free(&p);
+
+    if (failures) {
+        fprintf(stderr, "%d pipeline test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All pipeline tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+/******************************************************************************
+ * FILE: probes.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  Static USDT probe points for the requester/resolver pipeline, in the
+ *      "multilookup" provider. bpftrace or perf can attach to them in a
+ *      running binary, e.g.
+ *          bpftrace -e 'usdt:./multi-lookup:multilookup:dnslookup_exit
+ *                       { printf("%s %d\n", str(arg0), arg1); }'
+ *  Probes compile to a single nop when <sys/sdt.h> (systemtap-sdt-dev) is
+ *      installed, and to nothing otherwise.
+ *
+ ******************************************************************************/
+
+#ifndef PROBES_H
+#define PROBES_H
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define HAVE_USDT
+#endif
+#endif
+
+#ifdef HAVE_USDT
+#define PROBE1(name, a)         DTRACE_PROBE1(multilookup, name, a)
+#define PROBE2(name, a, b)      DTRACE_PROBE2(multilookup, name, a, b)
+#else
+#define PROBE1(name, a)         do { } while (0)
+#define PROBE2(name, a, b)      do { } while (0)
+#endif
+
+#endif
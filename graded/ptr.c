@@ -0,0 +1,79 @@
+/******************************************************************************
+ * FILE: ptr.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the reverse lookup address ranges.
+ *
+ ******************************************************************************/
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ptr.h"
+
+
+int ptr_parse(ptr_range* r, const char* text)
+{
+    char address[PTR_ADDRESS_LENGTH];
+    const char* slash = strchr(text, '/');
+    struct in_addr parsed;
+    size_t len = slash ? (size_t) (slash - text) : strlen(text);
+    char* end;
+    long prefix = 32;
+
+    if (len >= sizeof(address)) {
+        errno = EINVAL;
+        return PTR_FAILURE;
+    }
+    memcpy(address, text, len);
+    address[len] = '\0';
+    if (inet_pton(AF_INET, address, &parsed) != 1) {
+        errno = EINVAL;
+        return PTR_FAILURE;
+    }
+    if (slash) {
+        prefix = strtol(slash + 1, &end, 10);
+        if (*end != '\0' || end == slash + 1 || prefix < 0 || prefix > 32) {
+            errno = EINVAL;
+            return PTR_FAILURE;
+        }
+    }
+
+    r->size = 1ULL << (32 - prefix);
+    r->first = ntohl(parsed.s_addr) & (unsigned int) ~(r->size - 1);
+    r->next = 0;
+    return PTR_SUCCESS;
+}
+
+
+unsigned long long ptr_claim(ptr_range* r, unsigned long long count,
+                             unsigned long long* offset)
+{
+    unsigned long long start;
+
+    /* Cheap check first, so finished ranges are not pushed ever further */
+    if (__atomic_load_n(&r->next, __ATOMIC_RELAXED) >= r->size) {
+        return 0;
+    }
+    start = __atomic_fetch_add(&r->next, count, __ATOMIC_RELAXED);
+    if (start >= r->size) {
+        return 0;
+    }
+    *offset = start;
+    return start + count > r->size ? r->size - start : count;
+}
+
+
+void ptr_format(const ptr_range* r, unsigned long long offset, char* out)
+{
+    unsigned int address = r->first + (unsigned int) offset;
+
+    snprintf(out, PTR_ADDRESS_LENGTH, "%u.%u.%u.%u", address >> 24,
+             (address >> 16) & 0xff, (address >> 8) & 0xff, address & 0xff);
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * FILE: ptr.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for the IPv4 address ranges walked by
+ *      reverse (PTR) lookups.
+ *  A range is only its first address, its size and a cursor, so it costs
+ *      the same for a /32 as for a /0. Threads claim consecutive chunks of
+ *      it by advancing the cursor atomically and format each address as
+ *      they go, so a range is shared between any number of threads without
+ *      a lock and without ever holding its addresses in memory.
+ *
+ ******************************************************************************/
+
+#ifndef PTR_H
+#define PTR_H
+
+
+#define PTR_FAILURE             -1
+#define PTR_SUCCESS             0
+
+#define PTR_CHUNK               256     // Addresses claimed at a time
+#define PTR_ADDRESS_LENGTH      16      // Dotted quad with the NUL
+
+
+typedef struct ptr_range_s {
+    unsigned int first;         // First address, host byte order
+    unsigned long long size;    // Addresses in the range, 1 to 2^32
+    unsigned long long next;    // Offset of the next address to claim
+} ptr_range;
+
+
+/* Function to parse "a.b.c.d/len", or "a.b.c.d" for a single address;
+ * host bits below the prefix are ignored
+ * Returns PTR_SUCCESS, or PTR_FAILURE (errno EINVAL) if text is not one
+ */
+int ptr_parse(ptr_range* r, const char* text);
+
+/* Function to claim up to count addresses of a range not yet claimed;
+ * safe to call from many threads at once
+ * Returns the number claimed, starting at *offset, or 0 once none are left
+ */
+unsigned long long ptr_claim(ptr_range* r, unsigned long long count,
+                             unsigned long long* offset);
+
+/* Function to write the address at offset into the range to out
+ * (PTR_ADDRESS_LENGTH bytes) */
+void ptr_format(const ptr_range* r, unsigned long long offset, char* out);
+
+#endif
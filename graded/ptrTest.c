@@ -0,0 +1,150 @@
+/******************************************************************************
+ * FILE: ptrTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the address ranges in ptr.h.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ptr.h"
+
+#define TEST_THREADS    4
+#define TEST_PREFIX     "10.1.0.0/14"   // 2^18 addresses
+#define TEST_SIZE       (1 << 18)
+
+static ptr_range shared;
+static unsigned char seen[TEST_SIZE];   // Times each offset was claimed
+
+
+/* Claim chunks of the shared range until it runs out */
+static void* claimer(void* arg)
+{
+    unsigned long long offset;
+    unsigned long long count;
+    unsigned long long i;
+
+    (void) arg;
+
+    while ((count = ptr_claim(&shared, PTR_CHUNK, &offset)) > 0) {
+        for (i = 0; i < count; ++i) {
+            __atomic_fetch_add(&seen[offset + i], 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+
+/* Check text parses to a range of size starting at first
+ * Returns 1 on a mismatch
+ */
+static int check_parse(const char* text, const char* first, unsigned long long size)
+{
+    char address[PTR_ADDRESS_LENGTH];
+    ptr_range r;
+
+    if (ptr_parse(&r, text) == PTR_FAILURE) {
+        fprintf(stderr, "error: %s was not parsed\n", text);
+        return 1;
+    }
+    ptr_format(&r, 0, address);
+    if (strcmp(address, first) || r.size != size) {
+        fprintf(stderr, "error: %s parsed to %s with %llu addresses\n",
+                text, address, r.size);
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    static const char* invalid[] = {
+        "", "10.0.0", "10.0.0.256", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/-1",
+        "10.0.0.0/8x", "::1/128", "host.example.com", "10.0.0.0.0/8"
+    };
+    pthread_t threads[TEST_THREADS];
+    char address[PTR_ADDRESS_LENGTH];
+    unsigned long long offset;
+    ptr_range r;
+    int failures = 0;
+    int wrong;
+    int i;
+
+    /* Prefixes, with host bits ignored */
+    failures += check_parse("192.0.2.7", "192.0.2.7", 1);
+    failures += check_parse("192.0.2.7/32", "192.0.2.7", 1);
+    failures += check_parse("192.0.2.7/24", "192.0.2.0", 256);
+    failures += check_parse("10.200.3.4/9", "10.128.0.0", 1ULL << 23);
+    failures += check_parse("1.2.3.4/0", "0.0.0.0", 1ULL << 32);
+
+    for (i = 0; i < (int) (sizeof(invalid) / sizeof(invalid[0])); ++i) {
+        errno = 0;
+        if (ptr_parse(&r, invalid[i]) != PTR_FAILURE || errno != EINVAL) {
+            fprintf(stderr, "error: invalid range [%s] was parsed\n", invalid[i]);
+            failures++;
+        }
+    }
+
+    /* Addresses carry across octets, up to the last one */
+    ptr_parse(&r, "0.0.0.0/0");
+    ptr_format(&r, 256 + 255, address);
+    if (strcmp(address, "0.0.1.255")) {
+        fprintf(stderr, "error: offset 511 formatted as %s\n", address);
+        failures++;
+    }
+    ptr_format(&r, r.size - 1, address);
+    if (strcmp(address, "255.255.255.255")) {
+        fprintf(stderr, "error: last address formatted as %s\n", address);
+        failures++;
+    }
+
+    /* The last claim of a range is cut short, and later claims get nothing */
+    ptr_parse(&r, "10.0.0.0/24");
+    if (ptr_claim(&r, 200, &offset) != 200 || offset != 0
+            || ptr_claim(&r, 200, &offset) != 56 || offset != 200
+            || ptr_claim(&r, 200, &offset) != 0) {
+        fprintf(stderr, "error: claims of a /24 went wrong\n");
+        failures++;
+    }
+
+    /* Threads claiming at once take every address exactly once */
+    ptr_parse(&shared, TEST_PREFIX);
+    for (i = 0; i < TEST_THREADS; ++i) {
+        if (pthread_create(&threads[i], NULL, claimer, NULL)) {
+            perror("error: pthread_create failed");
+            return EXIT_FAILURE;
+        }
+    }
+    for (i = 0; i < TEST_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    for (i = 0, wrong = 0; i < TEST_SIZE; ++i) {
+        wrong += seen[i] != 1;
+    }
+    if (wrong) {
+        fprintf(stderr, "error: %d addresses not claimed exactly once\n", wrong);
+        failures++;
+    }
+
+    if (failures) {
+        fprintf(stderr, "%d ptr test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All ptr tests passed\n");
+
+    return EXIT_SUCCESS;
+}
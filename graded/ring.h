@@ -0,0 +1,93 @@
+/******************************************************************************
+ * FILE: ring.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  A header-only, macro-generated typed ring buffer.
+ *  RING_DEFINE(name, type, log2Capacity) generates a ring type called
+ *      'name' holding up to (1 << log2Capacity) values of 'type' stored
+ *      inline in its slots, plus static inline name_init(), name_is_empty(),
+ *      name_is_full(), name_size(), name_push() and name_pop() functions.
+ *  Values are copied in and out, so no heap allocation is needed per item.
+ *  The producer and consumer counters live on separate cache lines and are
+ *      published with acquire/release ordering: one producer and one consumer
+ *      may use a ring without a lock. Multiple producers or consumers must
+ *      hold their own lock, as with queue.h.
+ *  A ring contains no pointers and may be placed in shared memory.
+ *
+ ******************************************************************************/
+
+#ifndef RING_H
+#define RING_H
+
+#define RING_FAILURE        -1
+#define RING_SUCCESS        0
+
+#define RING_CACHE_LINE     64
+
+
+#define RING_DEFINE(name, type, log2Capacity)                                 \
+                                                                              \
+typedef struct name##_s {                                                     \
+    /* Next slot to pop, written only by the consumer */                      \
+    unsigned long head __attribute__((aligned(RING_CACHE_LINE)));             \
+    /* Next slot to push, written only by the producer */                     \
+    unsigned long tail __attribute__((aligned(RING_CACHE_LINE)));             \
+    type slots[1UL << (log2Capacity)]                                         \
+        __attribute__((aligned(RING_CACHE_LINE)));                            \
+} name;                                                                       \
+                                                                              \
+enum { name##_capacity = 1UL << (log2Capacity) };                             \
+                                                                              \
+static inline void name##_init(name* r)                                       \
+{                                                                             \
+    r->head = 0;                                                              \
+    r->tail = 0;                                                              \
+}                                                                             \
+                                                                              \
+static inline unsigned long name##_size(name* r)                              \
+{                                                                             \
+    return __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE)                        \
+        - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);                        \
+}                                                                             \
+                                                                              \
+static inline int name##_is_empty(name* r)                                    \
+{                                                                             \
+    return name##_size(r) == 0;                                               \
+}                                                                             \
+                                                                              \
+static inline int name##_is_full(name* r)                                     \
+{                                                                             \
+    return name##_size(r) == name##_capacity;                                 \
+}                                                                             \
+                                                                              \
+static inline int name##_push(name* r, const type* value)                     \
+{                                                                             \
+    unsigned long tail = r->tail;                                             \
+                                                                              \
+    if (tail - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE)                    \
+            == name##_capacity) {                                             \
+        return RING_FAILURE;                                                  \
+    }                                                                         \
+    r->slots[tail & (name##_capacity - 1)] = *value;                          \
+    __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);                   \
+                                                                              \
+    return RING_SUCCESS;                                                      \
+}                                                                             \
+                                                                              \
+static inline int name##_pop(name* r, type* value)                            \
+{                                                                             \
+    unsigned long head = r->head;                                             \
+                                                                              \
+    if (__atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) == head) {                \
+        return RING_FAILURE;                                                  \
+    }                                                                         \
+    *value = r->slots[head & (name##_capacity - 1)];                          \
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);                   \
+                                                                              \
+    return RING_SUCCESS;                                                      \
+}
+
+#endif
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * FILE: ringTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the typed ring buffer in ring.h.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ring.h"
+
+#define TEST_LOG2       3
+#define TEST_SIZE       (1 << TEST_LOG2)
+#define SPSC_ITEMS      1000000
+
+typedef struct record_s {
+    int id;
+    char name[20];
+} record;
+
+RING_DEFINE(record_ring, record, TEST_LOG2)
+RING_DEFINE(long_ring, long, 6)
+
+static long_ring spsc;
+
+
+/* Push SPSC_ITEMS sequence numbers without a lock */
+static void* producer(void* arg)
+{
+    long i;
+
+    (void) arg;
+
+    for (i = 0; i < SPSC_ITEMS; ++i) {
+        while (long_ring_push(&spsc, &i) == RING_FAILURE) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    record_ring r;
+    record in;
+    record out;
+    pthread_t thread;
+    long expect;
+    long value;
+    int failures = 0;
+    int i;
+
+    record_ring_init(&r);
+
+    /* Test for empty ring when empty */
+    if (!record_ring_is_empty(&r) || record_ring_is_full(&r)) {
+        fprintf(stderr, "error: ring should report empty\n");
+        failures++;
+    }
+
+    /* Test that pop fails when empty */
+    if (record_ring_pop(&r, &out) != RING_FAILURE) {
+        fprintf(stderr, "error: pop did not fail when empty!\n");
+        failures++;
+    }
+
+    /* Push twice around the ring so the mask wraps */
+    for (i = 0; i < 2 * TEST_SIZE; ++i) {
+        in.id = i;
+        snprintf(in.name, sizeof(in.name), "host%d.com", i);
+        if (record_ring_push(&r, &in) == RING_FAILURE) {
+            fprintf(stderr, "error: push failed! Index: %d\n", i);
+            failures++;
+        }
+
+        /* Fill the ring on the first pass only */
+        if (i < TEST_SIZE - 1) {
+            continue;
+        }
+        if (i == TEST_SIZE - 1) {
+            if (!record_ring_is_full(&r) || record_ring_push(&r, &in) != RING_FAILURE) {
+                fprintf(stderr, "error: ring should report full\n");
+                failures++;
+            }
+        }
+
+        /* Values are copied out in FIFO order */
+        if (record_ring_pop(&r, &out) == RING_FAILURE) {
+            fprintf(stderr, "error: pop failed! Index: %d\n", i);
+            failures++;
+        }
+        else {
+            expect = i - (TEST_SIZE - 1);
+            snprintf(in.name, sizeof(in.name), "host%ld.com", expect);
+            if (out.id != expect || strcmp(out.name, in.name)) {
+                fprintf(stderr, "error: push/pop mismatch! Expected: %ld, Got: %d\n",
+                        expect, out.id);
+                failures++;
+            }
+        }
+    }
+    if (record_ring_size(&r) != TEST_SIZE - 1) {
+        fprintf(stderr, "error: ring size is %lu, expected %d\n",
+                record_ring_size(&r), TEST_SIZE - 1);
+        failures++;
+    }
+
+    /* One producer and one consumer may share a ring without a lock */
+    long_ring_init(&spsc);
+    pthread_create(&thread, NULL, producer, NULL);
+    for (expect = 0; expect < SPSC_ITEMS; ++expect) {
+        while (long_ring_pop(&spsc, &value) == RING_FAILURE) {
+            sched_yield();
+        }
+        if (value != expect) {
+            fprintf(stderr, "error: SPSC order mismatch! Expected: %ld, Got: %ld\n",
+                    expect, value);
+            failures++;
+            break;
+        }
+    }
+    pthread_join(thread, NULL);
+
+    if (failures) {
+        fprintf(stderr, "%d ring test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All ring tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,435 @@
+/******************************************************************************
+ * FILE: segq.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the segmented queue.
+ *  Slot claiming follows the fetch-and-add array queue: a pusher that
+ *      claims a slot a popper has already given up on (marked TAKEN) simply
+ *      claims another, so neither side ever waits for the other except for
+ *      a popper whose slot is mid-copy. Only the pool's lists take a lock,
+ *      once per segment rather than once per item.
+ *  Hazard records live on one list shared by every queue; a thread claims
+ *      one on its first push or pop and gives it up when it exits.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "segq.h"
+
+/* Slot states */
+#define SEGQ_EMPTY              0
+#define SEGQ_WRITING            1       // A pusher is copying its item in
+#define SEGQ_READY              2
+#define SEGQ_TAKEN              3       // A popper got here first: skip it
+
+#define SEGQ_ALIGN              64      // Cache line
+
+typedef struct segq_segment_s {
+    long enq __attribute__((aligned(SEGQ_ALIGN)));  // Next slot to push to
+    long deq __attribute__((aligned(SEGQ_ALIGN)));  // Next slot to pop from
+    struct segq_segment_s* next __attribute__((aligned(SEGQ_ALIGN)));
+    struct segq_segment_s* link;        // On the pool's free or retired list
+    unsigned char data[];               // segmentItems states, then items
+} segq_segment;
+
+/* The segment one thread may be reading */
+typedef struct segq_hazard_s {
+    segq_segment* segment;      // NULL if none
+    int active;                 // Claimed by a live thread
+    struct segq_hazard_s* next;
+} segq_hazard;
+
+static segq_hazard* hazards;    // Every record, pushed with CAS, never freed
+static pthread_key_t hazardKey; // Gives a thread's record up when it exits
+static pthread_once_t hazardOnce = PTHREAD_ONCE_INIT;
+static __thread segq_hazard* localHazard;
+
+
+static size_t segq_round(size_t n)
+{
+    return (n + SEGQ_ALIGN - 1) / SEGQ_ALIGN * SEGQ_ALIGN;
+}
+
+
+static unsigned char* segq_slot(const segq_pool* p, segq_segment* seg, long idx)
+{
+    return seg->data + segq_round(p->segmentItems) + idx * p->itemSize;
+}
+
+
+static void segq_release_hazard(void* arg)
+{
+    segq_hazard* h = (segq_hazard*) arg;
+
+    __atomic_store_n(&h->segment, NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&h->active, 0, __ATOMIC_RELEASE);
+}
+
+
+static void segq_make_key(void)
+{
+    pthread_key_create(&hazardKey, segq_release_hazard);
+}
+
+
+/* The calling thread's hazard record, claimed or added on first use */
+static segq_hazard* segq_hazard_get(void)
+{
+    segq_hazard* h;
+    int idle;
+
+    if (localHazard) {
+        return localHazard;
+    }
+    pthread_once(&hazardOnce, segq_make_key);
+
+    /* Reuse a record given up by an exited thread */
+    for (h = __atomic_load_n(&hazards, __ATOMIC_ACQUIRE); h; h = h->next) {
+        idle = 0;
+        if (__atomic_compare_exchange_n(&h->active, &idle, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    if (h == NULL) {
+        if ((h = calloc(1, sizeof(*h))) == NULL) {
+            fprintf(stderr, "MALLOC ERROR: Error allocating queue hazard record\n");
+            abort();
+        }
+        h->active = 1;
+        h->next = __atomic_load_n(&hazards, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&hazards, &h->next, h, 0,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+    pthread_setspecific(hazardKey, h);
+    localHazard = h;
+    return h;
+}
+
+
+/* Read a queue end and publish it as the thread's hazard, rereading until
+ * the end did not move in between, so it cannot have been retired */
+static segq_segment* segq_protect(segq_hazard* h, segq_segment** end)
+{
+    segq_segment* seg;
+
+    do {
+        seg = __atomic_load_n(end, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&h->segment, seg, __ATOMIC_SEQ_CST);
+    } while (seg != __atomic_load_n(end, __ATOMIC_SEQ_CST));
+    return seg;
+}
+
+
+/* Test whether any thread has seg as its hazard */
+static int segq_hazarded(const segq_segment* seg)
+{
+    segq_hazard* h;
+
+    for (h = __atomic_load_n(&hazards, __ATOMIC_ACQUIRE); h; h = h->next) {
+        if (__atomic_load_n(&h->segment, __ATOMIC_SEQ_CST) == seg) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/* Move retired segments no thread is reading to the free list, with the
+ * pool lock held */
+static void segq_reclaim(segq_pool* p)
+{
+    segq_segment** prev = &p->retired;
+    segq_segment* seg;
+    int freed = 0;
+
+    while ((seg = *prev) != NULL) {
+        if (segq_hazarded(seg)) {
+            prev = &seg->link;
+            continue;
+        }
+        *prev = seg->link;
+        seg->link = p->free;
+        p->free = seg;
+        p->inUse--;
+        freed++;
+    }
+    if (freed) {
+        pthread_cond_broadcast(&p->room);
+    }
+}
+
+
+/* Take an empty segment from the pool, allocating one below the ceiling
+ * Returns the segment, or NULL at the ceiling
+ */
+static segq_segment* segq_take(segq_pool* p)
+{
+    segq_segment* seg = NULL;
+    void* mem;
+
+    pthread_mutex_lock(&p->lock);
+    if (p->free == NULL && p->allocated >= p->maxSegments) {
+        segq_reclaim(p);
+    }
+    if ((seg = p->free) != NULL) {
+        p->free = seg->link;
+    }
+    else if (p->allocated < p->maxSegments
+             && posix_memalign(&mem, SEGQ_ALIGN, p->segmentBytes) == 0) {
+        seg = (segq_segment*) mem;
+        p->allocated++;
+    }
+    if (seg) {
+        if (++p->inUse > p->peakInUse) {
+            p->peakInUse = p->inUse;
+        }
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    if (seg) {
+        seg->enq = 0;
+        seg->deq = 0;
+        seg->next = NULL;
+        seg->link = NULL;
+        memset(seg->data, SEGQ_EMPTY, p->segmentItems);
+    }
+    return seg;
+}
+
+
+/* Return a segment no other thread has seen */
+static void segq_give(segq_pool* p, segq_segment* seg)
+{
+    pthread_mutex_lock(&p->lock);
+    seg->link = p->free;
+    p->free = seg;
+    p->inUse--;
+    pthread_cond_broadcast(&p->room);
+    pthread_mutex_unlock(&p->lock);
+}
+
+
+/* Retire an unlinked segment, freeing it now if nobody is reading it */
+static void segq_retire(segq_pool* p, segq_segment* seg)
+{
+    pthread_mutex_lock(&p->lock);
+    seg->link = p->retired;
+    p->retired = seg;
+    segq_reclaim(p);
+    pthread_mutex_unlock(&p->lock);
+}
+
+
+int segq_pool_init(segq_pool* p, size_t itemSize, int segmentItems, size_t maxBytes)
+{
+    memset(p, 0, sizeof(*p));
+    p->itemSize = itemSize;
+    p->segmentItems = segmentItems;
+    p->segmentBytes = segq_round(sizeof(segq_segment) + segq_round(segmentItems)
+                                 + segmentItems * itemSize);
+    if (itemSize == 0 || segmentItems < 1 || maxBytes / p->segmentBytes < 2) {
+        errno = EINVAL;
+        return SEGQ_FAILURE;
+    }
+    p->maxSegments = maxBytes / p->segmentBytes > 0x7fffffff
+        ? 0x7fffffff : (int) (maxBytes / p->segmentBytes);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->room, NULL);
+    return SEGQ_SUCCESS;
+}
+
+
+void segq_pool_destroy(segq_pool* p)
+{
+    segq_segment* seg;
+
+    while ((seg = p->free) != NULL) {
+        p->free = seg->link;
+        free(seg);
+    }
+    while ((seg = p->retired) != NULL) {
+        p->retired = seg->link;
+        free(seg);
+    }
+    pthread_cond_destroy(&p->room);
+    pthread_mutex_destroy(&p->lock);
+}
+
+
+int segq_init(segq* q, segq_pool* p)
+{
+    q->pool = p;
+    q->size = 0;
+    if ((q->head = q->tail = segq_take(p)) == NULL) {
+        errno = ENOMEM;
+        return SEGQ_FAILURE;
+    }
+    return SEGQ_SUCCESS;
+}
+
+
+void segq_destroy(segq* q)
+{
+    segq_segment* seg;
+
+    while ((seg = q->head) != NULL) {
+        q->head = seg->next;
+        segq_give(q->pool, seg);
+    }
+    q->tail = NULL;
+
+    /* Nobody is reading any more, so nothing retired is still hazarded */
+    pthread_mutex_lock(&q->pool->lock);
+    segq_reclaim(q->pool);
+    pthread_mutex_unlock(&q->pool->lock);
+}
+
+
+int segq_push(segq* q, const void* item)
+{
+    segq_pool* p = q->pool;
+    segq_hazard* h = segq_hazard_get();
+    segq_segment* seg;
+    segq_segment* next;
+    segq_segment* fresh;
+    unsigned char empty;
+    long idx;
+
+    for (;;) {
+        seg = segq_protect(h, &q->tail);
+        if ((idx = __atomic_fetch_add(&seg->enq, 1, __ATOMIC_ACQ_REL)) < p->segmentItems) {
+            empty = SEGQ_EMPTY;
+            if (__atomic_compare_exchange_n(&seg->data[idx], &empty, SEGQ_WRITING, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                memcpy(segq_slot(p, seg, idx), item, p->itemSize);
+                __atomic_store_n(&seg->data[idx], SEGQ_READY, __ATOMIC_RELEASE);
+                break;
+            }
+            continue;
+        }
+
+        /* The tail is full: help move it on, or link a new segment with
+         * the item already in its first slot */
+        if (seg != __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        if ((next = __atomic_load_n(&seg->next, __ATOMIC_ACQUIRE)) != NULL) {
+            __atomic_compare_exchange_n(&q->tail, &seg, next, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            continue;
+        }
+        if ((fresh = segq_take(p)) == NULL) {
+            __atomic_store_n(&h->segment, NULL, __ATOMIC_RELEASE);
+            return SEGQ_FAILURE;
+        }
+        memcpy(segq_slot(p, fresh, 0), item, p->itemSize);
+        fresh->data[0] = SEGQ_READY;
+        fresh->enq = 1;
+        next = NULL;
+        if (__atomic_compare_exchange_n(&seg->next, &next, fresh, 0,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            __atomic_compare_exchange_n(&q->tail, &seg, fresh, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            break;
+        }
+        segq_give(p, fresh);
+    }
+
+    __atomic_store_n(&h->segment, NULL, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&q->size, 1, __ATOMIC_RELAXED);
+    return SEGQ_SUCCESS;
+}
+
+
+int segq_pop(segq* q, void* item)
+{
+    segq_pool* p = q->pool;
+    segq_hazard* h = segq_hazard_get();
+    segq_segment* seg;
+    segq_segment* next;
+    segq_segment* expect;
+    unsigned char* state;
+    unsigned char empty;
+    long idx;
+
+    for (;;) {
+        seg = segq_protect(h, &q->head);
+        if (__atomic_load_n(&seg->deq, __ATOMIC_ACQUIRE)
+                >= __atomic_load_n(&seg->enq, __ATOMIC_ACQUIRE)
+                && __atomic_load_n(&seg->next, __ATOMIC_ACQUIRE) == NULL) {
+            break;
+        }
+        if ((idx = __atomic_fetch_add(&seg->deq, 1, __ATOMIC_ACQ_REL)) < p->segmentItems) {
+            /* Give up a slot its pusher has not claimed yet; it will take
+             * another */
+            state = &seg->data[idx];
+            empty = SEGQ_EMPTY;
+            if (__atomic_compare_exchange_n(state, &empty, SEGQ_TAKEN, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            while (__atomic_load_n(state, __ATOMIC_ACQUIRE) == SEGQ_WRITING) {
+                sched_yield();
+            }
+            memcpy(item, segq_slot(p, seg, idx), p->itemSize);
+            __atomic_store_n(&h->segment, NULL, __ATOMIC_RELEASE);
+            __atomic_sub_fetch(&q->size, 1, __ATOMIC_RELAXED);
+            return SEGQ_SUCCESS;
+        }
+
+        /* The head is drained: unlink it, moving the tail off it first so
+         * no end of the queue still points at it when it is retired */
+        if ((next = __atomic_load_n(&seg->next, __ATOMIC_ACQUIRE)) == NULL) {
+            break;
+        }
+        expect = seg;
+        __atomic_compare_exchange_n(&q->tail, &expect, next, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+        expect = seg;
+        if (__atomic_compare_exchange_n(&q->head, &expect, next, 0,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&h->segment, NULL, __ATOMIC_SEQ_CST);
+            segq_retire(p, seg);
+        }
+    }
+
+    __atomic_store_n(&h->segment, NULL, __ATOMIC_RELEASE);
+    return SEGQ_FAILURE;
+}
+
+
+void segq_wait(segq_pool* p)
+{
+    struct timespec until;
+
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_nsec += SEGQ_WAIT_NS;
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    segq_reclaim(p);
+    if (p->free == NULL && p->allocated >= p->maxSegments) {
+        pthread_cond_timedwait(&p->room, &p->lock, &until);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+
+long segq_size(const segq* q)
+{
+    return __atomic_load_n(&q->size, __ATOMIC_RELAXED);
+}
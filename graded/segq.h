@@ -0,0 +1,106 @@
+/******************************************************************************
+ * FILE: segq.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for a segmented queue of fixed-size
+ *      items that grows on demand up to a memory ceiling.
+ *  A queue is a linked list of array segments. Pushing and popping take no
+ *      lock: a thread claims a slot of the tail or head segment with a
+ *      fetch-and-add and copies its item in or out; a per-slot state byte
+ *      tells a popper whether the item is there yet. A push that finds the
+ *      tail segment full links a new one; a pop that drains the head
+ *      segment unlinks it.
+ *  Segments come from a pool, which may be shared by several queues and
+ *      holds at most maxSegments of them, so a full pool is the ceiling:
+ *      segq_push() fails until segments come back. Each thread publishes
+ *      the segment it is working in as a hazard pointer, and an unlinked
+ *      segment goes back to the pool's free list only once no thread has
+ *      it as its hazard, so a segment is never reused under a reader.
+ *
+ ******************************************************************************/
+
+#ifndef SEGQ_H
+#define SEGQ_H
+
+/* Standard Includes */
+#include <pthread.h>
+#include <stddef.h>
+
+
+#define SEGQ_FAILURE            -1
+#define SEGQ_SUCCESS            0
+
+#define SEGQ_SEGMENT_ITEMS      256     // Default items per segment
+#define SEGQ_WAIT_NS            1000000 // Longest segq_wait() sleep
+
+
+struct segq_segment_s;
+
+/* Segments shared by queues of one item size, up to a ceiling */
+typedef struct segq_pool_s {
+    size_t itemSize;
+    int segmentItems;           // Slots per segment
+    size_t segmentBytes;        // Allocation size of a segment
+    int maxSegments;            // Segments the pool may allocate
+    pthread_mutex_t lock;       // Held for the lists and counts below
+    pthread_cond_t room;        // Signaled when segments are freed
+    struct segq_segment_s* free;        // Ready for reuse
+    struct segq_segment_s* retired;     // Unlinked, maybe still hazarded
+    int allocated;              // Segments allocated, in any state
+    int inUse;                  // Segments linked into a queue or retired
+    int peakInUse;
+} segq_pool;
+
+typedef struct segq_s {
+    segq_pool* pool;
+    struct segq_segment_s* head;        // Segment being popped from
+    struct segq_segment_s* tail;        // Segment being pushed to
+    long size;                  // Items pushed and not yet popped
+} segq;
+
+
+/* Function to set up a pool of segments holding segmentItems items of
+ * itemSize bytes each, allocating at most maxBytes of segments
+ * Returns SEGQ_SUCCESS, or SEGQ_FAILURE (errno set) if maxBytes is too
+ * small for two segments
+ */
+int segq_pool_init(segq_pool* p, size_t itemSize, int segmentItems, size_t maxBytes);
+
+/* Function to free a pool once every queue using it is destroyed */
+void segq_pool_destroy(segq_pool* p);
+
+/* Function to set up an empty queue, taking its first segment from p
+ * Returns SEGQ_SUCCESS or SEGQ_FAILURE (errno set)
+ */
+int segq_init(segq* q, segq_pool* p);
+
+/* Function to give every segment of a queue back to its pool; no thread
+ * may be using the queue */
+void segq_destroy(segq* q);
+
+/* Function to copy an item to the end of the queue; safe to call from many
+ * threads at once
+ * Returns SEGQ_SUCCESS, or SEGQ_FAILURE if a new segment was needed and
+ * the pool is at its ceiling
+ */
+int segq_push(segq* q, const void* item);
+
+/* Function to copy out the item at the front of the queue; safe to call
+ * from many threads at once
+ * Returns SEGQ_SUCCESS, or SEGQ_FAILURE if the queue is empty
+ */
+int segq_pop(segq* q, void* item);
+
+/* Function to wait after a failed push until a segment may be free, at
+ * most SEGQ_WAIT_NS */
+void segq_wait(segq_pool* p);
+
+/* Function to read how many items are queued, possibly stale
+ * Returns the count
+ */
+long segq_size(const segq* q);
+
+#endif
@@ -0,0 +1,206 @@
+/******************************************************************************
+ * FILE: segqTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the segmented queue in segq.h.
+ *
+ ******************************************************************************/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "segq.h"
+
+#define TEST_PRODUCERS  4
+#define TEST_CONSUMERS  4
+#define TEST_ITEMS      200000  // Per producer
+#define TEST_SEGMENT    16      // Items per segment, so segments turn over
+#define TEST_SEGMENTS   8       // Pool ceiling, so producers hit it
+
+typedef struct test_item_s {
+    int producer;
+    int seq;                    // Per producer, counting up
+    char pad[40];               // Make copies span more than a word
+} test_item;
+
+static segq_pool pool;
+static segq queue;
+static int producersDone = 0;
+static int stalls = 0;          // Pushes that found the pool at its ceiling
+
+typedef struct consumer_s {
+    long count;
+    long long sum;
+    int last[TEST_PRODUCERS];   // Last seq seen from each producer
+    int disorder;               // Items seen out of their producer's order
+} consumer;
+
+
+static void* producer(void* arg)
+{
+    test_item item;
+    int id = (int) (long) arg;
+    int i;
+
+    memset(&item, 0, sizeof(item));
+    item.producer = id;
+    for (i = 0; i < TEST_ITEMS; ++i) {
+        item.seq = i;
+        memset(item.pad, i & 0xff, sizeof(item.pad));
+        while (segq_push(&queue, &item) == SEGQ_FAILURE) {
+            __atomic_add_fetch(&stalls, 1, __ATOMIC_RELAXED);
+            segq_wait(&pool);
+        }
+    }
+    return NULL;
+}
+
+
+static void* consumer_main(void* arg)
+{
+    consumer* c = (consumer*) arg;
+    test_item item;
+    int done;
+    int i;
+
+    for (i = 0; i < TEST_PRODUCERS; ++i) {
+        c->last[i] = -1;
+    }
+    for (;;) {
+        done = __atomic_load_n(&producersDone, __ATOMIC_ACQUIRE);
+        if (segq_pop(&queue, &item) == SEGQ_FAILURE) {
+            if (done) {
+                break;
+            }
+            continue;
+        }
+        /* One consumer sees each producer's items in the order pushed */
+        if (item.seq <= c->last[item.producer]
+                || (unsigned char) item.pad[39] != (item.seq & 0xff)) {
+            c->disorder++;
+        }
+        c->last[item.producer] = item.seq;
+        c->count++;
+        c->sum += item.seq;
+    }
+    return NULL;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    pthread_t producers[TEST_PRODUCERS];
+    pthread_t consumers[TEST_CONSUMERS];
+    consumer c[TEST_CONSUMERS];
+    long long expectSum = (long long) TEST_PRODUCERS * TEST_ITEMS * (TEST_ITEMS - 1) / 2;
+    long long sum = 0;
+    long count = 0;
+    int disorder = 0;
+    test_item item;
+    size_t bytes;
+    int failures = 0;
+    long i;
+
+    /* A pool must fit two segments */
+    if (segq_pool_init(&pool, sizeof(test_item), TEST_SEGMENT, 100) != SEGQ_FAILURE) {
+        fprintf(stderr, "error: a pool too small for two segments was made\n");
+        failures++;
+    }
+
+    /* Size the ceiling to a whole number of segments */
+    if (segq_pool_init(&pool, sizeof(test_item), TEST_SEGMENT, 1 << 20) == SEGQ_FAILURE) {
+        perror("error: segq_pool_init failed");
+        return EXIT_FAILURE;
+    }
+    bytes = TEST_SEGMENTS * pool.segmentBytes + pool.segmentBytes / 2;
+    segq_pool_destroy(&pool);
+
+    if (segq_pool_init(&pool, sizeof(test_item), TEST_SEGMENT, bytes) == SEGQ_FAILURE
+            || segq_init(&queue, &pool) == SEGQ_FAILURE) {
+        perror("error: segq_init failed");
+        return EXIT_FAILURE;
+    }
+    if (pool.maxSegments != TEST_SEGMENTS) {
+        fprintf(stderr, "error: %d segments fit, expected %d (segments are %zu bytes)\n",
+                pool.maxSegments, TEST_SEGMENTS, pool.segmentBytes);
+        failures++;
+    }
+
+    /* An empty queue pops nothing; a few items come back in order */
+    if (segq_pop(&queue, &item) != SEGQ_FAILURE) {
+        fprintf(stderr, "error: popped from an empty queue\n");
+        failures++;
+    }
+    for (i = 0; i < 3 * TEST_SEGMENT; ++i) {
+        item.seq = i;
+        segq_push(&queue, &item);
+    }
+    for (i = 0; i < 3 * TEST_SEGMENT; ++i) {
+        if (segq_pop(&queue, &item) == SEGQ_FAILURE || item.seq != i) {
+            fprintf(stderr, "error: item %ld came back wrong\n", i);
+            failures++;
+            break;
+        }
+    }
+    if (segq_size(&queue) != 0 || segq_pop(&queue, &item) != SEGQ_FAILURE) {
+        fprintf(stderr, "error: queue not empty after popping every item\n");
+        failures++;
+    }
+
+    /* Many producers against many consumers, past the ceiling many times */
+    memset(c, 0, sizeof(c));
+    for (i = 0; i < TEST_CONSUMERS; ++i) {
+        pthread_create(&consumers[i], NULL, consumer_main, &c[i]);
+    }
+    for (i = 0; i < TEST_PRODUCERS; ++i) {
+        pthread_create(&producers[i], NULL, producer, (void*) i);
+    }
+    for (i = 0; i < TEST_PRODUCERS; ++i) {
+        pthread_join(producers[i], NULL);
+    }
+    __atomic_store_n(&producersDone, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < TEST_CONSUMERS; ++i) {
+        pthread_join(consumers[i], NULL);
+        count += c[i].count;
+        sum += c[i].sum;
+        disorder += c[i].disorder;
+    }
+    printf("%d pushes waited at the ceiling, peak %d of %d segments\n",
+           stalls, pool.peakInUse, pool.maxSegments);
+
+    if (count != (long) TEST_PRODUCERS * TEST_ITEMS || sum != expectSum || disorder) {
+        fprintf(stderr, "error: %ld items of %ld, %d out of order\n",
+                count, (long) TEST_PRODUCERS * TEST_ITEMS, disorder);
+        failures++;
+    }
+    if (pool.peakInUse > pool.maxSegments || pool.allocated > pool.maxSegments) {
+        fprintf(stderr, "error: %d segments in use past the ceiling\n", pool.peakInUse);
+        failures++;
+    }
+
+    /* Every segment comes back to the pool */
+    segq_destroy(&queue);
+    if (pool.inUse != 0) {
+        fprintf(stderr, "error: %d segments not returned\n", pool.inUse);
+        failures++;
+    }
+    segq_pool_destroy(&pool);
+
+    if (failures) {
+        fprintf(stderr, "%d segmented queue test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All segmented queue tests passed\n");
+
+    return EXIT_SUCCESS;
+}
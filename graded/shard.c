@@ -0,0 +1,380 @@
+/******************************************************************************
+ * FILE: shard.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the multi-process sharded mode: a coordinator
+ *      process and forked resolver workers sharing rings in a memfd segment.
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "multi-lookup.h"
+#include "probes.h"
+#include "shard.h"
+
+/* Uncomment the following line to enable debugging output */
+//#define SHARD_DEBUG
+
+/* A crashing name is retried this many times before it is given up on */
+#define SHARD_MAX_CRASHES       3
+
+/* Coordinator-private copy of every name a worker has not answered yet */
+RING_DEFINE(shard_pending, shard_work, SHARD_RING_LOG2)
+
+typedef struct shard_worker_s {
+    pid_t pid;                  // 0 once the worker has exited cleanly
+    shard_channel* channel;
+    shard_pending pending;
+    unsigned long crashSeq;     // Oldest pending name at the last crash
+    int crashes;                // Consecutive crashes with that name
+    int failed;                 // Could not be restarted; its names go elsewhere
+} shard_worker;
+
+
+/* Worker process body: resolve names until the coordinator is done */
+static void shard_worker_main(shard_channel* channel)
+{
+    shard_work work;
+    shard_result result;
+    int rc;
+
+    /* Do not outlive the coordinator */
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    for (;;) {
+        if (shard_work_ring_pop(&channel->work, &work) == RING_FAILURE) {
+            if (__atomic_load_n(&channel->done, __ATOMIC_ACQUIRE)
+                    && shard_work_ring_is_empty(&channel->work)) {
+                break;
+            }
+            usleep(SHARD_IDLE_USEC);
+            continue;
+        }
+
+        result.seq = work.seq;
+        strncpy(result.hostname, work.hostname, sizeof(result.hostname));
+        PROBE1(dnslookup_entry, work.hostname);
+        rc = dnslookup(work.hostname, result.ip, sizeof(result.ip));
+        PROBE2(dnslookup_exit, work.hostname, rc);
+        if (rc == UTIL_FAILURE) {
+            fprintf(stderr, "DNSLOOKUP ERROR: %s\n", work.hostname);
+            strncpy(result.ip, "", sizeof(result.ip));
+        }
+
+        /* Never full: the coordinator keeps at most one ring of names
+         * outstanding per worker */
+        while (shard_result_ring_push(&channel->results, &result) == RING_FAILURE) {
+            usleep(SHARD_IDLE_USEC);
+        }
+    }
+
+    /* Skip atexit handlers and stdio buffers inherited from the coordinator */
+    _exit(EXIT_SUCCESS);
+}
+
+
+/* Fork a worker process for one channel */
+static int shard_spawn(shard_worker* w, FILE* outputfd)
+{
+    /* Flush first so the child does not inherit buffered output */
+    fflush(outputfd);
+    fflush(stderr);
+
+    w->pid = fork();
+    if (w->pid < 0) {
+        fprintf(stderr, "FORK ERROR: Error forking shard worker: %s\n",
+                strerror(errno));
+        w->pid = 0;
+        return SHARD_FAILURE;
+    }
+    if (w->pid == 0) {
+        shard_worker_main(w->channel);
+    }
+
+#ifdef SHARD_DEBUG
+    printf("SPAWNED SHARD WORKER %d\n", (int) w->pid);
+#endif
+
+    return SHARD_SUCCESS;
+}
+
+
+/* Write every result a worker has posted; returns the number written */
+static int shard_drain(shard_worker* w, FILE* outputfd)
+{
+    shard_result result;
+    shard_work sent;
+    int n = 0;
+
+    while (shard_result_ring_pop(&w->channel->results, &result) == RING_SUCCESS) {
+        if (shard_pending_pop(&w->pending, &sent) == RING_FAILURE
+                || sent.seq != result.seq) {
+            fprintf(stderr, "SHARD ERROR: Unexpected result for [%s]\n",
+                    result.hostname);
+        }
+        fprintf(outputfd, "%s,%s\n", result.hostname, result.ip);
+        PROBE2(output_write, result.hostname, result.ip);
+        n++;
+    }
+    return n;
+}
+
+
+/* Restart a crashed worker with every name it had not answered */
+static int shard_restart(shard_worker* w, int status, FILE* outputfd)
+{
+    shard_pending retry;
+    shard_work work;
+
+    if (WIFSIGNALED(status)) {
+        fprintf(stderr, "SHARD ERROR: Worker %d killed by signal %d, restarting\n",
+                (int) w->pid, WTERMSIG(status));
+    }
+    else {
+        fprintf(stderr, "SHARD ERROR: Worker %d exited with status %d, restarting\n",
+                (int) w->pid, WEXITSTATUS(status));
+    }
+
+    /* Results the worker posted before dying are complete */
+    shard_drain(w, outputfd);
+
+    /* A name that keeps killing workers is written unresolved */
+    if (shard_pending_pop(&w->pending, &work) == RING_SUCCESS) {
+        if (w->crashes && w->crashSeq == work.seq) {
+            w->crashes++;
+        }
+        else {
+            w->crashSeq = work.seq;
+            w->crashes = 1;
+        }
+
+        shard_pending_init(&retry);
+        if (w->crashes >= SHARD_MAX_CRASHES) {
+            fprintf(stderr, "SHARD ERROR: Giving up on [%s]\n", work.hostname);
+            fprintf(outputfd, "%s,\n", work.hostname);
+            w->crashes = 0;
+        }
+        else {
+            shard_pending_push(&retry, &work);
+        }
+        while (shard_pending_pop(&w->pending, &work) == RING_SUCCESS) {
+            shard_pending_push(&retry, &work);
+        }
+        w->pending = retry;
+    }
+
+    /* The dead worker no longer touches its rings; resend the shard */
+    shard_work_ring_init(&w->channel->work);
+    shard_result_ring_init(&w->channel->results);
+    shard_pending_init(&retry);
+    while (shard_pending_pop(&w->pending, &work) == RING_SUCCESS) {
+        shard_work_ring_push(&w->channel->work, &work);
+        shard_pending_push(&retry, &work);
+    }
+    w->pending = retry;
+
+    /* Without a worker its names would never be answered; write them
+     * unresolved and send later names to the other workers */
+    if (shard_spawn(w, outputfd) == SHARD_FAILURE) {
+        fprintf(stderr, "SHARD ERROR: Worker could not be restarted, writing its "
+                "unanswered names unresolved\n");
+        while (shard_pending_pop(&w->pending, &work) == RING_SUCCESS) {
+            fprintf(outputfd, "%s,\n", work.hostname);
+        }
+        w->failed = 1;
+        return SHARD_FAILURE;
+    }
+    return SHARD_SUCCESS;
+}
+
+
+/* Drain results and reap workers; returns the number of results written */
+static int shard_service(shard_worker* workers, int numWorkers, FILE* outputfd)
+{
+    int i;
+    int n = 0;
+    int status;
+
+    for (i = 0; i < numWorkers; ++i) {
+        n += shard_drain(&workers[i], outputfd);
+
+        if (!workers[i].pid
+                || waitpid(workers[i].pid, &status, WNOHANG) != workers[i].pid) {
+            continue;
+        }
+
+        /* A clean exit only counts once the worker's shard is finished */
+        if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS
+                && __atomic_load_n(&workers[i].channel->done, __ATOMIC_ACQUIRE)) {
+            n += shard_drain(&workers[i], outputfd);
+            if (shard_pending_is_empty(&workers[i].pending)) {
+                workers[i].pid = 0;
+                continue;
+            }
+        }
+        shard_restart(&workers[i], status, outputfd);
+    }
+    return n;
+}
+
+
+/* Pick a name's worker by hash, passing over workers that could not be
+ * restarted
+ * Returns the worker, or NULL if none is left
+ */
+static shard_worker* shard_route(shard_worker* workers, int numWorkers, const char* hostname)
+{
+    int first = fnv1a_hash(hostname) % numWorkers;
+    int i;
+
+    for (i = 0; i < numWorkers; ++i) {
+        if (!workers[(first + i) % numWorkers].failed) {
+            return &workers[(first + i) % numWorkers];
+        }
+    }
+    return NULL;
+}
+
+
+int shard_run(char* const* inputPaths, int numInputs,
+              FILE* outputfd, int numWorkers, int idn)
+{
+    int i;
+    int fd;
+    int running;
+    int rc = SHARD_SUCCESS;
+    size_t segSize;
+    shard_channel* channels;
+    shard_worker* workers;
+    shard_worker* w;
+    shard_work work;
+    cfile input;
+    char raw[MAX_NAME_LENGTH];
+    int code;
+    unsigned long seq = 0;
+
+    if (numWorkers < 1 || numWorkers > SHARD_MAX_WORKERS) {
+        fprintf(stderr, "SHARD ERROR: Worker count must be 1 to %d\n",
+                SHARD_MAX_WORKERS);
+        return SHARD_FAILURE;
+    }
+
+    /* Map one channel per worker in a shared memory segment */
+    segSize = sizeof(shard_channel) * numWorkers;
+    fd = memfd_create("multi-lookup-shards", MFD_CLOEXEC);
+    if (fd < 0 || ftruncate(fd, segSize)) {
+        fprintf(stderr, "SHM ERROR: Error creating shared segment: %s\n",
+                strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return SHARD_FAILURE;
+    }
+    channels = mmap(NULL, segSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (channels == MAP_FAILED) {
+        fprintf(stderr, "SHM ERROR: Error mapping shared segment: %s\n",
+                strerror(errno));
+        return SHARD_FAILURE;
+    }
+
+    if ((workers = malloc(sizeof(*workers) * numWorkers)) == NULL) {
+        fprintf(stderr, "MALLOC ERROR: Error allocating shard workers: %s\n",
+                strerror(errno));
+        munmap(channels, segSize);
+        return SHARD_FAILURE;
+    }
+
+    /* Spawn Workers */
+    for (i = 0; i < numWorkers; ++i) {
+        workers[i].pid = 0;
+        workers[i].channel = &channels[i];
+        workers[i].crashes = 0;
+        workers[i].failed = 0;
+        shard_pending_init(&workers[i].pending);
+        shard_work_ring_init(&channels[i].work);
+        shard_result_ring_init(&channels[i].results);
+        channels[i].done = 0;
+    }
+    for (i = 0; i < numWorkers; ++i) {
+        if (shard_spawn(&workers[i], outputfd) == SHARD_FAILURE) {
+            rc = SHARD_FAILURE;
+            numWorkers = i;
+            break;
+        }
+    }
+
+    /* Read Every Input File, Sharding Names by Hash */
+    for (i = 0; rc == SHARD_SUCCESS && i < numInputs; ++i) {
+        if (cfile_open_read(&input, inputPaths[i]) == CFILE_FAILURE) {
+            fprintf(stderr, "FILE ERROR: Error opening input file [%s]: %s\n",
+                    inputPaths[i], strerror(errno));
+            continue;
+        }
+
+        while ((code = normalize_read(input.fp, raw)) != EOF) {
+            /* Malformed names are answered by the coordinator */
+            if (code != NAME_OK
+                    || (code = normalize_name(raw, work.hostname, idn)) != NAME_OK) {
+                fprintf(outputfd, "%s,%s\n", raw, normalize_strerror(code));
+                continue;
+            }
+
+            /* Wait for the worker to answer before exceeding a ring of work,
+             * routing again as it may fail to restart while we wait */
+            work.seq = seq++;
+            while ((w = shard_route(workers, numWorkers, work.hostname)) != NULL
+                    && shard_pending_is_full(&w->pending)) {
+                if (!shard_service(workers, numWorkers, outputfd)) {
+                    usleep(SHARD_IDLE_USEC);
+                }
+            }
+            if (w == NULL) {
+                fprintf(outputfd, "%s,\n", work.hostname);
+                continue;
+            }
+            shard_pending_push(&w->pending, &work);
+            shard_work_ring_push(&w->channel->work, &work);
+        }
+
+        if (cfile_close(&input)) {
+            fprintf(stderr, "FILE ERROR: Error reading input file [%s]\n",
+                    inputPaths[i]);
+        }
+    }
+
+    /* Tell workers no more work is coming, then collect what is left */
+    for (i = 0; i < numWorkers; ++i) {
+        __atomic_store_n(&channels[i].done, 1, __ATOMIC_RELEASE);
+    }
+    do {
+        if (!shard_service(workers, numWorkers, outputfd)) {
+            usleep(SHARD_IDLE_USEC);
+        }
+        for (i = 0, running = 0; i < numWorkers; ++i) {
+            running += workers[i].pid != 0;
+        }
+    } while (running);
+
+    /* Names a lost worker never answered were written unresolved */
+    for (i = 0; i < numWorkers; ++i) {
+        if (workers[i].failed) {
+            rc = SHARD_FAILURE;
+        }
+    }
+
+    free(workers);
+    munmap(channels, segSize);
+
+    return rc;
+}
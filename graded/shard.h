@@ -0,0 +1,75 @@
+/******************************************************************************
+ * FILE: shard.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for the multi-process sharded mode.
+ *  A coordinator process reads every input file, shards hostnames by hash
+ *      across forked worker processes and merges their results into the
+ *      single output file.
+ *  Work and results travel through lock-free single-producer/single-consumer
+ *      rings in a shared memory segment, one pair per worker.
+ *  The coordinator keeps a copy of every name a worker has not answered yet,
+ *      so a worker that crashes is restarted with its unfinished shard. If
+ *      it cannot be restarted, those names are written unresolved and its
+ *      later names go to the next worker.
+ *
+ ******************************************************************************/
+
+#ifndef SHARD_H
+#define SHARD_H
+
+/* Standard Includes */
+#include <stdio.h>
+
+/* Local Includes */
+#include "dispatch.h"
+#include "ring.h"
+#include "util.h"
+
+
+#define SHARD_FAILURE           -1
+#define SHARD_SUCCESS           0
+
+#define SHARD_RING_LOG2         8       // Names in flight per worker
+#define SHARD_MAX_WORKERS       256
+#define SHARD_IDLE_USEC         100     // Poll interval when nothing moved
+
+
+/* A hostname sent from the coordinator to a worker */
+typedef struct shard_work_s {
+    unsigned long seq;
+    char hostname[MAX_NAME_LENGTH];
+} shard_work;
+
+/* A resolved hostname sent back from a worker */
+typedef struct shard_result_s {
+    unsigned long seq;
+    char hostname[MAX_NAME_LENGTH];
+    char ip[INET6_ADDRSTRLEN];
+} shard_result;
+
+RING_DEFINE(shard_work_ring, shard_work, SHARD_RING_LOG2)
+RING_DEFINE(shard_result_ring, shard_result, SHARD_RING_LOG2)
+
+/* The shared memory owned by one worker */
+typedef struct shard_channel_s {
+    shard_work_ring work;
+    shard_result_ring results;
+    int done;                   // Set once the coordinator has no more input
+} shard_channel;
+
+
+/* Function to resolve every name in the input files with numWorkers
+ * worker processes, writing "hostname,ip" lines to outputfd
+ * Names are normalized first (see normalize.h); idn enables punycode
+ * Returns SHARD_SUCCESS, or SHARD_FAILURE if the shared segment or a
+ * worker could not be set up, or a crashed worker could not be restarted
+ * (its unanswered names are written unresolved)
+ */
+int shard_run(char* const* inputPaths, int numInputs,
+              FILE* outputfd, int numWorkers, int idn);
+
+#endif
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * FILE: shardTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the sharded mode in shard.h, killing
+ *      workers part way through a run.
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "shard.h"
+
+#define TEST_NAMES      100000  // Numeric names, resolved without a query
+#define TEST_PATH       "/tmp/shardTest.txt"
+#define TEST_KILL_USEC  20000   // Time the workers run before one is killed
+
+static int forks;               // Workers forked so far
+static int failForks;           // Set to make every later fork fail
+static int killed;              // Set once a worker was killed
+static unsigned char seen[TEST_NAMES];  // Times each name was written
+
+
+/* Fork as usual, or fail as when out of processes once failForks is set */
+pid_t fork(void)
+{
+    static pid_t (*realFork)(void);
+    pid_t pid;
+
+    if (__atomic_load_n(&failForks, __ATOMIC_ACQUIRE)) {
+        errno = EAGAIN;
+        return -1;
+    }
+    if (!realFork) {
+        realFork = (pid_t (*)(void)) dlsym(RTLD_NEXT, "fork");
+    }
+    if ((pid = realFork()) > 0) {
+        __atomic_fetch_add(&forks, 1, __ATOMIC_RELEASE);
+    }
+    return pid;
+}
+
+
+/* Wait for every worker to start, let them run, then kill the first one;
+ * arg says whether it may be restarted */
+static void* killer(void* arg)
+{
+    int workers = ((int*) arg)[0];
+    char path[64];
+    FILE* fp;
+    int pid = 0;
+
+    while (__atomic_load_n(&forks, __ATOMIC_ACQUIRE) < workers) {
+        usleep(1000);
+    }
+    usleep(TEST_KILL_USEC);
+
+    /* The coordinator is our main thread, which forked the workers */
+    snprintf(path, sizeof(path), "/proc/self/task/%d/children", (int) getpid());
+    if ((fp = fopen(path, "r")) == NULL || fscanf(fp, "%d", &pid) != 1) {
+        perror("error: reading the worker pids failed");
+    }
+    if (fp) {
+        fclose(fp);
+    }
+
+    __atomic_store_n(&failForks, !((int*) arg)[1], __ATOMIC_RELEASE);
+    killed = pid > 0 && kill(pid, SIGKILL) == 0;
+    return NULL;
+}
+
+
+/* Run the shard over the test names with one worker killed part way
+ * Returns 1 on a failure
+ */
+static int run(int workers, int restart)
+{
+    char* const paths[] = {TEST_PATH};
+    int arg[2] = {workers, restart};
+    pthread_t thread;
+    char line[64];
+    FILE* output;
+    int a, b, c;
+    int restarts;
+    int wrong;
+    int rc;
+    int i;
+
+    if ((output = tmpfile()) == NULL) {
+        perror("error: tmpfile failed");
+        return 1;
+    }
+    memset(seen, 0, sizeof(seen));
+    forks = 0;
+    failForks = 0;
+    killed = 0;
+    if (pthread_create(&thread, NULL, killer, arg)) {
+        perror("error: pthread_create failed");
+        return 1;
+    }
+    rc = shard_run(paths, 1, output, workers, 0);
+    pthread_join(thread, NULL);
+    restarts = forks - workers;
+
+    /* Every name is written once, resolved or not */
+    rewind(output);
+    while (fgets(line, sizeof(line), output)) {
+        if (sscanf(line, "10.%d.%d.%d,", &a, &b, &c) == 3
+                && (i = (a << 16) | (b << 8) | c) < TEST_NAMES && seen[i] < 255) {
+            seen[i]++;
+        }
+    }
+    fclose(output);
+    for (i = 0, wrong = 0; i < TEST_NAMES; ++i) {
+        wrong += seen[i] != 1;
+    }
+
+    if (!killed) {
+        fprintf(stderr, "error: %d worker(s) finished before one was killed\n", workers);
+        return 1;
+    }
+    if (wrong) {
+        fprintf(stderr, "error: %d of %d names not written exactly once with %d "
+                "worker(s)%s\n", wrong, TEST_NAMES, workers, restart ? "" : " failing");
+        return 1;
+    }
+    if (restart ? rc != SHARD_SUCCESS || restarts != 1 : rc != SHARD_FAILURE) {
+        fprintf(stderr, "error: %d worker(s) returned %d after %d restart(s)\n",
+                workers, rc, restarts);
+        return 1;
+    }
+    return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    FILE* input;
+    int failures = 0;
+    int i;
+
+    if ((input = fopen(TEST_PATH, "w")) == NULL) {
+        perror("error: fopen failed");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < TEST_NAMES; ++i) {
+        fprintf(input, "10.%d.%d.%d\n", i >> 16, (i >> 8) & 0xff, i & 0xff);
+    }
+    fclose(input);
+
+    /* A killed worker is restarted with the names it had not answered */
+    failures += run(2, 1);
+
+    /* A worker that cannot be restarted has its unanswered names written
+     * unresolved, and later names go to the worker left, or are written
+     * unresolved once there is none */
+    failures += run(2, 0);
+    failures += run(1, 0);
+
+    unlink(TEST_PATH);
+
+    if (failures) {
+        fprintf(stderr, "%d shard test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All shard tests passed\n");
+
+    return EXIT_SUCCESS;
+}
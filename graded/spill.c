@@ -0,0 +1,179 @@
+/******************************************************************************
+ * FILE: spill.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of the spill file queue.
+ *  Records in the file are always older than those in the tail block, and
+ *      the head block, whichever it came from, is older than both, so
+ *      taking from the head block, then the file, then the tail block keeps
+ *      the records in the order they were appended.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "spill.h"
+
+
+int spill_open(spill_file* s, const char* dir, size_t recordSize, size_t blockBytes)
+{
+    char path[PATH_MAX];
+    int err;
+
+    memset(s, 0, sizeof(*s));
+    s->fd = -1;
+    if (recordSize == 0 || blockBytes < recordSize) {
+        errno = EINVAL;
+        return SPILL_FAILURE;
+    }
+    s->recordSize = recordSize;
+    s->blockRecords = blockBytes / recordSize;
+
+    if (snprintf(path, sizeof(path), "%s/multi-lookup.XXXXXX", dir) >= (int) sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return SPILL_FAILURE;
+    }
+    if ((s->fd = mkstemp(path)) < 0) {
+        return SPILL_FAILURE;
+    }
+    unlink(path);
+    if ((s->tail = malloc(s->blockRecords * recordSize)) == NULL
+            || (s->head = malloc(s->blockRecords * recordSize)) == NULL) {
+        err = errno;
+        spill_close(s);
+        errno = err;
+        return SPILL_FAILURE;
+    }
+    return SPILL_SUCCESS;
+}
+
+
+/* Write the full tail block to the end of the file
+ * Returns SPILL_SUCCESS or SPILL_FAILURE (errno set)
+ */
+static int spill_flush(spill_file* s)
+{
+    size_t len = s->tailCount * s->recordSize;
+    size_t done;
+    ssize_t n;
+
+    for (done = 0; done < len; done += n) {
+        if ((n = pwrite(s->fd, s->tail + done, len - done, s->written + done)) < 0) {
+            if (errno == EINTR) {
+                n = 0;
+                continue;
+            }
+            return SPILL_FAILURE;
+        }
+    }
+    s->written += len;
+    s->tailCount = 0;
+    if (s->written > s->peakBytes) {
+        s->peakBytes = s->written;
+    }
+    return SPILL_SUCCESS;
+}
+
+
+int spill_append(spill_file* s, const void* record)
+{
+    if (s->tailCount == s->blockRecords && spill_flush(s) == SPILL_FAILURE) {
+        return SPILL_FAILURE;
+    }
+    memcpy(s->tail + s->tailCount * s->recordSize, record, s->recordSize);
+    s->tailCount++;
+    s->count++;
+    s->appended++;
+    return SPILL_SUCCESS;
+}
+
+
+/* Refill the head block from the unread part of the file
+ * Returns SPILL_SUCCESS or SPILL_FAILURE (errno set)
+ */
+static int spill_fill(spill_file* s)
+{
+    size_t len = s->blockRecords * s->recordSize;
+    size_t done;
+    ssize_t n;
+
+    if ((off_t) len > s->written - s->read) {
+        len = s->written - s->read;
+    }
+    for (done = 0; done < len; done += n) {
+        if ((n = pread(s->fd, s->head + done, len - done, s->read + done)) <= 0) {
+            if (n < 0 && errno == EINTR) {
+                n = 0;
+                continue;
+            }
+            errno = n ? errno : EIO;
+            return SPILL_FAILURE;
+        }
+    }
+    s->read += len;
+    s->headCount = len / s->recordSize;
+    s->headNext = 0;
+
+    /* Start the next block on its way, or give the drained file back */
+    if (s->read < s->written) {
+        posix_fadvise(s->fd, s->read, s->blockRecords * s->recordSize, POSIX_FADV_WILLNEED);
+    }
+    else if (ftruncate(s->fd, 0) == 0) {
+        s->read = 0;
+        s->written = 0;
+    }
+    return SPILL_SUCCESS;
+}
+
+
+int spill_take(spill_file* s, void* record)
+{
+    char* block;
+
+    if (s->headNext == s->headCount) {
+        if (s->read < s->written) {
+            if (spill_fill(s) == SPILL_FAILURE) {
+                return SPILL_FAILURE;
+            }
+        }
+        else if (s->tailCount) {
+            /* The file is read out, so the tail block is next */
+            block = s->head;
+            s->head = s->tail;
+            s->tail = block;
+            s->headCount = s->tailCount;
+            s->headNext = 0;
+            s->tailCount = 0;
+        }
+        else {
+            return SPILL_FAILURE;
+        }
+    }
+    memcpy(record, s->head + s->headNext * s->recordSize, s->recordSize);
+    s->headNext++;
+    s->count--;
+    return SPILL_SUCCESS;
+}
+
+
+void spill_close(spill_file* s)
+{
+    if (s->fd >= 0) {
+        close(s->fd);
+    }
+    free(s->tail);
+    free(s->head);
+    s->fd = -1;
+    s->tail = NULL;
+    s->head = NULL;
+    s->count = 0;
+}
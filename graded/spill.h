@@ -0,0 +1,79 @@
+/******************************************************************************
+ * FILE: spill.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for a first-in first-out queue of
+ *      fixed-size records kept in a temporary file, for backlogs too large
+ *      to hold in memory.
+ *  Records are appended to a tail block in memory, which is written to the
+ *      end of the file in one write when it fills. They are taken from a
+ *      head block, read back from the start of the unread part of the file
+ *      in one read, with the kernel told to read the next block ahead; once
+ *      the file is read to its end, the tail block becomes the head block.
+ *      So memory is two blocks however long the queue grows, and the file
+ *      only sees large sequential writes and reads.
+ *  The file is unlinked as soon as it is made, and is truncated each time
+ *      it is read to its end, so it never outlives the queue or holds more
+ *      than the records not yet read back.
+ *  A spill file is not thread safe; callers hold their own lock.
+ *
+ ******************************************************************************/
+
+#ifndef SPILL_H
+#define SPILL_H
+
+/* Standard Includes */
+#include <stddef.h>
+#include <sys/types.h>
+
+
+#define SPILL_FAILURE           -1
+#define SPILL_SUCCESS           0
+
+#define SPILL_BLOCK_BYTES       (512 * 1024)    // Default block size
+
+
+typedef struct spill_file_s {
+    int fd;
+    size_t recordSize;
+    size_t blockRecords;        // Records per block
+    char* tail;                 // Block being appended to
+    size_t tailCount;
+    char* head;                 // Block being taken from
+    size_t headCount;
+    size_t headNext;            // Next record of the head block to take
+    off_t written;              // Bytes of the file written
+    off_t read;                 // Bytes of the file read back
+    long count;                 // Records appended and not yet taken
+    /* Counts for the summary */
+    unsigned long appended;
+    off_t peakBytes;            // Largest the file grew
+} spill_file;
+
+
+/* Function to make an unlinked temporary file in dir for records of
+ * recordSize bytes, moved to and from it blockBytes at a time
+ * Returns SPILL_SUCCESS or SPILL_FAILURE (errno set)
+ */
+int spill_open(spill_file* s, const char* dir, size_t recordSize, size_t blockBytes);
+
+/* Function to copy a record to the end of the queue
+ * Returns SPILL_SUCCESS, or SPILL_FAILURE (errno set) if the tail block
+ * was full and could not be written; it stays full, so nothing is lost
+ * and the next append tries the write again
+ */
+int spill_append(spill_file* s, const void* record);
+
+/* Function to copy out the record at the front of the queue
+ * Returns SPILL_SUCCESS, or SPILL_FAILURE if the queue is empty or
+ * (errno set) the file could not be read
+ */
+int spill_take(spill_file* s, void* record);
+
+/* Function to close and free the file and any records left in it */
+void spill_close(spill_file* s);
+
+#endif
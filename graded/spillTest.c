@@ -0,0 +1,134 @@
+/******************************************************************************
+ * FILE: spillTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the spill file queue in spill.h.
+ *
+ ******************************************************************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "spill.h"
+
+#define TEST_BLOCK      7       // Records per block, so blocks end mid-burst
+#define TEST_RECORDS    100000
+
+typedef struct test_record_s {
+    long seq;
+    char pad[52];               // Check every byte comes back
+} test_record;
+
+static spill_file spill;
+
+
+/* Take up to count records, checking each is the next in order
+ * Returns the number of records out of order or corrupted
+ */
+static int take(long* next, long count)
+{
+    test_record r;
+    int bad = 0;
+
+    for (; count > 0 && spill_take(&spill, &r) == SPILL_SUCCESS; --count) {
+        bad += r.seq != *next || (unsigned char) r.pad[51] != (*next & 0xff);
+        ++*next;
+    }
+    return bad;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    test_record r;
+    long appended = 0;
+    long next = 0;
+    int bad = 0;
+    int failures = 0;
+    int burst;
+    int i;
+
+    /* A block must fit a record, and the directory must exist */
+    if (spill_open(&spill, "/tmp", sizeof(r), sizeof(r) - 1) != SPILL_FAILURE
+            || errno != EINVAL) {
+        fprintf(stderr, "error: a block smaller than a record was accepted\n");
+        failures++;
+    }
+    if (spill_open(&spill, "/nonexistent/spillTest", sizeof(r), 4096) != SPILL_FAILURE) {
+        fprintf(stderr, "error: a spill file was made in a missing directory\n");
+        failures++;
+    }
+
+    if (spill_open(&spill, "/tmp", sizeof(r), TEST_BLOCK * sizeof(r)) == SPILL_FAILURE) {
+        perror("error: spill_open failed");
+        return EXIT_FAILURE;
+    }
+
+    /* An empty queue gives nothing; a few records come back from the tail
+     * block without touching the file */
+    if (spill_take(&spill, &r) != SPILL_FAILURE) {
+        fprintf(stderr, "error: took from an empty queue\n");
+        failures++;
+    }
+    memset(&r, 0, sizeof(r));
+    for (; appended < 3; ++appended) {
+        r.seq = appended;
+        r.pad[51] = appended & 0xff;
+        spill_append(&spill, &r);
+    }
+    bad += take(&next, 3);
+    if (next != 3 || spill.written != 0 || spill.count != 0) {
+        fprintf(stderr, "error: a short queue went to the file\n");
+        failures++;
+    }
+
+    /* Bursts of appends and takes of varying sizes: the backlog grows and
+     * shrinks across many blocks, and everything comes back in order */
+    for (burst = 1; appended < TEST_RECORDS; burst = burst * 7 % 101 + 1) {
+        for (i = 0; i < burst && appended < TEST_RECORDS; ++i, ++appended) {
+            r.seq = appended;
+            r.pad[51] = appended & 0xff;
+            if (spill_append(&spill, &r) == SPILL_FAILURE) {
+                perror("error: spill_append failed");
+                return EXIT_FAILURE;
+            }
+        }
+        bad += take(&next, appended % 3 == 0 ? 2 * TEST_BLOCK : TEST_BLOCK / 2);
+    }
+    bad += take(&next, TEST_RECORDS);
+    if (bad || next != TEST_RECORDS || spill.count != 0) {
+        fprintf(stderr, "error: %ld of %d records came back, %d out of order\n",
+                next, TEST_RECORDS, bad);
+        failures++;
+    }
+    if (spill.appended != TEST_RECORDS || spill.peakBytes == 0) {
+        fprintf(stderr, "error: %lu records appended, file peaked at %ld bytes\n",
+                spill.appended, (long) spill.peakBytes);
+        failures++;
+    }
+
+    /* Reading the file to its end gives its space back */
+    if (spill.written != 0) {
+        fprintf(stderr, "error: drained file still holds %ld bytes\n", (long) spill.written);
+        failures++;
+    }
+    spill_close(&spill);
+
+    if (failures) {
+        fprintf(stderr, "%d spill test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All spill tests passed\n");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,222 @@
+/******************************************************************************
+ * FILE: trace.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of sampled per-hostname trace spans.
+ *  Each thread appends to its own chain of span chunks; a buffer is linked
+ *      onto the global list with one compare-and-swap the first time its
+ *      thread records, and is only walked by trace_dump().
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "trace.h"
+#include "util.h"
+
+
+/* A block of spans in one thread's buffer */
+typedef struct trace_chunk_s {
+    struct trace_chunk_s* next;
+    int used;
+    trace_span spans[TRACE_CHUNK_SPANS];
+} trace_chunk;
+
+/* The spans recorded by one thread */
+typedef struct trace_buffer_s {
+    struct trace_buffer_s* next;
+    trace_chunk* head;
+    trace_chunk* tail;
+    long count;
+    long dropped;               // Spans past TRACE_MAX_SPANS
+} trace_buffer;
+
+
+int traceEnabled = 0;
+
+static unsigned int sampleThreshold;    // Sample when a 32-bit draw is below
+static long long traceStart;
+static trace_buffer* buffers = NULL;    // Every thread's buffer
+
+static __thread trace_buffer* localBuffer = NULL;
+static __thread unsigned long long localSeed = 0;
+static __thread int localTid = 0;
+
+
+void trace_init(double sampleRate)
+{
+    if (sampleRate >= 1.0) {
+        sampleThreshold = 0;    // Always sample
+    }
+    else {
+        sampleThreshold = (unsigned int) (sampleRate * 4294967296.0);
+        if (sampleThreshold == 0) {
+            sampleThreshold = 1;
+        }
+    }
+    traceStart = monotonic_ns();
+    traceEnabled = 1;
+}
+
+
+int trace_tid(void)
+{
+    if (localTid == 0) {
+        localTid = (int) syscall(SYS_gettid);
+    }
+    return localTid;
+}
+
+
+int trace_sample(void)
+{
+    if (!traceEnabled) {
+        return 0;
+    }
+    if (sampleThreshold == 0) {
+        return 1;
+    }
+
+    /* xorshift64, seeded once per thread */
+    if (localSeed == 0) {
+        localSeed = ((unsigned long long) trace_tid() << 32)
+            ^ (unsigned long long) monotonic_ns() ^ 0x9e3779b97f4a7c15ULL;
+    }
+    localSeed ^= localSeed << 13;
+    localSeed ^= localSeed >> 7;
+    localSeed ^= localSeed << 17;
+    return (unsigned int) (localSeed >> 32) < sampleThreshold;
+}
+
+
+/* The calling thread's buffer, linked onto the global list on first use */
+static trace_buffer* trace_local(void)
+{
+    trace_buffer* b = localBuffer;
+
+    if (b == NULL) {
+        if ((b = calloc(1, sizeof(*b))) == NULL) {
+            return NULL;
+        }
+        b->next = __atomic_load_n(&buffers, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&buffers, &b->next, b, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+        localBuffer = b;
+    }
+    return b;
+}
+
+
+void trace_record(const trace_span* span)
+{
+    trace_buffer* b = trace_local();
+    trace_chunk* c;
+
+    if (b == NULL) {
+        return;
+    }
+    if (b->count >= TRACE_MAX_SPANS) {
+        b->dropped++;
+        return;
+    }
+    if ((c = b->tail) == NULL || c->used == TRACE_CHUNK_SPANS) {
+        if ((c = malloc(sizeof(*c))) == NULL) {
+            b->dropped++;
+            return;
+        }
+        c->next = NULL;
+        c->used = 0;
+        if (b->tail) {
+            b->tail->next = c;
+        }
+        else {
+            b->head = c;
+        }
+        b->tail = c;
+    }
+    c->spans[c->used++] = *span;
+    b->count++;
+}
+
+
+/* Write one phase of a hostname's timeline as a nested async slice */
+static void trace_phase(FILE* fp, const char* name, unsigned long id, int tid,
+                        long long begin, long long end, int* first)
+{
+    int pid = (int) getpid();
+
+    fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"host\",\"ph\":\"b\",\"id\":%lu,"
+            "\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+            *first ? "" : ",", name, id, pid, tid, (begin - traceStart) / 1e3);
+    fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"host\",\"ph\":\"e\",\"id\":%lu,"
+            "\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+            name, id, pid, tid, (end - traceStart) / 1e3);
+    *first = 0;
+}
+
+
+int trace_dump(const char* path)
+{
+    FILE* fp;
+    trace_buffer* b;
+    trace_chunk* c;
+    trace_span* s;
+    unsigned long id = 0;
+    long dropped = 0;
+    int first = 1;
+    int i;
+
+    if ((fp = fopen(path, "w")) == NULL) {
+        return TRACE_FAILURE;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (b = __atomic_load_n(&buffers, __ATOMIC_ACQUIRE); b; b = b->next) {
+        for (c = b->head; c; c = c->next) {
+            for (i = 0; i < c->used; ++i) {
+                s = &c->spans[i];
+                ++id;
+                /* The whole hostname, with its phases nested inside */
+                trace_phase(fp, s->hostname, id, s->requesterTid,
+                            s->readAt, s->written, &first);
+                trace_phase(fp, "read", id, s->requesterTid,
+                            s->readAt, s->enqueued, &first);
+                trace_phase(fp, "queued", id, s->resolverTid,
+                            s->enqueued, s->dequeued, &first);
+                trace_phase(fp, "lookup", id, s->resolverTid,
+                            s->lookupStart, s->lookupEnd, &first);
+                trace_phase(fp, "write", id, s->resolverTid,
+                            s->lookupEnd, s->written, &first);
+            }
+        }
+        dropped += b->dropped;
+    }
+    traceEnabled = 0;
+    fprintf(fp, "\n]}\n");
+
+    /* Release every buffer; tracing is over */
+    while ((b = buffers) != NULL) {
+        buffers = b->next;
+        while ((c = b->head) != NULL) {
+            b->head = c->next;
+            free(c);
+        }
+        free(b);
+    }
+
+    if (dropped) {
+        fprintf(stderr, "TRACE WARNING: Dropped %ld spans past %d per thread\n",
+                dropped, TRACE_MAX_SPANS);
+    }
+    if (fclose(fp)) {
+        return TRACE_FAILURE;
+    }
+    return TRACE_SUCCESS;
+}
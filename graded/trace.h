@@ -0,0 +1,68 @@
+/******************************************************************************
+ * FILE: trace.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for per-hostname trace spans.
+ *  A sampled fraction of hostnames carry timestamps through the pipeline
+ *      (read, enqueue, dequeue, lookup, write). Their spans are appended to
+ *      a buffer owned by the writing thread, so recording takes no lock,
+ *      and are dumped at exit as Chrome/Perfetto trace-event JSON.
+ *  With tracing off, or for unsampled names, the cost is one branch.
+ *
+ ******************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/* Local Includes */
+#include "dispatch.h"
+
+
+#define TRACE_FAILURE           -1
+#define TRACE_SUCCESS           0
+
+#define TRACE_CHUNK_SPANS       1024    // Spans per buffer allocation
+#define TRACE_MAX_SPANS         1000000 // Spans kept per thread
+
+
+/* Timeline of one traced hostname, CLOCK_MONOTONIC ns */
+typedef struct trace_span_s {
+    char hostname[MAX_NAME_LENGTH];
+    int requesterTid;
+    int resolverTid;
+    long long readAt;
+    long long enqueued;
+    long long dequeued;
+    long long lookupStart;
+    long long lookupEnd;
+    long long written;
+} trace_span;
+
+/* Nonzero while tracing is on */
+extern int traceEnabled;
+
+
+/* Function to turn tracing on for a fraction (0 to 1] of hostnames */
+void trace_init(double sampleRate);
+
+/* Function to decide whether the next hostname is traced
+ * Returns 1 if it should be, 0 otherwise
+ */
+int trace_sample(void);
+
+/* Function to return the calling thread's kernel thread id */
+int trace_tid(void);
+
+/* Function to record a finished span in the calling thread's buffer */
+void trace_record(const trace_span* span);
+
+/* Function to write every recorded span as trace-event JSON and free the
+ * buffers; call once the threads that recorded spans have finished
+ * Returns TRACE_SUCCESS or TRACE_FAILURE (errno set)
+ */
+int trace_dump(const char* path);
+
+#endif
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * FILE: tune.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of tuned profiles, latency histograms and the
+ *      hill-climbing parameter search.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "tune.h"
+
+#define NUM_PARAMS              3
+
+
+/* Address of the i-th parameter, with its bounds */
+static int* tune_param(tune_params* p, int i, int maxQueue, int* lo, int* hi)
+{
+    switch (i) {
+    case 0:
+        *lo = TUNE_MIN_RESOLVERS;
+        *hi = TUNE_MAX_RESOLVERS;
+        return &p->resolvers;
+    case 1:
+        *lo = TUNE_MIN_QUEUE;
+        *hi = maxQueue;
+        return &p->queueSize;
+    default:
+        *lo = TUNE_MIN_BATCH;
+        *hi = TUNE_MAX_BATCH;
+        return &p->batch;
+    }
+}
+
+
+/* Whether trial a beat trial b */
+static int tune_better(const tune_result* a, const tune_result* b)
+{
+    if (a->rate > b->rate * (1.0 + TUNE_RATE_MARGIN)) {
+        return 1;
+    }
+    return a->rate >= b->rate * (1.0 - TUNE_RATE_MARGIN)
+        && a->p99ms < b->p99ms * (1.0 - TUNE_LATENCY_MARGIN);
+}
+
+
+static int tune_run(const tune_params* p, tune_result* r,
+                    tune_trial_fn trial, void* arg)
+{
+    if (trial(p, r, arg) != TUNE_SUCCESS) {
+        return TUNE_FAILURE;
+    }
+    fprintf(stderr, "TUNE: queue=%d resolvers=%d batch=%d: %.0f names/s, p99 %.2f ms\n",
+            p->queueSize, p->resolvers, p->batch, r->rate, r->p99ms);
+    return TUNE_SUCCESS;
+}
+
+
+int tune_search(tune_params* best, int maxQueue, tune_trial_fn trial, void* arg)
+{
+    tune_params start = *best;
+    tune_params cand;
+    tune_result bestResult;
+    tune_result result;
+    int pass;
+    int i;
+    int dir;
+    int lo;
+    int hi;
+    int* value;
+    int improved = 1;
+
+    /* The first pass over the sample fills the resolver and upstream
+     * caches; time it and every later trial would look faster */
+    if (trial(best, &result, arg) != TUNE_SUCCESS
+            || tune_run(best, &bestResult, trial, arg) != TUNE_SUCCESS) {
+        return TUNE_FAILURE;
+    }
+
+    for (pass = 0; improved && pass < TUNE_MAX_PASSES; ++pass) {
+        improved = 0;
+        for (i = 0; i < NUM_PARAMS; ++i) {
+            /* Try doubling, then halving; keep going while it pays off */
+            for (dir = 0; dir < 2; ++dir) {
+                for (;;) {
+                    cand = *best;
+                    value = tune_param(&cand, i, maxQueue, &lo, &hi);
+                    *value = dir == 0 ? *value * 2 : *value / 2;
+                    *value = *value < lo ? lo : *value > hi ? hi : *value;
+                    if (*value == *tune_param(best, i, maxQueue, &lo, &hi)) {
+                        break;
+                    }
+                    if (tune_run(&cand, &result, trial, arg) != TUNE_SUCCESS
+                            || !tune_better(&result, &bestResult)) {
+                        break;
+                    }
+                    *best = cand;
+                    bestResult = result;
+                    improved = 1;
+                }
+            }
+        }
+    }
+
+    /* Confirm the winner against the starting parameters run again now,
+     * so drift over the search is not taken for a gain */
+    if (memcmp(&start, best, sizeof(start))
+            && tune_run(&start, &result, trial, arg) == TUNE_SUCCESS
+            && !tune_better(&bestResult, &result)) {
+        fprintf(stderr, "TUNE: No clear gain over the starting parameters\n");
+        *best = start;
+        bestResult = result;
+    }
+
+    fprintf(stderr, "TUNE: best queue=%d resolvers=%d batch=%d: %.0f names/s, p99 %.2f ms\n",
+            best->queueSize, best->resolvers, best->batch,
+            bestResult.rate, bestResult.p99ms);
+    return TUNE_SUCCESS;
+}
+
+
+int tune_load_profile(const char* path, tune_params* params)
+{
+    FILE* fp;
+    char key[64];
+    int value;
+
+    if ((fp = fopen(path, "r")) == NULL) {
+        return TUNE_FAILURE;
+    }
+    while (fscanf(fp, " %63[^=]=%d", key, &value) == 2) {
+        if (!strcmp(key, "queue_size")) {
+            params->queueSize = value;
+        }
+        else if (!strcmp(key, "resolvers")) {
+            params->resolvers = value;
+        }
+        else if (!strcmp(key, "batch")) {
+            params->batch = value;
+        }
+        else {
+            fprintf(stderr, "PROFILE WARNING: Unknown key [%s] in %s\n", key, path);
+        }
+    }
+    fclose(fp);
+    return TUNE_SUCCESS;
+}
+
+
+int tune_save_profile(const char* path, const tune_params* params)
+{
+    FILE* fp;
+
+    if ((fp = fopen(path, "w")) == NULL) {
+        return TUNE_FAILURE;
+    }
+    fprintf(fp, "queue_size=%d\nresolvers=%d\nbatch=%d\n",
+            params->queueSize, params->resolvers, params->batch);
+    if (fclose(fp)) {
+        return TUNE_FAILURE;
+    }
+    return TUNE_SUCCESS;
+}
+
+
+void latency_reset(latency_hist* h)
+{
+    memset(h->buckets, 0, sizeof(h->buckets));
+}
+
+
+void latency_record(latency_hist* h, long long ns)
+{
+    int bucket = ns > 1 ? 64 - __builtin_clzll((unsigned long long) ns) : 0;
+
+    if (bucket >= LATENCY_BUCKETS) {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+    __atomic_fetch_add(&h->buckets[bucket], 1, __ATOMIC_RELAXED);
+}
+
+
+double latency_percentile_ms(latency_hist* h, double fraction)
+{
+    unsigned long total = 0;
+    unsigned long seen = 0;
+    int i;
+
+    for (i = 0; i < LATENCY_BUCKETS; ++i) {
+        total += h->buckets[i];
+    }
+    for (i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += h->buckets[i];
+        if (total && seen >= fraction * total) {
+            /* Report the upper edge of the bucket */
+            return (double) (1ULL << i) / 1e6;
+        }
+    }
+    return 0.0;
+}
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * FILE: tune.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for run-time pipeline parameters, the
+ *      tuned profile file they are saved to, a lock-free latency histogram,
+ *      and the hill-climbing search used by the tuning mode.
+ *  A tuning run resolves a sample of the input repeatedly, doubling and
+ *      halving one parameter at a time while names/sec improves (or holds
+ *      with a clearly lower tail latency), and saves the best parameters.
+ *
+ ******************************************************************************/
+
+#ifndef TUNE_H
+#define TUNE_H
+
+#define TUNE_FAILURE            -1
+#define TUNE_SUCCESS            0
+
+#define DEFAULT_PROFILE         "multi-lookup.profile"
+
+/* Parameter bounds searched by the tuner */
+#define TUNE_MIN_QUEUE          1
+#define TUNE_MIN_RESOLVERS      2       // MIN_RESOLVER_THREADS
+#define TUNE_MAX_RESOLVERS      256
+#define TUNE_MIN_BATCH          1
+#define TUNE_MAX_BATCH          64
+
+#define TUNE_MAX_PASSES         3       // Sweeps over all parameters
+#define TUNE_RATE_MARGIN        0.05    // Throughput gain that counts as better
+#define TUNE_LATENCY_MARGIN     0.10    // p99 gain that breaks a throughput tie
+
+#define LATENCY_BUCKETS         40      // Powers of two of nanoseconds
+
+
+/* Parameters fitted by the tuner */
+typedef struct tune_params_s {
+    int queueSize;              // Names admitted to each dispatch level
+    int resolvers;              // Resolver threads
+    int batch;                  // Names a resolver takes per queue visit
+} tune_params;
+
+/* Measurements from one trial */
+typedef struct tune_result_s {
+    double rate;                // Names per second
+    double p99ms;               // 99th percentile enqueue-to-write latency
+} tune_result;
+
+/* Histogram of latencies bucketed by power of two, safe to record into
+ * from many threads at once */
+typedef struct latency_hist_s {
+    unsigned long buckets[LATENCY_BUCKETS];
+} latency_hist;
+
+/* Function that runs one trial with the given parameters
+ * Returns TUNE_SUCCESS and fills result, or TUNE_FAILURE
+ */
+typedef int (*tune_trial_fn)(const tune_params* params, tune_result* result,
+                             void* arg);
+
+
+/* Function to load parameters from a profile file, leaving fields the
+ * file does not mention unchanged
+ * Returns TUNE_SUCCESS, or TUNE_FAILURE if the file cannot be read
+ */
+int tune_load_profile(const char* path, tune_params* params);
+
+/* Function to save parameters to a profile file
+ * Returns TUNE_SUCCESS or TUNE_FAILURE
+ */
+int tune_save_profile(const char* path, const tune_params* params);
+
+/* Function to hill-climb from *best, capping the queue size at maxQueue
+ * An untimed trial warms caches first, and the starting parameters are
+ * run again at the end; a winner that does not beat them is dropped
+ * On return *best holds the best parameters found
+ * Returns TUNE_SUCCESS, or TUNE_FAILURE if the first trial fails
+ */
+int tune_search(tune_params* best, int maxQueue, tune_trial_fn trial, void* arg);
+
+/* Functions to reset, record into and read a latency histogram */
+void latency_reset(latency_hist* h);
+void latency_record(latency_hist* h, long long ns);
+double latency_percentile_ms(latency_hist* h, double fraction);
+
+#endif
@@ -81,3 +81,63 @@ int dnslookup(const char* hostname, char* firstIPstr, int maxSize){
 
     return UTIL_SUCCESS;
 }
+
+int dnsreverse(const char* address, char* hostname, int maxSize){
+
+    /* Local vars */
+    struct sockaddr_storage sock;
+    struct sockaddr_in* ipv4sock = (struct sockaddr_in*) &sock;
+    struct sockaddr_in6* ipv6sock = (struct sockaddr_in6*) &sock;
+    socklen_t sockLen;
+    int nameError = 0;
+
+    /* Convert String to Socket Address */
+    memset(&sock, 0, sizeof(sock));
+    if(inet_pton(AF_INET, address, &(ipv4sock->sin_addr)) == 1){
+    ipv4sock->sin_family = AF_INET;
+    sockLen = sizeof(*ipv4sock);
+    }
+    else if(inet_pton(AF_INET6, address, &(ipv6sock->sin6_addr)) == 1){
+    ipv6sock->sin6_family = AF_INET6;
+    sockLen = sizeof(*ipv6sock);
+    }
+    else{
+    fprintf(stderr, "Error Converting String to IP: %s\n", address);
+    return UTIL_FAILURE;
+    }
+
+    /* Lookup Name, Failing Rather Than Returning the Address */
+    nameError = getnameinfo((struct sockaddr*) &sock, sockLen,
+                hostname, maxSize, NULL, 0, NI_NAMEREQD);
+    if(nameError){
+    fprintf(stderr, "Error looking up Name: %s\n",
+        gai_strerror(nameError));
+    return UTIL_FAILURE;
+    }
+#ifdef UTIL_DEBUG
+    fprintf(stdout, "%s\n", hostname);
+#endif
+
+    return UTIL_SUCCESS;
+}
+
+long long monotonic_ns(void){
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((long long) ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+unsigned long long fnv1a_hash(const char* str){
+
+    unsigned long long hash = 14695981039346656037ULL;
+
+    while(*str){
+        hash ^= (unsigned char) *str++;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
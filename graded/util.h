@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #include <arpa/inet.h>
 #include <sys/types.h>
@@ -37,4 +38,22 @@ int dnslookup(const char* hostname,
           char* firstIPstr,
           int maxSize);
 
+/* Fuction to return the name an IPv4 or IPv6
+ * address points back to (its PTR record),
+ * as string hostname of size maxSize
+ */
+int dnsreverse(const char* address,
+           char* hostname,
+           int maxSize);
+
+/* Function to return the current CLOCK_MONOTONIC
+ * time in nanoseconds
+ */
+long long monotonic_ns(void);
+
+/* Function to return the 64-bit FNV-1a hash of
+ * a NUL terminated string
+ */
+unsigned long long fnv1a_hash(const char* str);
+
 #endif
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * FILE: wheel.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  An implementation of a hierarchical timer wheel.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+
+#include "wheel.h"
+
+#define WHEEL_MASK              (WHEEL_SLOTS - 1)
+
+
+int wheel_init(timer_wheel* w, unsigned int capacity, unsigned int now)
+{
+    int level;
+    int slot;
+
+    if ((w->nodes = malloc((capacity ? capacity : 1) * sizeof(*w->nodes))) == NULL) {
+        return WHEEL_FAILURE;
+    }
+    for (level = 0; level < WHEEL_LEVELS; ++level) {
+        for (slot = 0; slot < WHEEL_SLOTS; ++slot) {
+            w->slots[level][slot] = WHEEL_NONE;
+        }
+    }
+    w->now = now;
+    w->capacity = capacity;
+    return WHEEL_SUCCESS;
+}
+
+
+/* Link a timer due at or after the current tick into its slot */
+static void wheel_place(timer_wheel* w, unsigned int id)
+{
+    unsigned int expires = w->nodes[id].expires;
+    unsigned int delta = expires - w->now;
+    unsigned int* head;
+    int level = 0;
+
+    /* The coarsest level whose slot still tells the timer apart from now */
+    while (level < WHEEL_LEVELS - 1
+            && delta >= 1U << (WHEEL_BITS * (level + 1))) {
+        level++;
+    }
+    head = &w->slots[level][(expires >> (WHEEL_BITS * level)) & WHEEL_MASK];
+    w->nodes[id].next = *head;
+    *head = id;
+}
+
+
+void wheel_insert(timer_wheel* w, unsigned int id, unsigned int expires)
+{
+    /* Ticks compare modulo 2^32 */
+    if ((int) (expires - w->now) <= 0) {
+        expires = w->now + 1;
+    }
+    w->nodes[id].expires = expires;
+    wheel_place(w, id);
+}
+
+
+unsigned int wheel_advance(timer_wheel* w, unsigned int tick)
+{
+    unsigned int head = WHEEL_NONE;
+    unsigned int tail = WHEEL_NONE;
+    unsigned int id;
+    unsigned int next;
+    unsigned int* slot;
+    int level;
+
+    while ((int) (tick - w->now) > 0) {
+        w->now++;
+
+        /* Each time a level wraps, spread the matching slot of the level
+         * above over the levels below */
+        for (level = 1; level < WHEEL_LEVELS
+                && (w->now & ((1U << (WHEEL_BITS * level)) - 1)) == 0; ++level) {
+        }
+        while (--level > 0) {
+            slot = &w->slots[level][(w->now >> (WHEEL_BITS * level)) & WHEEL_MASK];
+            for (id = *slot, *slot = WHEEL_NONE; id != WHEEL_NONE; id = next) {
+                next = w->nodes[id].next;
+                wheel_place(w, id);
+            }
+        }
+
+        /* Everything in the current slot is due */
+        slot = &w->slots[0][w->now & WHEEL_MASK];
+        if (*slot == WHEEL_NONE) {
+            continue;
+        }
+        if (tail == WHEEL_NONE) {
+            head = *slot;
+        }
+        else {
+            w->nodes[tail].next = *slot;
+        }
+        for (tail = *slot; w->nodes[tail].next != WHEEL_NONE; tail = w->nodes[tail].next) {
+        }
+        *slot = WHEEL_NONE;
+    }
+    return head;
+}
+
+
+unsigned int wheel_next(const timer_wheel* w, unsigned int id)
+{
+    return w->nodes[id].next;
+}
+
+
+void wheel_free(timer_wheel* w)
+{
+    free(w->nodes);
+    w->nodes = NULL;
+}
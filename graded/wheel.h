@@ -0,0 +1,68 @@
+/******************************************************************************
+ * FILE: wheel.h
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains declarations for a hierarchical timer wheel.
+ *  Timers are identified by a dense index chosen by the caller and linked
+ *      through an array the wheel owns, 8 bytes per timer.
+ *  WHEEL_LEVELS wheels of WHEEL_SLOTS slots cover ticks up to 2^32 ahead:
+ *      a timer is placed in the coarsest level that still separates it from
+ *      the current tick and cascades down as the wheel turns, so insert and
+ *      expiry are O(1) per timer.
+ *  The wheel is not thread safe; callers hold their own lock.
+ *
+ ******************************************************************************/
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+#define WHEEL_FAILURE           -1
+#define WHEEL_SUCCESS           0
+
+#define WHEEL_BITS              8
+#define WHEEL_SLOTS             (1 << WHEEL_BITS)
+#define WHEEL_LEVELS            4
+#define WHEEL_NONE              0xffffffffU     // End of a timer list
+
+
+/* Link and expiry of one timer */
+typedef struct wheel_node_s {
+    unsigned int next;
+    unsigned int expires;       // Tick the timer is due
+} wheel_node;
+
+typedef struct timer_wheel_s {
+    unsigned int slots[WHEEL_LEVELS][WHEEL_SLOTS];  // List heads
+    unsigned int now;           // Last tick expired
+    unsigned int capacity;
+    wheel_node* nodes;
+} timer_wheel;
+
+
+/* Function to create a wheel for timers 0 to capacity - 1, starting at
+ * tick now
+ * Returns WHEEL_SUCCESS or WHEEL_FAILURE
+ */
+int wheel_init(timer_wheel* w, unsigned int capacity, unsigned int now);
+
+/* Function to schedule a timer that is not already scheduled; a tick that
+ * has already passed fires on the next advance */
+void wheel_insert(timer_wheel* w, unsigned int id, unsigned int expires);
+
+/* Function to turn the wheel up to tick
+ * Returns the first expired timer, followed by the rest through
+ * wheel_next(), or WHEEL_NONE
+ */
+unsigned int wheel_advance(timer_wheel* w, unsigned int tick);
+
+/* Function to return the expired timer after id, or WHEEL_NONE; read it
+ * before id is inserted again */
+unsigned int wheel_next(const timer_wheel* w, unsigned int id);
+
+/* Function to free the wheel */
+void wheel_free(timer_wheel* w);
+
+#endif
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * FILE: wheelTest.c
+ * AUTHOR: Stephen Bennett
+ * PROJECT: CSCI 3753 Programming Assignment 2
+ * CREATE DATE: 10/19/2026
+ * MODIFY DATE: 10/19/2026
+ * DESCRIPTION:
+ *  This file contains test code for the hierarchical timer wheel in wheel.h.
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "wheel.h"
+
+#define TEST_TIMERS     100000
+#define TEST_SPAN       300000      // Ticks ahead, reaching the third level
+#define TEST_START      0xfffff000U // Tick counter wraps during the test
+
+
+int main(int argc, char* argv[])
+{
+    /* Void Unused Variables */
+    (void) argc;
+    (void) argv;
+
+    /* Setup local vars */
+    timer_wheel w;
+    unsigned int expires[TEST_TIMERS];
+    char fired[TEST_TIMERS] = {0};
+    unsigned int tick = TEST_START;
+    unsigned int end = TEST_START + TEST_SPAN + 1;
+    unsigned int prev;
+    unsigned int id;
+    int failures = 0;
+    int count = 0;
+    int i;
+
+    if (wheel_init(&w, TEST_TIMERS, TEST_START) == WHEEL_FAILURE) {
+        fprintf(stderr, "error: wheel_init failed\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Timers spread over every level, a few due at once */
+    srand(3753);
+    for (i = 0; i < TEST_TIMERS; ++i) {
+        expires[i] = TEST_START + (i % 100 == 0 ? 0 : (unsigned int) rand() % TEST_SPAN);
+        wheel_insert(&w, i, expires[i]);
+        if (expires[i] == TEST_START) {
+            expires[i]++;       // Past ticks fire on the next advance
+        }
+    }
+
+    /* Turn the wheel in uneven steps; each timer fires exactly once, in
+     * the step that covers its tick */
+    while (tick != end) {
+        prev = tick;
+        tick += 1 + (unsigned int) rand() % 97;
+        if ((int) (tick - end) > 0) {
+            tick = end;
+        }
+        for (id = wheel_advance(&w, tick); id != WHEEL_NONE; id = wheel_next(&w, id)) {
+            if (fired[id]) {
+                fprintf(stderr, "error: timer %u fired twice\n", id);
+                failures++;
+            }
+            else if ((int) (expires[id] - prev) <= 0 || (int) (expires[id] - tick) > 0) {
+                fprintf(stderr, "error: timer %u due at %u fired in (%u, %u]\n",
+                        id, expires[id], prev, tick);
+                failures++;
+            }
+            fired[id] = 1;
+            count++;
+        }
+    }
+    if (count != TEST_TIMERS) {
+        fprintf(stderr, "error: %d of %d timers fired\n", count, TEST_TIMERS);
+        failures++;
+    }
+
+    /* A timer may be scheduled again once it has fired */
+    wheel_insert(&w, 0, tick + 70000);
+    if (wheel_advance(&w, tick + 69999) != WHEEL_NONE
+            || wheel_advance(&w, tick + 70000) != 0) {
+        fprintf(stderr, "error: rescheduled timer fired at the wrong tick\n");
+        failures++;
+    }
+    wheel_free(&w);
+
+    if (failures) {
+        fprintf(stderr, "%d wheel test(s) failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("All wheel tests passed\n");
+
+    return EXIT_SUCCESS;
+}